@@ -6,6 +6,10 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <crypto/sha256.h>
+#include <key.h>
+#include <miner.h>
+#include <script/sign.h>
+#include <script/signingprovider.h>
 #include <test/util/mining.h>
 #include <test/util/script.h>
 #include <test/util/setup_common.h>
@@ -51,3 +55,86 @@ static void AssembleBlock(benchmark::Bench& bench)
 }
 
 BENCHMARK(AssembleBlock);
+
+static void RunAssembleContractBlock(benchmark::Bench& bench, bool reuse_executions)
+{
+    // Room for 160 of the contract transactions
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::UNITTEST, {"-staker-soft-block-gas-limit=40000000"});
+    CChainState& chainstate = test_setup->m_node.chainman->ActiveChainstate();
+
+    CKey key;
+    key.MakeNewKey(true);
+    FillableSigningProvider keystore;
+    keystore.AddKey(key);
+    const CScript script_pubkey = GetScriptForDestination(PKHash(key.GetPubKey()));
+
+    // Mine enough blocks to get mature coinbases to fund the contract transactions
+    constexpr size_t NUM_BLOCKS{2100};
+    constexpr size_t coinbaseMaturity = 2000;
+    std::vector<CTxIn> coinbases;
+    for (size_t b{0}; b < NUM_BLOCKS; ++b) {
+        CTxIn in = MineBlock(test_setup->m_node, script_pubkey);
+        if (NUM_BLOCKS - b >= coinbaseMaturity)
+            coinbases.push_back(in);
+    }
+
+    // Split the coinbases into one output per contract transaction
+    constexpr size_t OUTPUTS_PER_COINBASE{20};
+    std::vector<std::pair<COutPoint, CAmount>> funds;
+    {
+        LOCK(::cs_main);
+        for (const CTxIn& in : coinbases) {
+            const CAmount value = chainstate.CoinsTip().AccessCoin(in.prevout).out.nValue;
+            CMutableTransaction tx;
+            tx.vin.push_back(in);
+            for (size_t i{0}; i < OUTPUTS_PER_COINBASE; ++i) {
+                tx.vout.emplace_back((value - COIN / 100) / OUTPUTS_PER_COINBASE, script_pubkey);
+            }
+            assert(SignSignature(keystore, script_pubkey, tx, 0, value, SIGHASH_ALL));
+            const CTransactionRef txr = MakeTransactionRef(tx);
+            const MempoolAcceptResult res = ::AcceptToMemoryPool(chainstate, *test_setup->m_node.mempool, txr, false /* bypass_limits */);
+            assert(res.m_result_type == MempoolAcceptResult::ResultType::VALID);
+            for (size_t i{0}; i < OUTPUTS_PER_COINBASE; ++i) {
+                funds.emplace_back(COutPoint(txr->GetHash(), i), txr->vout[i].nValue);
+            }
+        }
+    }
+    MineBlock(test_setup->m_node, script_pubkey);
+
+    // Thousands of contract creations spending all their gas in a loop, only some fit in the block
+    constexpr uint64_t GAS_LIMIT{DEFAULT_GAS_LIMIT_OP_SEND};
+    const std::vector<unsigned char> loop_code = ParseHex("5b600056"); // JUMPDEST PUSH1 0 JUMP
+    {
+        LOCK(::cs_main);
+        for (const auto& [prevout, value] : funds) {
+            const CAmount fee = GAS_LIMIT * DEFAULT_GAS_PRICE + COIN / 1000;
+            CMutableTransaction tx;
+            tx.vin.emplace_back(prevout);
+            tx.vout.emplace_back(0, CScript() << CScriptNum(VersionVM::GetEVMDefault().toRaw()) << CScriptNum(GAS_LIMIT) << CScriptNum(DEFAULT_GAS_PRICE) << loop_code << OP_CREATE);
+            tx.vout.emplace_back(value - fee, script_pubkey);
+            assert(SignSignature(keystore, script_pubkey, tx, 0, value, SIGHASH_ALL));
+            const MempoolAcceptResult res = ::AcceptToMemoryPool(chainstate, *test_setup->m_node.mempool, MakeTransactionRef(tx), false /* bypass_limits */);
+            assert(res.m_result_type == MempoolAcceptResult::ResultType::VALID);
+        }
+    }
+
+    bench.run([&] {
+        if (!reuse_executions) {
+            g_contract_exec_cache.Clear();
+        }
+        PrepareBlock(test_setup->m_node, script_pubkey);
+    });
+}
+
+static void AssembleContractBlock(benchmark::Bench& bench)
+{
+    RunAssembleContractBlock(bench, false);
+}
+
+static void AssembleContractBlockCached(benchmark::Bench& bench)
+{
+    RunAssembleContractBlock(bench, true);
+}
+
+BENCHMARK(AssembleContractBlock);
+BENCHMARK(AssembleContractBlockCached);
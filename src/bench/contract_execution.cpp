@@ -0,0 +1,154 @@
+#include <bench/bench.h>
+#include <revo/revoDGP.h>
+#include <test/revotests/test_utils.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <vector>
+
+namespace {
+
+const dev::u256 GAS_LIMIT = 1000000;
+const dev::u256 GAS_PRICE = 1;
+
+/*
+    pragma solidity ^0.4.24;
+    contract Token {
+        mapping(address => uint256) balances;
+        function mint(address to, uint256 amount) public { balances[to] += amount * 2; }
+        function balanceOf(address owner) public view returns (uint256) { return balances[owner]; }
+        function transfer(address to, uint256 amount) public {
+            require(balances[msg.sender] >= amount);
+            balances[msg.sender] -= amount;
+            balances[to] += amount;
+        }
+    }
+*/
+const valtype TOKEN_CODE = ParseHex("608060405234801561001057600080fd5b506101e3806100206000396000f3006080604052600436106100565763ffffffff7c010000000000000000000000000000000000000000000000000000000060003504166340c10f19811461005b57806370a082311461008e578063a9059cbb146100ce575b600080fd5b34801561006757600080fd5b5061008c73ffffffffffffffffffffffffffffffffffffffff600435166024356100ff565b005b34801561009a57600080fd5b506100bc73ffffffffffffffffffffffffffffffffffffffff60043516610134565b60408051918252519081900360200190f35b3480156100da57600080fd5b5061008c73ffffffffffffffffffffffffffffffffffffffff6004351660243561015c565b73ffffffffffffffffffffffffffffffffffffffff909116600090815260208190526040902080546002909202919091019055565b73ffffffffffffffffffffffffffffffffffffffff1660009081526020819052604090205490565b3360009081526020819052604090205481111561017857600080fd5b336000908152602081905260408082208054849003905573ffffffffffffffffffffffffffffffffffffffff93909316815291909120805490910190555600a165627a7a72305820c517c25d8609e1668bebed32141ed2c2415e8b77ba9f2aef29c6d84e5756b4c20029");
+
+/*
+    Stores i in slot i for i from 64 down to 1:
+        PUSH1 64 JUMPDEST DUP1 DUP1 SSTORE PUSH1 1 SWAP1 SUB DUP1 PUSH1 2 JUMPI STOP
+*/
+const valtype STORAGE_LOOP_CODE = ParseHex("600f80600b6000396000f3" "60405b808055600190038060025700");
+
+/* Accepts any value: STOP */
+const valtype PAYABLE_CODE = ParseHex("600180600b6000396000f3" "00");
+
+valtype AbiCall(const std::string& selector, const dev::Address& to, const dev::u256& amount)
+{
+    valtype data = ParseHex(selector);
+    dev::h256 address;
+    memcpy(address.data() + 12, to.data(), to.size);
+    data.insert(data.end(), address.begin(), address.end());
+    dev::h256 value(amount);
+    data.insert(data.end(), value.begin(), value.end());
+    return data;
+}
+
+/** Fixture running transactions the way ConnectBlock does on top of the tip of a fresh chain */
+class ContractBench
+{
+public:
+    ContractBench() : m_setup(MakeNoLogFileContext<const TestingSetup>()) {}
+
+    ChainstateManager& chainman() const { return *m_setup->m_node.chainman; }
+
+    /** Execute a transaction with a new hash and commit its state changes */
+    std::pair<std::vector<ResultExecute>, ByteCodeExecResult> Execute(const valtype& data, const dev::Address& recipient = dev::Address(), const dev::u256& value = 0)
+    {
+        RevoTransaction tx = createRevoTransaction(data, value, GAS_LIMIT, GAS_PRICE, dev::h256(++m_nonce), recipient);
+        return executeBC({tx}, chainman());
+    }
+
+    /** Deploy a contract, returning its address */
+    dev::Address Deploy(const valtype& code)
+    {
+        const dev::h256 hash(++m_nonce);
+        RevoTransaction tx = createRevoTransaction(code, 0, GAS_LIMIT, GAS_PRICE, hash, dev::Address());
+        executeBC({tx}, chainman());
+        return createRevoAddress(hash, 0);
+    }
+
+    /** Run f in the benchmark, resetting the state after every run so each one does the same work */
+    template <typename F>
+    void Run(benchmark::Bench& bench, F f)
+    {
+        const dev::h256 root = globalState->rootHash();
+        const dev::h256 rootUTXO = globalState->rootHashUTXO();
+        bench.run([&] {
+            f();
+            globalState->setRoot(root);
+            globalState->setRootUTXO(rootUTXO);
+        });
+    }
+
+private:
+    const std::unique_ptr<const TestingSetup> m_setup;
+    uint64_t m_nonce{0};
+};
+
+} // namespace
+
+static void RevoContractCreate(benchmark::Bench& bench)
+{
+    ContractBench test;
+    test.Run(bench, [&] {
+        test.Execute(TOKEN_CODE);
+    });
+}
+
+static void RevoQRC20Transfer(benchmark::Bench& bench)
+{
+    ContractBench test;
+    const dev::Address token = test.Deploy(TOKEN_CODE);
+    const dev::Address sender("0101010101010101010101010101010101010101");
+    test.Execute(AbiCall("40c10f19", sender, dev::u256(1) << 128), token);
+
+    uint64_t n{0};
+    test.Run(bench, [&] {
+        // A different holder every time, like a token distribution
+        test.Execute(AbiCall("a9059cbb", dev::Address(dev::u160(++n)), 1), token);
+    });
+}
+
+static void RevoStorageLoop(benchmark::Bench& bench)
+{
+    ContractBench test;
+    const dev::Address contract = test.Deploy(STORAGE_LOOP_CODE);
+    test.Run(bench, [&] {
+        test.Execute(valtype(), contract);
+    });
+}
+
+static void RevoValueTransfer(benchmark::Bench& bench)
+{
+    ContractBench test;
+    const dev::Address contract = test.Deploy(PAYABLE_CODE);
+    test.Execute(valtype(), contract, 1000);
+
+    // Sending value to a contract which already has some merges its outputs in a condensing transaction
+    test.Run(bench, [&] {
+        test.Execute(valtype(), contract, 1000);
+    });
+}
+
+static void RevoDGPRead(benchmark::Bench& bench)
+{
+    ContractBench test;
+    CChainState& chainstate = test.chainman().ActiveChainstate();
+    const unsigned int height = WITH_LOCK(::cs_main, return chainstate.m_chain.Height()) + 1;
+    bench.run([&] {
+        RevoDGP revoDGP(globalState.get(), chainstate, fGettingValuesDGP);
+        revoDGP.getGasSchedule(height);
+        revoDGP.getBlockSize(height);
+        revoDGP.getMinGasPrice(height);
+        revoDGP.getBlockGasLimit(height);
+    });
+}
+
+BENCHMARK(RevoContractCreate);
+BENCHMARK(RevoQRC20Transfer);
+BENCHMARK(RevoStorageLoop);
+BENCHMARK(RevoValueTransfer);
+BENCHMARK(RevoDGPRead);
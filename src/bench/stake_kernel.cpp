@@ -0,0 +1,76 @@
+#include <bench/bench.h>
+
+#include <chain.h>
+#include <pos.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+
+#include <cassert>
+
+static const size_t NUM_STAKE_PREVOUTS = 10000;
+// Easy target so that a part of the kernels are solved and the solve path is measured too
+static const unsigned int STAKE_KERNEL_BITS = 0x1e0fffff;
+
+struct StakeKernelSetup
+{
+    CBlockIndex index;
+    std::vector<COutPoint> prevouts;
+    std::map<COutPoint, CStakeCache> cache;
+
+    StakeKernelSetup()
+    {
+        FastRandomContext rng(true);
+        index.nHeight = 100000;
+        index.nStakeModifier = rng.rand256();
+        for (size_t i = 0; i < NUM_STAKE_PREVOUTS; i++) {
+            COutPoint prevout(rng.rand256(), rng.randrange(10));
+            prevouts.push_back(prevout);
+            cache.insert({prevout, CStakeCache(1600000000 + rng.randrange(1000000), 1 + rng.randrange(1000 * COIN))});
+        }
+    }
+};
+
+static void StakeKernelScalar(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const BasicTestingSetup>(CBaseChainParams::MAIN);
+    StakeKernelSetup setup;
+    uint32_t nTimeBlock = 1700000000;
+    bench.batch(NUM_STAKE_PREVOUTS).unit("kernel").run([&] {
+        for (const COutPoint& prevout : setup.prevouts) {
+            uint256 hashProofOfStake;
+            CheckKernelCache(&setup.index, STAKE_KERNEL_BITS, nTimeBlock, prevout, setup.cache, hashProofOfStake);
+        }
+        nTimeBlock += 16;
+    });
+}
+
+static void StakeKernelBatch(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const BasicTestingSetup>(CBaseChainParams::MAIN);
+    StakeKernelSetup setup;
+    std::vector<CStakeKernel> kernels;
+    PrepareStakeKernels(&setup.index, setup.prevouts, setup.cache, kernels);
+
+    // The batched kernels must solve exactly the same prevouts as the scalar path
+    std::vector<std::pair<size_t, uint256>> solved;
+    CheckKernelBatch(&setup.index, STAKE_KERNEL_BITS, 1700000000, kernels, 0, kernels.size(), solved);
+    size_t nSolved = 0;
+    for (size_t i = 0; i < setup.prevouts.size(); i++) {
+        uint256 hashProofOfStake;
+        if (CheckKernelCache(&setup.index, STAKE_KERNEL_BITS, 1700000000, setup.prevouts[i], setup.cache, hashProofOfStake)) {
+            assert(nSolved < solved.size() && solved[nSolved].first == i && solved[nSolved].second == hashProofOfStake);
+            nSolved++;
+        }
+    }
+    assert(nSolved == solved.size());
+
+    uint32_t nTimeBlock = 1700000000;
+    bench.batch(NUM_STAKE_PREVOUTS).unit("kernel").run([&] {
+        solved.clear();
+        CheckKernelBatch(&setup.index, STAKE_KERNEL_BITS, nTimeBlock, kernels, 0, kernels.size(), solved);
+        nTimeBlock += 16;
+    });
+}
+
+BENCHMARK(StakeKernelScalar);
+BENCHMARK(StakeKernelBatch);
@@ -133,6 +133,7 @@ public:
     bool Valid() const;
 
     void SeekToFirst();
+    void SeekToLast();
 
     template<typename K> void Seek(const K& key) {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
@@ -143,6 +144,7 @@ public:
     }
 
     void Next();
+    void Prev();
 
     template<typename K> bool GetKey(K& key) {
         leveldb::Slice slKey = piter->key();
@@ -227,16 +229,39 @@ public:
     CDBWrapper(const CDBWrapper&) = delete;
     CDBWrapper& operator=(const CDBWrapper&) = delete;
 
+    /**
+     * A consistent view of the database as of its creation, unaffected by later writes.
+     * Lets a long read run without holding the lock that serializes the writers.
+     */
+    class Snapshot
+    {
+        friend class CDBWrapper;
+    private:
+        const CDBWrapper& parent;
+        const leveldb::Snapshot* psnapshot;
+
+    public:
+        explicit Snapshot(const CDBWrapper& _parent) : parent(_parent), psnapshot(_parent.pdb->GetSnapshot()) {}
+        ~Snapshot() { parent.pdb->ReleaseSnapshot(psnapshot); }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+    };
+
     template <typename K, typename V>
-    bool Read(const K& key, V& value) const
+    bool Read(const K& key, V& value, const Snapshot* snapshot = nullptr) const
     {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
         ssKey << key;
         leveldb::Slice slKey((const char*)ssKey.data(), ssKey.size());
 
+        leveldb::ReadOptions options = readoptions;
+        if (snapshot) {
+            options.snapshot = snapshot->psnapshot;
+        }
         std::string strValue;
-        leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+        leveldb::Status status = pdb->Get(options, slKey, &strValue);
         if (!status.ok()) {
             if (status.IsNotFound())
                 return false;
@@ -298,6 +323,13 @@ public:
         return new CDBIterator(*this, pdb->NewIterator(iteroptions));
     }
 
+    CDBIterator *NewIterator(const Snapshot& snapshot)
+    {
+        leveldb::ReadOptions options = iteroptions;
+        options.snapshot = snapshot.psnapshot;
+        return new CDBIterator(*this, pdb->NewIterator(options));
+    }
+
     /**
      * Return true if the database managed by this class contains no entries.
      */
@@ -16,6 +16,7 @@ namespace po = boost::program_options;
 
 auto g_kind = DatabaseKind::LevelDB;
 fs::path g_dbPath;
+size_t g_cacheSize = 0;
 
 /// A helper type to build the table of DB implementations.
 ///
@@ -55,6 +56,16 @@ void setDatabaseKind(DatabaseKind _kind)
     g_kind = _kind;
 }
 
+void setDatabaseCacheSize(size_t _size)
+{
+    g_cacheSize = _size;
+}
+
+size_t databaseCacheSize()
+{
+    return g_cacheSize;
+}
+
 void setDatabasePath(std::string const& _path)
 {
     g_dbPath = fs::path(_path);
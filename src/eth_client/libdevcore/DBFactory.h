@@ -30,6 +30,9 @@ bool isDiskDatabase();
 DatabaseKind databaseKind();
 void setDatabaseKindByName(std::string const& _name);
 void setDatabaseKind(DatabaseKind _kind);
+/// Set the size in bytes of the block cache of each database opened afterwards, 0 for none.
+void setDatabaseCacheSize(size_t _size);
+size_t databaseCacheSize();
 boost::filesystem::path databasePath();
 
 class DBFactory
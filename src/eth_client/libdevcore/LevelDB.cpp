@@ -3,6 +3,7 @@
 // Licensed under the GNU General Public License, Version 3.
 #include "LevelDB.h"
 #include "Assertions.h"
+#include "DBFactory.h"
 
 namespace dev
 {
@@ -90,6 +91,17 @@ LevelDB::LevelDB(boost::filesystem::path const& _path, leveldb::ReadOptions _rea
     leveldb::WriteOptions _writeOptions, leveldb::Options _dbOptions)
   : m_db(nullptr), m_readOptions(std::move(_readOptions)), m_writeOptions(std::move(_writeOptions))
 {
+    if (!_dbOptions.filter_policy)
+    {
+        m_filterPolicy.reset(leveldb::NewBloomFilterPolicy(10));
+        _dbOptions.filter_policy = m_filterPolicy.get();
+    }
+    if (!_dbOptions.block_cache && databaseCacheSize())
+    {
+        m_blockCache.reset(leveldb::NewLRUCache(databaseCacheSize()));
+        _dbOptions.block_cache = m_blockCache.get();
+    }
+
     auto db = static_cast<leveldb::DB*>(nullptr);
     auto const status = leveldb::DB::Open(_dbOptions, _path.string(), &db);
     checkStatus(status, _path);
@@ -176,5 +188,10 @@ void LevelDB::forEach(std::function<bool(Slice, Slice)> _f) const
     }
 }
 
+void LevelDB::compact()
+{
+    m_db->CompactRange(nullptr, nullptr);
+}
+
 }  // namespace db
 }  // namespace dev
@@ -7,7 +7,9 @@
 #include "db.h"
 
 #include <boost/filesystem.hpp>
+#include <leveldb/cache.h>
 #include <leveldb/db.h>
+#include <leveldb/filter_policy.h>
 #include <leveldb/write_batch.h>
 
 namespace dev
@@ -36,7 +38,12 @@ public:
 
     void forEach(std::function<bool(Slice, Slice)> _f) const override;
 
+    void compact() override;
+
 private:
+    // Used by m_db, so declared before it
+    std::unique_ptr<leveldb::Cache> m_blockCache;
+    std::unique_ptr<leveldb::FilterPolicy const> m_filterPolicy;
     std::unique_ptr<leveldb::DB> m_db;
     leveldb::ReadOptions const m_readOptions;
     leveldb::WriteOptions const m_writeOptions;
@@ -0,0 +1,81 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "NodeCache.h"
+
+using namespace std;
+using namespace dev;
+
+bool NodeCache::lookup(h256 const& _h, string& o_value) const
+{
+    Shard const& s = shard(_h);
+    Guard l(s.x_shard);
+    auto const it = s.index.find(_h);
+    if (it == s.index.end())
+    {
+        ++m_misses;
+        return false;
+    }
+    s.lru.splice(s.lru.begin(), s.lru, it->second);
+    o_value = it->second->second;
+    ++m_hits;
+    return true;
+}
+
+bool NodeCache::contains(h256 const& _h) const
+{
+    Shard const& s = shard(_h);
+    Guard l(s.x_shard);
+    return s.index.count(_h);
+}
+
+void NodeCache::insert(h256 const& _h, string const& _value)
+{
+    size_t const usage = entryUsage(_value);
+    if (usage > m_maxShardUsage)
+        return;
+
+    Shard& s = shard(_h);
+    Guard l(s.x_shard);
+    auto const it = s.index.find(_h);
+    if (it != s.index.end())
+    {
+        s.lru.splice(s.lru.begin(), s.lru, it->second);
+        return;
+    }
+
+    while (s.usage + usage > m_maxShardUsage)
+    {
+        auto const& last = s.lru.back();
+        s.usage -= entryUsage(last.second);
+        s.index.erase(last.first);
+        s.lru.pop_back();
+    }
+    s.lru.emplace_front(_h, _value);
+    s.index.emplace(_h, s.lru.begin());
+    s.usage += usage;
+}
+
+void NodeCache::erase(h256 const& _h)
+{
+    Shard& s = shard(_h);
+    Guard l(s.x_shard);
+    auto const it = s.index.find(_h);
+    if (it == s.index.end())
+        return;
+    s.usage -= entryUsage(it->second->second);
+    s.lru.erase(it->second);
+    s.index.erase(it);
+}
+
+size_t NodeCache::usage() const
+{
+    size_t ret = 0;
+    for (auto const& s: m_shards)
+    {
+        Guard l(s.x_shard);
+        ret += s.usage;
+    }
+    return ret;
+}
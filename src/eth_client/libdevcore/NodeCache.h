@@ -0,0 +1,62 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+namespace dev
+{
+
+/**
+ * @brief Thread-safe LRU cache of trie nodes read from or written to a state database.
+ *
+ * Nodes are addressed by the hash of their content, so a cached node never becomes stale.
+ * The cache is split into shards with their own lock and least recently used list, selected
+ * by the node hash, and is sized in bytes.
+ */
+class NodeCache
+{
+public:
+    explicit NodeCache(size_t _maxUsage): m_maxShardUsage(_maxUsage / c_shards) {}
+
+    /// @returns true and sets @a o_value if the node is cached.
+    bool lookup(h256 const& _h, std::string& o_value) const;
+    bool contains(h256 const& _h) const;
+    void insert(h256 const& _h, std::string const& _value);
+    void erase(h256 const& _h);
+
+    size_t usage() const;
+    size_t maxUsage() const { return m_maxShardUsage * c_shards; }
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+
+    static constexpr size_t c_shards = 16;
+
+private:
+    struct Shard
+    {
+        mutable Mutex x_shard;
+        mutable std::list<std::pair<h256, std::string>> lru;
+        std::unordered_map<h256, std::list<std::pair<h256, std::string>>::iterator> index;
+        size_t usage = 0;
+    };
+
+    Shard& shard(h256 const& _h) { return m_shards[_h[0] % c_shards]; }
+    Shard const& shard(h256 const& _h) const { return m_shards[_h[0] % c_shards]; }
+    static size_t entryUsage(std::string const& _value) { return _value.size() + sizeof(h256) * 2 + 64; }
+
+    size_t const m_maxShardUsage;
+    std::array<Shard, c_shards> m_shards;
+    mutable std::atomic<uint64_t> m_hits{0};
+    mutable std::atomic<uint64_t> m_misses{0};
+};
+
+}
@@ -29,6 +29,35 @@ inline db::Slice toSlice(bytes const& _b)
 
 }  // namespace
 
+void OverlayJournal::touch(h256 const& _h)
+{
+    Guard l(x_journal);
+    m_touched.insert(_h);
+    if (m_tracking)
+        m_tracked.insert(_h);
+}
+
+h256Hash OverlayJournal::takeTouched()
+{
+    Guard l(x_journal);
+    h256Hash ret;
+    ret.swap(m_touched);
+    return ret;
+}
+
+void OverlayJournal::startTracking()
+{
+    Guard l(x_journal);
+    m_tracking = true;
+}
+
+void OverlayJournal::stopTracking()
+{
+    Guard l(x_journal);
+    m_tracking = false;
+    m_tracked.clear();
+}
+
 OverlayDB::~OverlayDB() = default;
 
 void OverlayDB::commit()
@@ -44,9 +73,24 @@ void OverlayDB::commit()
             for (auto const& i: m_main)
             {
                 if (i.second.second)
+                {
                     writeBatch->insert(toSlice(i.first), toSlice(i.second.first));
+                    if (m_journal)
+                        m_journal->touch(i.first);
+                    if (m_nodeCache)
+                        m_nodeCache->insert(i.first, i.second.first);
+                }
 //              cnote << i.first << "#" << m_main[i.first].second;
             }
+            for (auto const& set: m_pending)
+                for (auto const& i: set->nodes)
+                {
+                    writeBatch->insert(toSlice(i.first), toSlice(i.second));
+                    if (m_journal)
+                        m_journal->touch(i.first);
+                    if (m_nodeCache)
+                        m_nodeCache->insert(i.first, i.second);
+                }
             for (auto const& i: m_aux)
                 if (i.second.second)
                 {
@@ -81,10 +125,81 @@ void OverlayDB::commit()
         {
             m_aux.clear();
             m_main.clear();
+            m_pending.clear();
         }
     }
 }
 
+void OverlayDB::checkpoint()
+{
+#if DEV_GUARDED_DB
+    WriteGuard l(x_this);
+#endif
+    // The last set can take the nodes while no copy or caller holds it
+    if (m_pending.empty() || m_pending.back().use_count() > 1)
+        m_pending.push_back(std::make_shared<OverlayPendingSet>());
+    OverlayPendingSet& set = *m_pending.back();
+    for (auto& i: m_main)
+        if (i.second.second)
+        {
+            auto const inserted = set.nodes.emplace(i.first, std::move(i.second.first));
+            if (inserted.second)
+                set.bytes += inserted.first->second.size() + sizeof(h256) + sizeof(std::string);
+        }
+    m_main.clear();
+}
+
+void OverlayDB::rollback(PendingNodes const& _pending)
+{
+#if DEV_GUARDED_DB
+    WriteGuard l(x_this);
+#endif
+    m_main.clear();
+    m_pending = _pending;
+}
+
+OverlayDB::PendingNodes OverlayDB::pendingSince(PendingNodes const& _pending) const
+{
+    size_t i = 0;
+    while (i < _pending.size() && i < m_pending.size() && _pending[i] == m_pending[i])
+        ++i;
+    return PendingNodes(m_pending.begin() + i, m_pending.end());
+}
+
+void OverlayDB::addPending(PendingNodes const& _nodes)
+{
+    m_pending.insert(m_pending.end(), _nodes.begin(), _nodes.end());
+}
+
+OverlayDB::PendingNodes OverlayDB::mergePending(PendingNodes const& _nodes)
+{
+    auto merged = std::make_shared<OverlayPendingSet>();
+    for (auto const& set: _nodes)
+        for (auto const& i: set->nodes)
+            if (merged->nodes.emplace(i.first, i.second).second)
+                merged->bytes += i.second.size() + sizeof(h256) + sizeof(std::string);
+    return PendingNodes{merged};
+}
+
+size_t OverlayDB::pendingMemoryUsage() const
+{
+    size_t ret = 0;
+    for (auto const& set: m_pending)
+        ret += set->bytes;
+    return ret;
+}
+
+std::string const* OverlayDB::findPending(h256 const& _h) const
+{
+    for (auto set = m_pending.rbegin(); set != m_pending.rend(); ++set)
+    {
+        auto const it = (*set)->nodes.find(_h);
+        if (it != (*set)->nodes.end())
+            return &it->second;
+    }
+    return nullptr;
+}
+
 bytes OverlayDB::lookupAux(h256 const& _h) const
 {
     bytes ret = StateCacheDB::lookupAux(_h);
@@ -111,22 +226,67 @@ void OverlayDB::rollback()
 std::string OverlayDB::lookup(h256 const& _h) const
 {
     std::string ret = StateCacheDB::lookup(_h);
-    if (!ret.empty() || !m_db)
+    if (!ret.empty())
         return ret;
 
-    return m_db->lookup(toSlice(_h));
+    if (std::string const* pending = findPending(_h))
+        return *pending;
+
+    if (!m_db)
+        return ret;
+
+    if (m_nodeCache && m_nodeCache->lookup(_h, ret))
+        return ret;
+
+    ret = m_db->lookup(toSlice(_h));
+    if (m_nodeCache && !ret.empty())
+        m_nodeCache->insert(_h, ret);
+    return ret;
 }
 
 bool OverlayDB::exists(h256 const& _h) const
 {
-    if (StateCacheDB::exists(_h))
+    if (StateCacheDB::exists(_h) || findPending(_h) || (m_nodeCache && m_nodeCache->contains(_h)))
         return true;
     return m_db && m_db->exists(toSlice(_h));
 }
 
+size_t OverlayDB::sweep(h256s const& _candidates, h256Hash const& _live)
+{
+    assert(m_journal);
+    if (!m_db)
+        return 0;
+
+    size_t deleted = 0;
+    auto writeBatch = m_db->createWriteBatch();
+    // Hold the journal while deleting, a node written concurrently is either tracked already
+    // or written to the database after the batch below
+    Guard l(m_journal->x_journal);
+    for (auto const& h: _candidates)
+        if (!_live.count(h) && !m_journal->m_tracked.count(h))
+        {
+            writeBatch->kill(toSlice(h));
+            if (m_nodeCache)
+                m_nodeCache->erase(h);
+            ++deleted;
+        }
+    if (deleted)
+        m_db->commit(std::move(writeBatch));
+    return deleted;
+}
+
+void OverlayDB::compact()
+{
+    if (m_db)
+        m_db->compact();
+}
+
 void OverlayDB::kill(h256 const& _h)
 {
-    if (!StateCacheDB::kill(_h))
+    if (m_journal)
+        m_journal->touch(_h);
+
+    if (!StateCacheDB::kill(_h) && !findPending(_h))
     {
         if (m_db)
         {
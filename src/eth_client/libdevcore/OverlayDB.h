@@ -7,15 +7,56 @@
 #include <memory>
 #include <libdevcore/db.h>
 #include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/NodeCache.h>
 #include <libdevcore/StateCacheDB.h>
 
 namespace dev
 {
 
+/**
+ * @brief Records the keys of the nodes an OverlayDB writes to or releases from its database.
+ *
+ * Nodes are never deleted from disk on release, so every node touched by a block is a
+ * candidate for removal once no recent state root references it any more.
+ */
+class OverlayJournal
+{
+public:
+    void touch(h256 const& _h);
+
+    /// Returns the nodes touched since the last call and forgets them.
+    h256Hash takeTouched();
+
+    /// Additionally remember the nodes touched from now on, until stopTracking() is called.
+    /// OverlayDB::sweep() never deletes these, as they may be referenced by newer roots.
+    void startTracking();
+    void stopTracking();
+
+private:
+    friend class OverlayDB;
+
+    mutable Mutex x_journal;
+    h256Hash m_touched;
+    bool m_tracking = false;
+    h256Hash m_tracked;
+};
+
+/// Nodes checkpointed by an OverlayDB, which keeps them in memory until it commits.
+struct OverlayPendingSet
+{
+    std::unordered_map<h256, std::string> nodes;
+    size_t bytes = 0;
+};
+
 class OverlayDB: public StateCacheDB
 {
 public:
+    /// Sets of checkpointed nodes, oldest first. Copies of an overlay share the sets instead of
+    /// copying the nodes, a set which is shared is never modified again.
+    using PendingNodes = std::vector<std::shared_ptr<OverlayPendingSet>>;
+
     explicit OverlayDB(std::unique_ptr<db::DatabaseFace> _db = nullptr)
       : m_db(_db.release(), [](db::DatabaseFace* db) {
             clog(VerbosityDebug, "overlaydb") << "Closing state DB";
@@ -35,16 +76,60 @@ public:
     void commit();
 	void rollback();
 
+    /// Keep the nodes of the overlay in memory as if they were committed, until the next commit()
+    /// writes them to the database. Releasing a checkpointed node has no effect, like for one on disk.
+    void checkpoint();
+
+    /// The checkpointed nodes, to drop the ones checkpointed later with rollback(_pending).
+    PendingNodes pending() const { return m_pending; }
+
+    /// Drop the overlay and the nodes checkpointed since @a _pending was taken by pending(),
+    /// e.g. after executions whose state is thrown away.
+    void rollback(PendingNodes const& _pending);
+
+    /// The nodes checkpointed since @a _pending was taken by pending().
+    PendingNodes pendingSince(PendingNodes const& _pending) const;
+
+    /// Keep the nodes of @a _nodes in memory like checkpointed ones.
+    void addPending(PendingNodes const& _nodes);
+
+    /// @returns the nodes of @a _nodes in a single set.
+    static PendingNodes mergePending(PendingNodes const& _nodes);
+
+    /// Approximate memory used by the checkpointed nodes.
+    size_t pendingMemoryUsage() const;
+
 	std::string lookup(h256 const& _h) const;
 	bool exists(h256 const& _h) const;
 	void kill(h256 const& _h);
 
 	bytes lookupAux(h256 const& _h) const;
 
+    /// Record the nodes written and released by this overlay and its copies into @a _journal.
+    void setJournal(std::shared_ptr<OverlayJournal> _journal) { m_journal = std::move(_journal); }
+    std::shared_ptr<OverlayJournal> const& journal() const { return m_journal; }
+
+    /// Delete the nodes of @a _candidates from the database which are neither in @a _live nor
+    /// were touched since the journal started tracking. Requires a journal.
+    /// @returns the number of deleted nodes.
+    size_t sweep(h256s const& _candidates, h256Hash const& _live);
+
+    void compact();
+
+    /// Keep the nodes read from and written to the database in @a _cache, shared with the copies.
+    void setNodeCache(std::shared_ptr<NodeCache> _cache) { m_nodeCache = std::move(_cache); }
+    std::shared_ptr<NodeCache> const& nodeCache() const { return m_nodeCache; }
+
 private:
 	using StateCacheDB::clear;
 
     std::shared_ptr<db::DatabaseFace> m_db;
+    std::shared_ptr<OverlayJournal> m_journal;
+    std::shared_ptr<NodeCache> m_nodeCache;
+
+    std::string const* findPending(h256 const& _h) const;
+
+    PendingNodes m_pending;
 };
 
 }
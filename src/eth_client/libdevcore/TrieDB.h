@@ -76,6 +76,9 @@ public:
         return m_root;
     }  // patch the root in the case of the empty trie. TODO: handle this properly.
 
+    /// The root hash, without checking that the root node exists.
+    h256 const& rawRoot() const { return m_root; }
+
     std::string at(bytes const& _key) const { return at(&_key); }
     std::string at(bytesConstRef _key) const;
     void insert(bytes const& _key, bytes const& _value) { insert(&_key, &_value); }
@@ -365,6 +368,7 @@ public:
     using Super::isEmpty;
 
     using Super::root;
+    using Super::rawRoot;
     using Super::db;
 
     using Super::leftOvers;
@@ -415,6 +419,7 @@ public:
     using Super::isNull;
     using Super::isEmpty;
     using Super::root;
+    using Super::rawRoot;
     using Super::leftOvers;
     using Super::check;
     using Super::open;
@@ -51,6 +51,9 @@ public:
     // of each record in the database. If `f` returns false, the `forEach`
     // method must return immediately.
     virtual void forEach(std::function<bool(Slice, Slice)> f) const = 0;
+
+    // Reclaim the space of deleted records, a no-op for databases without compaction.
+    virtual void compact() {}
 };
 
 DEV_SIMPLE_EXCEPTION(DatabaseError);
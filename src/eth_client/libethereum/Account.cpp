@@ -40,16 +40,15 @@ void Account::resetCode()
 
 u256 Account::originalStorageValue(u256 const& _key, OverlayDB const& _db) const
 {
-    auto it = m_storageOriginal.find(_key);
-    if (it != m_storageOriginal.end())
-        return it->second;
-
     // Not in the original values cache - go to the DB.
+    return cachedOriginalStorageValue(_key, [&]() { return storageValueFromDB(_key, _db); });
+}
+
+u256 Account::storageValueFromDB(u256 const& _key, OverlayDB const& _db) const
+{
     SecureTrieDB<h256, OverlayDB> const memdb(const_cast<OverlayDB*>(&_db), m_storageRoot);
     std::string const payload = memdb.at(_key);
-    auto const value = payload.size() ? RLP(payload).toInt<u256>() : 0;
-    m_storageOriginal[_key] = value;
-    return value;
+    return payload.size() ? RLP(payload).toInt<u256>() : 0;
 }
 
 namespace js = json_spirit;
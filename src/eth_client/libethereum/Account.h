@@ -135,6 +135,23 @@ public:
     /// not taking into account overlayed modifications
     u256 originalStorageValue(u256 const& _key, OverlayDB const& _db) const;
 
+    /// @returns account's original storage value corresponding to the @_key,
+    /// calling @a _load to read it if it is not cached
+    template <class Load>
+    u256 cachedOriginalStorageValue(u256 const& _key, Load const& _load) const
+    {
+        auto it = m_storageOriginal.find(_key);
+        if (it != m_storageOriginal.end())
+            return it->second;
+
+        auto const value = _load();
+        m_storageOriginal[_key] = value;
+        return value;
+    }
+
+    /// @returns account's storage value corresponding to the @_key read from the storage trie
+    u256 storageValueFromDB(u256 const& _key, OverlayDB const& _db) const;
+
     /// @returns the storage overlay as a simple hash map.
     std::unordered_map<u256, u256> const& storageOverlay() const { return m_storageOverlay; }
 
@@ -0,0 +1,111 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2015-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "CodeCache.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+CodeCache::Entry const* CodeCache::find(Shard& _shard, h256 const& _codeHash)
+{
+    auto const it = _shard.entries.find(_codeHash);
+    if (it == _shard.entries.end())
+    {
+        ++_shard.misses;
+        return nullptr;
+    }
+    _shard.lru.splice(_shard.lru.begin(), _shard.lru, it->second.lru);
+    ++_shard.hits;
+    return &it->second;
+}
+
+shared_ptr<bytes const> CodeCache::code(h256 const& _codeHash)
+{
+    Shard& s = shard(_codeHash);
+    Guard l(s.x_shard);
+    Entry const* entry = find(s, _codeHash);
+    return entry ? entry->code : nullptr;
+}
+
+bool CodeCache::size(h256 const& _codeHash, size_t& o_size)
+{
+    Shard& s = shard(_codeHash);
+    Guard l(s.x_shard);
+    Entry const* entry = find(s, _codeHash);
+    if (!entry)
+        return false;
+    o_size = entry->code->size();
+    return true;
+}
+
+void CodeCache::store(h256 const& _codeHash, bytes const& _code)
+{
+    size_t const usage = entryUsage(_code.size());
+    size_t const maxShardUsage = m_maxShardUsage;
+    if (usage > maxShardUsage)
+        return;
+
+    // Copy the code outside of the lock
+    auto code = make_shared<bytes const>(_code);
+
+    Shard& s = shard(_codeHash);
+    Guard l(s.x_shard);
+    if (s.entries.count(_codeHash))
+        return;
+
+    evictUntil(s, maxShardUsage - usage);
+    s.lru.push_front(_codeHash);
+    s.entries.emplace(_codeHash, Entry{move(code), s.lru.begin()});
+    s.usage += usage;
+}
+
+void CodeCache::setMaxUsage(size_t _bytes)
+{
+    m_maxShardUsage = _bytes / c_shards;
+    for (auto& s: m_shards)
+    {
+        Guard l(s.x_shard);
+        evictUntil(s, m_maxShardUsage);
+    }
+}
+
+void CodeCache::clear()
+{
+    for (auto& s: m_shards)
+    {
+        Guard l(s.x_shard);
+        s.entries.clear();
+        s.lru.clear();
+        s.usage = 0;
+    }
+}
+
+CodeCache::Stats CodeCache::stats() const
+{
+    Stats ret;
+    for (auto const& s: m_shards)
+    {
+        Guard l(s.x_shard);
+        ret.hits += s.hits;
+        ret.misses += s.misses;
+        ret.evictions += s.evictions;
+        ret.entries += s.entries.size();
+        ret.usage += s.usage;
+    }
+    ret.maxUsage = m_maxShardUsage * c_shards;
+    return ret;
+}
+
+void CodeCache::evictUntil(Shard& _shard, size_t _usage)
+{
+    while (_shard.usage > _usage && !_shard.lru.empty())
+    {
+        auto const it = _shard.entries.find(_shard.lru.back());
+        _shard.usage -= entryUsage(it->second.code->size());
+        _shard.entries.erase(it);
+        _shard.lru.pop_back();
+        ++_shard.evictions;
+    }
+}
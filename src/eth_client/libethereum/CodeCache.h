@@ -0,0 +1,98 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2015-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief Thread-safe LRU cache of contract code keyed by code hash, sized in bytes.
+ *
+ * The cache is split into shards selected by the code hash, each with its own lock and least
+ * recently used list, so that concurrent executions do not serialise on a single lock. The code
+ * is handed out as a shared pointer so an eviction never invalidates code that is still in use.
+ * The evmone analyses of the code are cached separately by AnalysisCache, as they also depend
+ * on the EVM revision.
+ */
+class CodeCache
+{
+public:
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t usage = 0;     ///< Estimated memory used by the cached code in bytes.
+        size_t maxUsage = 0;  ///< Memory limit in bytes.
+    };
+
+    /// @returns the code with hash @a _codeHash, nullptr if it is not cached.
+    std::shared_ptr<bytes const> code(h256 const& _codeHash);
+
+    /// @returns true and sets @a o_size to the size of the code with hash @a _codeHash if it is cached.
+    bool size(h256 const& _codeHash, size_t& o_size);
+
+    /// Stores @a _code, whose hash is @a _codeHash.
+    void store(h256 const& _codeHash, bytes const& _code);
+
+    /// Sets the memory limit in bytes, evicting entries if needed. Zero disables the cache.
+    void setMaxUsage(size_t _bytes);
+
+    /// Drops all entries. Counters are preserved.
+    void clear();
+
+    Stats stats() const;
+
+    static CodeCache& instance()
+    {
+        static CodeCache cache;
+        return cache;
+    }
+
+    static constexpr size_t c_defaultMaxUsage = 32 * 1024 * 1024;
+    static constexpr size_t c_shards = 16;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<bytes const> code;
+        std::list<h256>::iterator lru;
+    };
+
+    struct Shard
+    {
+        mutable Mutex x_shard;
+        std::unordered_map<h256, Entry> entries;
+        std::list<h256> lru;  ///< Most recently used first.
+        size_t usage = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    Shard& shard(h256 const& _codeHash) { return m_shards[_codeHash[0] % c_shards]; }
+    Entry const* find(Shard& _shard, h256 const& _codeHash);
+    static void evictUntil(Shard& _shard, size_t _usage);
+    static size_t entryUsage(size_t _codeSize) { return _codeSize + sizeof(Entry) + sizeof(h256) * 2 + 64; }
+
+    std::array<Shard, c_shards> m_shards;
+    std::atomic<size_t> m_maxShardUsage{c_defaultMaxUsage / c_shards};
+};
+
+}  // namespace eth
+}  // namespace dev
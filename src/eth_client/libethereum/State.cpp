@@ -165,7 +165,10 @@ Account* State::account(Address const& _addr)
         return nullptr;
 
     // Populate basic info.
-    string stateBack = m_state.at(_addr);
+    StateSnapshot& snapshot = StateSnapshot::instance();
+    string stateBack = snapshot.isOpen() ?
+        snapshot.account(m_state.rawRoot(), _addr, [&]() { return m_state.at(_addr); }) :
+        m_state.at(_addr);
     if (stateBack.empty())
     {
         m_nonExistingAccountsCache.insert(_addr);
@@ -211,7 +214,11 @@ void State::commit(CommitBehaviour _commitBehaviour)
 {
     if (_commitBehaviour == CommitBehaviour::RemoveEmptyAccounts)
         removeEmptyAccounts();
+    h256 const parentRoot = m_state.rawRoot();
     m_touched += dev::eth::commit(m_cache, m_state);
+    StateSnapshot& snapshot = StateSnapshot::instance();
+    if (snapshot.isOpen() && m_state.rawRoot() != parentRoot)
+        snapshot.update(parentRoot, m_state.rawRoot(), committedDiff());
     m_changeLog.clear();
     m_cache.clear();
     m_unchangedCacheEntries.clear();
@@ -432,7 +439,13 @@ u256 State::getNonce(Address const& _addr) const
 u256 State::storage(Address const& _id, u256 const& _key) const
 {
     if (Account const* a = account(_id))
-        return a->storageValue(_key, m_db);
+    {
+        auto const mit = a->storageOverlay().find(_key);
+        if (mit != a->storageOverlay().end())
+            return mit->second;
+
+        return originalStorage(_id, *a, _key);
+    }
     else
         return 0;
 }
@@ -446,11 +459,46 @@ void State::setStorage(Address const& _contract, u256 const& _key, u256 const& _
 u256 State::originalStorageValue(Address const& _contract, u256 const& _key) const
 {
     if (Account const* a = account(_contract))
-        return a->originalStorageValue(_key, m_db);
+        return originalStorage(_contract, *a, _key);
     else
         return 0;
 }
 
+u256 State::originalStorage(Address const& _id, Account const& _a, u256 const& _key) const
+{
+    StateSnapshot& snapshot = StateSnapshot::instance();
+    // A storage root other than the empty one is always the root of the account in the trie,
+    // storage cleared or created since the last commit is empty
+    if (!snapshot.isOpen() || _a.baseRoot() == EmptyTrie)
+        return _a.originalStorageValue(_key, m_db);
+
+    return _a.cachedOriginalStorageValue(_key, [&]() {
+        return snapshot.storage(m_state.rawRoot(), _id, _key, [&]() { return _a.storageValueFromDB(_key, m_db); });
+    });
+}
+
+StateDiff State::committedDiff() const
+{
+    StateDiff diff;
+    for (auto const& i: m_cache)
+        if (i.second.isDirty())
+        {
+            if (!i.second.isAlive())
+            {
+                diff.accounts[i.first] = string();
+                diff.wiped.insert(i.first);
+                continue;
+            }
+
+            diff.accounts[i.first] = m_state.at(i.first);
+            if (i.second.baseRoot() == EmptyTrie)
+                diff.wiped.insert(i.first);
+            if (!i.second.storageOverlay().empty())
+                diff.storage[i.first] = i.second.storageOverlay();
+        }
+    return diff;
+}
+
 void State::clearStorage(Address const& _contract)
 {
     h256 const& oldHash{m_cache[_contract].baseRoot()};
@@ -518,10 +566,16 @@ bytes const& State::code(Address const& _addr) const
 
     if (a->code().empty())
     {
-        // Load the code from the backend.
+        // Load the code from the cache or the backend.
         Account* mutableAccount = const_cast<Account*>(a);
-        mutableAccount->noteCode(m_db.lookup(a->codeHash()));
-        CodeSizeCache::instance().store(a->codeHash(), a->code().size());
+        auto& codeCache = CodeCache::instance();
+        if (auto code = codeCache.code(a->codeHash()))
+            mutableAccount->noteCode(bytesConstRef(code.get()));
+        else
+        {
+            mutableAccount->noteCode(m_db.lookup(a->codeHash()));
+            codeCache.store(a->codeHash(), a->code());
+        }
     }
 
     return a->code();
@@ -550,16 +604,12 @@ size_t State::codeSize(Address const& _a) const
     {
         if (a->hasNewCode())
             return a->code().size();
-        auto& codeSizeCache = CodeSizeCache::instance();
-        h256 codeHash = a->codeHash();
-        if (codeSizeCache.contains(codeHash))
-            return codeSizeCache.get(codeHash);
-        else
-        {
-            size_t size = code(_a).size();
-            codeSizeCache.store(codeHash, size);
+        if (!a->code().empty())
+            return a->code().size();
+        size_t size;
+        if (CodeCache::instance().size(a->codeHash(), size))
             return size;
-        }
+        return code(_a).size();
     }
     else
         return 0;
@@ -788,8 +838,7 @@ AddressHash dev::eth::commit(AccountMap const& _cache, SecureTrieDB<Address, DB>
                 if (i.second.hasNewCode())
                 {
                     h256 ch = i.second.codeHash();
-                    // Store the size of the code
-                    CodeSizeCache::instance().store(ch, i.second.code().size());
+                    CodeCache::instance().store(ch, i.second.code());
                     _state.db()->insert(ch, &i.second.code());
                     s << ch;
                 }
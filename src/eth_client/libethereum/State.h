@@ -13,7 +13,8 @@
 #include <libdevcore/RLP.h>
 #include <libethcore/BlockHeader.h>
 #include <libethcore/Exceptions.h>
-#include <libethereum/CodeSizeCache.h>
+#include <libethereum/CodeCache.h>
+#include <libethereum/StateSnapshot.h>
 #include <libevm/ExtVMFace.h>
 #include <array>
 #include <unordered_map>
@@ -313,6 +314,13 @@ public:
     virtual ~State(){}
 
 protected:
+    /// @returns the original value of a storage position of a cached account, read through the
+    /// state snapshot if it is open.
+    u256 originalStorage(Address const& _id, Account const& _a, u256 const& _key) const;
+
+    /// @returns the changes of the dirty accounts in the cache, after they were committed to the trie.
+    StateDiff committedDiff() const;
+
     /// Turns all "touched" empty accounts into non-alive accounts.
     void removeEmptyAccounts();
 
@@ -0,0 +1,370 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#include "StateSnapshot.h"
+
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/Log.h>
+#include <libdevcore/RLP.h>
+
+#include <leveldb/db.h>
+#include <leveldb/write_batch.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+char const c_rootKey = 'r';
+char const c_accountPrefix = 'a';
+char const c_storagePrefix = 's';
+
+/// Disk value of an account that does not exist, account RLP is always a list.
+string const c_noAccount = string(1, char(0x80));
+
+string accountKey(Address const& _a)
+{
+    string ret(1, c_accountPrefix);
+    ret.append(reinterpret_cast<char const*>(_a.data()), _a.size);
+    return ret;
+}
+
+string storagePrefix(Address const& _a)
+{
+    string ret(1, c_storagePrefix);
+    ret.append(reinterpret_cast<char const*>(_a.data()), _a.size);
+    return ret;
+}
+
+string storageKey(Address const& _a, u256 const& _key)
+{
+    h256 const k(_key);
+    return storagePrefix(_a).append(reinterpret_cast<char const*>(k.data()), k.size);
+}
+
+string storageValue(u256 const& _value)
+{
+    return asString(rlp(_value));
+}
+
+u256 storageValue(string const& _value)
+{
+    return RLP(_value).toInt<u256>();
+}
+
+}  // namespace
+
+StateSnapshot::StateSnapshot() = default;
+
+StateSnapshot::~StateSnapshot() = default;
+
+StateSnapshot& StateSnapshot::instance()
+{
+    static StateSnapshot snapshot;
+    return snapshot;
+}
+
+void StateSnapshot::open(string const& _path, h256 const& _root)
+{
+    WriteGuard l(x_snapshot);
+    m_path = _path;
+    m_layers.clear();
+    m_db.reset();
+
+    leveldb::DB* db = nullptr;
+    leveldb::Status status = leveldb::DB::Open(db::LevelDB::defaultDBOptions(), m_path, &db);
+    if (!status.ok())
+        BOOST_THROW_EXCEPTION(db::DatabaseError() << errinfo_comment(status.ToString()));
+    m_db.reset(db);
+
+    string root;
+    if (!m_db->Get(leveldb::ReadOptions(), string(1, c_rootKey), &root).ok() || h256(bytesConstRef(&root)) != _root)
+        reset(_root);
+    else
+        m_diskRoot = _root;
+    m_open = true;
+}
+
+void StateSnapshot::close(h256 const& _root)
+{
+    cap(_root, 0);
+
+    WriteGuard l(x_snapshot);
+    m_open = false;
+    m_layers.clear();
+    m_db.reset();
+}
+
+void StateSnapshot::update(h256 const& _parent, h256 const& _root, StateDiff&& _diff)
+{
+    WriteGuard l(x_snapshot);
+    if (!m_db || _root == m_diskRoot || m_layers.count(_root))
+        // The state of a root never changes, an existing layer stays valid
+        return;
+    m_layers.emplace(_root, Layer{_parent, std::move(_diff)});
+}
+
+string StateSnapshot::account(h256 const& _root, Address const& _a, function<string()> const& _load)
+{
+    string const key = accountKey(_a);
+    h256 diskRoot;
+    {
+        ReadGuard l(x_snapshot);
+        if (!m_db)
+            return _load();
+
+        h256 root = _root;
+        for (auto it = m_layers.find(root); root != m_diskRoot; it = m_layers.find(root))
+        {
+            if (it == m_layers.end())
+            {
+                // Not a recent state
+                ++m_misses;
+                return _load();
+            }
+            auto const ait = it->second.diff.accounts.find(_a);
+            if (ait != it->second.diff.accounts.end())
+            {
+                ++m_hits;
+                return ait->second;
+            }
+            root = it->second.parent;
+        }
+
+        string const value = lookupDisk(key);
+        if (!value.empty())
+        {
+            ++m_hits;
+            return value == c_noAccount ? string() : value;
+        }
+        diskRoot = m_diskRoot;
+    }
+
+    // Unchanged since the disk layer, so the value at _root is the value of the disk layer
+    ++m_misses;
+    string const value = _load();
+    insertDisk(diskRoot, key, value.empty() ? c_noAccount : value);
+    return value;
+}
+
+u256 StateSnapshot::storage(h256 const& _root, Address const& _a, u256 const& _key, function<u256()> const& _load)
+{
+    string const key = storageKey(_a, _key);
+    h256 diskRoot;
+    {
+        ReadGuard l(x_snapshot);
+        if (!m_db)
+            return _load();
+
+        h256 root = _root;
+        for (auto it = m_layers.find(root); root != m_diskRoot; it = m_layers.find(root))
+        {
+            if (it == m_layers.end())
+            {
+                ++m_misses;
+                return _load();
+            }
+            StateDiff const& diff = it->second.diff;
+            auto const sit = diff.storage.find(_a);
+            if (sit != diff.storage.end())
+            {
+                auto const vit = sit->second.find(_key);
+                if (vit != sit->second.end())
+                {
+                    ++m_hits;
+                    return vit->second;
+                }
+            }
+            if (diff.wiped.count(_a))
+            {
+                ++m_hits;
+                return 0;
+            }
+            root = it->second.parent;
+        }
+
+        string const value = lookupDisk(key);
+        if (!value.empty())
+        {
+            ++m_hits;
+            return storageValue(value);
+        }
+        diskRoot = m_diskRoot;
+    }
+
+    ++m_misses;
+    u256 const value = _load();
+    insertDisk(diskRoot, key, storageValue(value));
+    return value;
+}
+
+void StateSnapshot::connectBlock(h256 const& _parent, h256 const& _root, size_t _maxLayers)
+{
+    WriteGuard l(x_snapshot);
+    if (!m_db)
+        return;
+
+    merge(_parent, _root);
+    prune(_root, _maxLayers);
+}
+
+void StateSnapshot::cap(h256 const& _root, size_t _maxLayers)
+{
+    WriteGuard l(x_snapshot);
+    if (!m_db)
+        return;
+
+    prune(_root, _maxLayers);
+}
+
+size_t StateSnapshot::layers() const
+{
+    ReadGuard l(x_snapshot);
+    return m_layers.size();
+}
+
+void StateSnapshot::reset(h256 const& _root)
+{
+    m_layers.clear();
+    m_db.reset();
+    leveldb::DestroyDB(m_path, leveldb::Options());
+
+    leveldb::DB* db = nullptr;
+    leveldb::Status status = leveldb::DB::Open(db::LevelDB::defaultDBOptions(), m_path, &db);
+    if (!status.ok())
+        BOOST_THROW_EXCEPTION(db::DatabaseError() << errinfo_comment(status.ToString()));
+    m_db.reset(db);
+
+    m_db->Put(leveldb::WriteOptions(), string(1, c_rootKey), leveldb::Slice(reinterpret_cast<char const*>(_root.data()), _root.size));
+    m_diskRoot = _root;
+}
+
+void StateSnapshot::merge(h256 const& _parent, h256 const& _root)
+{
+    vector<unordered_map<h256, Layer>::iterator> commits;
+    for (h256 root = _root; root != _parent;)
+    {
+        auto const it = m_layers.find(root);
+        if (it == m_layers.end())
+            // Commits recorded before the snapshot was opened, or already flattened
+            return;
+        commits.push_back(it);
+        root = it->second.parent;
+    }
+    if (commits.size() < 2)
+        return;
+
+    // Apply the commits from the oldest, a wipe drops the storage changes before it
+    StateDiff merged;
+    for (auto c = commits.rbegin(); c != commits.rend(); ++c)
+    {
+        StateDiff& diff = (*c)->second.diff;
+        for (auto const& a: diff.wiped)
+        {
+            merged.storage.erase(a);
+            merged.wiped.insert(a);
+        }
+        for (auto& i: diff.accounts)
+            merged.accounts[i.first] = std::move(i.second);
+        for (auto const& i: diff.storage)
+            for (auto const& j: i.second)
+                merged.storage[i.first][j.first] = j.second;
+    }
+
+    for (auto const& c: commits)
+        m_layers.erase(c);
+    m_layers.emplace(_root, Layer{_parent, std::move(merged)});
+}
+
+void StateSnapshot::prune(h256 const& _root, size_t _maxLayers)
+{
+    vector<h256> chain;
+    for (h256 root = _root; root != m_diskRoot;)
+    {
+        auto const it = m_layers.find(root);
+        if (it == m_layers.end())
+        {
+            // The chain moved to a state the layers do not lead to, e.g. after a deep reorg.
+            // Keep the layers which still reach the disk layer, in case the chain comes back.
+            clog(VerbosityDebug, "snapshot") << "State snapshot does not reach " << _root;
+            unordered_map<h256, bool> reaches;
+            function<bool(h256 const&)> reachesDisk = [&](h256 const& _r) {
+                if (_r == m_diskRoot)
+                    return true;
+                auto const rit = reaches.find(_r);
+                if (rit != reaches.end())
+                    return rit->second;
+                auto const lit = m_layers.find(_r);
+                bool const ret = lit != m_layers.end() && reachesDisk(lit->second.parent);
+                reaches[_r] = ret;
+                return ret;
+            };
+            for (auto lit = m_layers.begin(); lit != m_layers.end();)
+                lit = reachesDisk(lit->first) ? std::next(lit) : m_layers.erase(lit);
+            return;
+        }
+        chain.push_back(root);
+        root = it->second.parent;
+    }
+
+    // Layers of failed blocks and of block templates are never read again
+    if (chain.size() != m_layers.size())
+    {
+        unordered_set<h256> const keep(chain.begin(), chain.end());
+        for (auto it = m_layers.begin(); it != m_layers.end();)
+            it = keep.count(it->first) ? std::next(it) : m_layers.erase(it);
+    }
+
+    while (chain.size() > _maxLayers)
+    {
+        flatten(chain.back());
+        chain.pop_back();
+    }
+}
+
+void StateSnapshot::flatten(h256 const& _root)
+{
+    auto const it = m_layers.find(_root);
+    assert(it != m_layers.end() && it->second.parent == m_diskRoot);
+    StateDiff const& diff = it->second.diff;
+
+    leveldb::WriteBatch batch;
+    for (auto const& a: diff.wiped)
+    {
+        string const prefix = storagePrefix(a);
+        unique_ptr<leveldb::Iterator> itr(m_db->NewIterator(leveldb::ReadOptions()));
+        for (itr->Seek(prefix); itr->Valid() && itr->key().starts_with(prefix); itr->Next())
+            batch.Delete(itr->key());
+    }
+    for (auto const& i: diff.accounts)
+        batch.Put(accountKey(i.first), i.second.empty() ? c_noAccount : i.second);
+    for (auto const& i: diff.storage)
+        for (auto const& j: i.second)
+            batch.Put(storageKey(i.first, j.first), storageValue(j.second));
+    batch.Put(string(1, c_rootKey), leveldb::Slice(reinterpret_cast<char const*>(_root.data()), _root.size));
+
+    leveldb::Status status = m_db->Write(leveldb::WriteOptions(), &batch);
+    if (!status.ok())
+        BOOST_THROW_EXCEPTION(db::DatabaseError() << errinfo_comment(status.ToString()));
+
+    m_diskRoot = _root;
+    m_layers.erase(it);
+}
+
+string StateSnapshot::lookupDisk(string const& _key) const
+{
+    string value;
+    m_db->Get(leveldb::ReadOptions(), _key, &value);
+    return value;
+}
+
+void StateSnapshot::insertDisk(h256 const& _diskRoot, string const& _key, string const& _value)
+{
+    WriteGuard l(x_snapshot);
+    // The disk layer may have moved on while the trie was read
+    if (m_db && m_diskRoot == _diskRoot)
+        m_db->Put(leveldb::WriteOptions(), _key, _value);
+}
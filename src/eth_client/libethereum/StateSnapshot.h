@@ -0,0 +1,116 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+
+#pragma once
+
+#include <libdevcore/Address.h>
+#include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace leveldb
+{
+class DB;
+}
+
+namespace dev
+{
+namespace eth
+{
+
+/// Changes of the accounts and their storage between two state roots.
+struct StateDiff
+{
+    /// Account RLP as stored in the state trie, empty if the account was removed.
+    std::unordered_map<Address, std::string> accounts;
+    std::unordered_map<Address, std::unordered_map<u256, u256>> storage;
+    /// Accounts whose storage was cleared before the changes in storage were applied.
+    std::unordered_set<Address> wiped;
+};
+
+/**
+ * @brief Flat account and storage lookups for recent state roots.
+ *
+ * A disk layer maps accounts and storage slots to their values at one state root, and in-memory
+ * diff layers record the changes of every State::commit on top of it. Lookups for a root walk the
+ * diff layers down to the disk layer, and fall back to the trie for roots the layers do not reach.
+ * The disk layer is filled on demand from the trie, a missing entry only means it was not read yet.
+ * connectBlock() merges the layers of the commits of a block into one, and cap() keeps the layers
+ * on top of the chain tip and flattens the oldest ones into the disk layer.
+ */
+class StateSnapshot
+{
+public:
+    StateSnapshot();
+    ~StateSnapshot();
+
+    /// Open the disk layer at @a _path for the state @a _root, starting an empty one if the
+    /// stored layer belongs to another root.
+    void open(std::string const& _path, h256 const& _root);
+
+    /// Flatten the diff layers below @a _root and close the disk layer.
+    void close(h256 const& _root);
+
+    bool isOpen() const { return m_open; }
+
+    /// Record the changes of a commit which moved the state from @a _parent to @a _root.
+    void update(h256 const& _parent, h256 const& _root, StateDiff&& _diff);
+
+    /// @returns the RLP of account @a _a at state @a _root, empty if it does not exist.
+    /// @a _load reads it from the trie when the snapshot does not know it.
+    std::string account(h256 const& _root, Address const& _a, std::function<std::string()> const& _load);
+
+    /// @returns the value of slot @a _key of account @a _a at state @a _root.
+    u256 storage(h256 const& _root, Address const& _a, u256 const& _key, std::function<u256()> const& _load);
+
+    /// Merge the layers of the commits which moved the state from @a _parent to @a _root when a
+    /// block was connected into one layer, then cap() the layers at @a _root.
+    void connectBlock(h256 const& _parent, h256 const& _root, size_t _maxLayers = c_maxDiffLayers);
+
+    /// Drop the layers which are not below @a _root and flatten the oldest ones until at most
+    /// @a _maxLayers remain. When the layers do not lead to @a _root, e.g. after a reorg deeper
+    /// than them, they are kept for the roots they reach and @a _root is read from the trie.
+    void cap(h256 const& _root, size_t _maxLayers = c_maxDiffLayers);
+
+    size_t layers() const;
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+
+    static StateSnapshot& instance();
+
+    /// Layers kept on top of the disk layer, one for each block once it is connected.
+    static const size_t c_maxDiffLayers = 128;
+
+private:
+    struct Layer
+    {
+        h256 parent;
+        StateDiff diff;
+    };
+
+    void reset(h256 const& _root);
+    void merge(h256 const& _parent, h256 const& _root);
+    void prune(h256 const& _root, size_t _maxLayers);
+    void flatten(h256 const& _root);
+    std::string lookupDisk(std::string const& _key) const;
+    void insertDisk(h256 const& _diskRoot, std::string const& _key, std::string const& _value);
+
+    mutable SharedMutex x_snapshot;
+    std::string m_path;
+    std::unique_ptr<leveldb::DB> m_db;
+    h256 m_diskRoot;
+    std::unordered_map<h256, Layer> m_layers;
+    std::atomic<bool> m_open{false};
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+};
+
+}
+}
@@ -0,0 +1,141 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#include "AnalysisCache.h"
+
+#include <evmone/lib/evmone/analysis.hpp>
+#include <evmone/lib/evmone/baseline.hpp>
+
+namespace dev
+{
+namespace eth
+{
+namespace
+{
+/// Fixed per-entry bookkeeping overhead (map node, LRU node, shared_ptr control block).
+constexpr size_t c_entryOverhead = 128;
+
+size_t memoryUsage(evmone::AdvancedCodeAnalysis const& _analysis)
+{
+    return sizeof(_analysis) + _analysis.instrs.capacity() * sizeof(evmone::instruction) +
+           _analysis.push_values.capacity() * sizeof(intx::uint256) +
+           _analysis.jumpdest_offsets.capacity() * sizeof(int32_t) +
+           _analysis.jumpdest_targets.capacity() * sizeof(int32_t);
+}
+
+size_t memoryUsage(evmone::baseline::CodeAnalysis const& _analysis, size_t _codeSize)
+{
+    // Padded code is at most code size + 32 bytes of PUSH data + final STOP.
+    return sizeof(_analysis) + _codeSize + 33 + _analysis.jumpdest_map.size() / 8;
+}
+}  // namespace
+
+std::shared_ptr<evmone::AdvancedCodeAnalysis const> AnalysisCache::advanced(
+    h256 const& _codeHash, evmc_revision _rev, bytesConstRef _code)
+{
+    Key const key{_codeHash, static_cast<int>(_rev)};
+    if (auto cached = lookup(key, _code.size()))
+        return std::static_pointer_cast<evmone::AdvancedCodeAnalysis const>(cached);
+
+    // Analyse outside of the lock. Two threads missing on the same code may both analyse it,
+    // in which case the later insert replaces the earlier one.
+    auto analysis = std::make_shared<evmone::AdvancedCodeAnalysis const>(
+        evmone::analyze(_rev, _code.data(), _code.size()));
+    insert(key, analysis, _code.size(), memoryUsage(*analysis));
+    return analysis;
+}
+
+std::shared_ptr<evmone::baseline::CodeAnalysis const> AnalysisCache::baseline(
+    h256 const& _codeHash, bytesConstRef _code)
+{
+    Key const key{_codeHash, c_baselineRev};
+    if (auto cached = lookup(key, _code.size()))
+        return std::static_pointer_cast<evmone::baseline::CodeAnalysis const>(cached);
+
+    // CodeAnalysis has const members and cannot be moved, so construct it in place.
+    std::shared_ptr<evmone::baseline::CodeAnalysis const> analysis{
+        new evmone::baseline::CodeAnalysis(evmone::baseline::analyze(_code.data(), _code.size()))};
+    insert(key, analysis, _code.size(), memoryUsage(*analysis, _code.size()));
+    return analysis;
+}
+
+std::shared_ptr<void const> AnalysisCache::lookup(Key const& _key, size_t _codeSize)
+{
+    Guard l(x_cache);
+    auto it = m_cache.find(_key);
+    // The size check is a cheap guard against a code hash that does not match the code.
+    if (it == m_cache.end() || it->second.codeSize != _codeSize)
+    {
+        ++m_misses;
+        return {};
+    }
+    ++m_hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return it->second.analysis;
+}
+
+void AnalysisCache::insert(
+    Key const& _key, std::shared_ptr<void const> _analysis, size_t _codeSize, size_t _usage)
+{
+    _usage += c_entryOverhead;
+
+    Guard l(x_cache);
+    if (_usage > m_maxUsage)
+        return;
+
+    auto it = m_cache.find(_key);
+    if (it != m_cache.end())
+    {
+        m_usage -= it->second.usage;
+        m_lru.erase(it->second.lru);
+        m_cache.erase(it);
+    }
+
+    evictUntil(m_maxUsage - _usage);
+    m_lru.push_front(_key);
+    m_cache.emplace(_key, Entry{std::move(_analysis), _codeSize, _usage, m_lru.begin()});
+    m_usage += _usage;
+}
+
+void AnalysisCache::evictUntil(size_t _usage)
+{
+    while (m_usage > _usage && !m_lru.empty())
+    {
+        auto it = m_cache.find(m_lru.back());
+        m_usage -= it->second.usage;
+        m_cache.erase(it);
+        m_lru.pop_back();
+        ++m_evictions;
+    }
+}
+
+void AnalysisCache::setMaxUsage(size_t _bytes)
+{
+    Guard l(x_cache);
+    m_maxUsage = _bytes;
+    evictUntil(m_maxUsage);
+}
+
+void AnalysisCache::clear()
+{
+    Guard l(x_cache);
+    m_cache.clear();
+    m_lru.clear();
+    m_usage = 0;
+}
+
+AnalysisCache::Stats AnalysisCache::stats() const
+{
+    Guard l(x_cache);
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.entries = m_cache.size();
+    stats.usage = m_usage;
+    stats.maxUsage = m_maxUsage;
+    return stats;
+}
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,120 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/vector_ref.h>
+
+#include <evmc/evmc.h>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace evmone
+{
+struct AdvancedCodeAnalysis;
+namespace baseline
+{
+struct CodeAnalysis;
+}
+}  // namespace evmone
+
+namespace dev
+{
+namespace eth
+{
+/**
+ * @brief Thread-safe LRU cache of evmone code analyses keyed by code hash.
+ *
+ * The advanced interpreter analysis depends on the EVM revision (block gas costs are
+ * baked into the instruction stream), so it is keyed by (code hash, revision). The baseline
+ * jumpdest analysis is revision independent. Entries are handed out as shared pointers so an
+ * eviction never invalidates an analysis that is still being executed.
+ */
+class AnalysisCache
+{
+public:
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t usage = 0;     ///< Estimated memory used by the cached analyses in bytes.
+        size_t maxUsage = 0;  ///< Memory limit in bytes.
+    };
+
+    /// Returns the advanced analysis of @a _code, running evmone::analyze() on a miss.
+    std::shared_ptr<evmone::AdvancedCodeAnalysis const> advanced(
+        h256 const& _codeHash, evmc_revision _rev, bytesConstRef _code);
+
+    /// Returns the baseline analysis of @a _code, running evmone::baseline::analyze() on a miss.
+    std::shared_ptr<evmone::baseline::CodeAnalysis const> baseline(
+        h256 const& _codeHash, bytesConstRef _code);
+
+    /// Sets the memory limit in bytes, evicting entries if needed. Zero disables the cache.
+    void setMaxUsage(size_t _bytes);
+
+    /// Drops all entries. Counters are preserved.
+    void clear();
+
+    Stats stats() const;
+
+    static AnalysisCache& instance()
+    {
+        static AnalysisCache cache;
+        return cache;
+    }
+
+    static constexpr size_t c_defaultMaxUsage = 64 * 1024 * 1024;
+
+private:
+    struct Key
+    {
+        h256 codeHash;
+        int rev;  ///< evmc_revision for advanced analyses, c_baselineRev for baseline ones.
+
+        bool operator==(Key const& _other) const
+        {
+            return codeHash == _other.codeHash && rev == _other.rev;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(Key const& _key) const
+        {
+            return std::hash<h256>{}(_key.codeHash) ^ static_cast<size_t>(_key.rev);
+        }
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<void const> analysis;
+        size_t codeSize = 0;
+        size_t usage = 0;
+        std::list<Key>::iterator lru;
+    };
+
+    std::shared_ptr<void const> lookup(Key const& _key, size_t _codeSize);
+    void insert(Key const& _key, std::shared_ptr<void const> _analysis, size_t _codeSize,
+        size_t _usage);
+    void evictUntil(size_t _usage);
+
+    static constexpr int c_baselineRev = -1;
+
+    mutable Mutex x_cache;
+    std::unordered_map<Key, Entry, KeyHash> m_cache;
+    std::list<Key> m_lru;  ///< Most recently used first.
+    size_t m_usage = 0;
+    size_t m_maxUsage = c_defaultMaxUsage;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -2,10 +2,16 @@
 // Copyright 2014-2019 Aleth Authors.
 // Licensed under the GNU General Public License, Version 3.
 #include "EVMC.h"
+#include "AnalysisCache.h"
 
 #include <libdevcore/Log.h>
 #include <libevm/VMFactory.h>
 
+#include <evmone/lib/evmone/analysis.hpp>
+#include <evmone/lib/evmone/baseline.hpp>
+#include <evmone/lib/evmone/execution.hpp>
+#include <evmone/lib/evmone/vm.hpp>
+
 namespace dev
 {
 namespace eth
@@ -36,6 +42,36 @@ evmc_revision toRevision(EVMSchedule const& _schedule) noexcept
 }
 }  // namespace
 
+evmc::result EVMC::execute(EvmCHost& _host, evmc_revision _rev, evmc_message const& _msg,
+    ExtVMFace const& _ext) noexcept
+{
+    evmc_vm* vm = get_raw_pointer();
+    bytesConstRef const code{&_ext.code};
+
+    // Init code runs once and is hashed on the fly, so only cache analyses of deployed code.
+    if (!_ext.isCreate && _ext.codeHash && !code.empty())
+    {
+        auto& cache = AnalysisCache::instance();
+        if (vm->execute == static_cast<evmc_execute_fn>(evmone::execute))
+        {
+            auto const analysis = cache.advanced(_ext.codeHash, _rev, code);
+            auto state = std::make_unique<evmone::AdvancedExecutionState>(_msg, _rev,
+                evmc::Host::get_interface(), _host.to_context(), code.data(), code.size());
+            return evmc::result{evmone::execute(*state, *analysis)};
+        }
+        if (vm->execute == static_cast<evmc_execute_fn>(evmone::baseline::execute))
+        {
+            auto const analysis = cache.baseline(_ext.codeHash, code);
+            auto state = std::make_unique<evmone::ExecutionState>(_msg, _rev,
+                evmc::Host::get_interface(), _host.to_context(), code.data(), code.size());
+            return evmc::result{evmone::baseline::execute(
+                *static_cast<evmone::VM const*>(vm), *state, *analysis)};
+        }
+    }
+
+    return evmc::VM::execute(_host, _rev, _msg, code.data(), code.size());
+}
+
 EVMC::EVMC(evmc_vm* _vm, std::vector<std::pair<std::string, std::string>> const& _options) noexcept
   : evmc::VM(_vm)
 {
@@ -87,7 +123,7 @@ owning_bytes_ref EVMC::exec(u256& io_gas, ExtVMFace& _ext, const OnOpFunc& _onOp
         toEvmC(0x0_cppui256)};
     EvmCHost host{_ext};
 
-    auto r = execute(host, mode, msg, _ext.code.data(), _ext.code.size());
+    auto r = execute(host, mode, msg, _ext);
     // FIXME: Copy the output for now, but copyless version possible.
     auto output = owning_bytes_ref{{&r.output_data[0], &r.output_data[r.output_size]}, 0, r.output_size};
 
@@ -20,6 +20,12 @@ public:
     EVMC(evmc_vm* _vm, std::vector<std::pair<std::string, std::string>> const& _options) noexcept;
 
     owning_bytes_ref exec(u256& io_gas, ExtVMFace& _ext, OnOpFunc const& _onOp) final;
+
+private:
+    /// Executes the code of @a _ext, reusing a cached evmone analysis of deployed code
+    /// when the VM runs one of the built-in evmone interpreters.
+    evmc::result execute(EvmCHost& _host, evmc_revision _rev, evmc_message const& _msg,
+        ExtVMFace const& _ext) noexcept;
 };
 }  // namespace eth
 }  // namespace dev
@@ -169,6 +169,7 @@ evmc_tx_context EvmCHost::get_tx_context() const noexcept
     result.tx_origin = toEvmC(m_extVM.origin);
 
     auto const& envInfo = m_extVM.envInfo();
+    envInfo.noteContextRead();
     result.block_coinbase = toEvmC(envInfo.author());
     result.block_number = envInfo.number();
     result.block_timestamp = envInfo.timestamp();
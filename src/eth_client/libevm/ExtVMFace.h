@@ -152,11 +152,17 @@ public:
     u256 const& gasUsed() const { return m_gasUsed; }
     u256 const& chainID() const { return m_chainID; }
 
+    /// Sets a flag raised when the EVM reads the coinbase, timestamp, difficulty or gas limit of
+    /// the block. The flag is shared by the copies of the environment made by the executions.
+    void setContextReadFlag(bool* _flag) { m_contextRead = _flag; }
+    void noteContextRead() const { if (m_contextRead) *m_contextRead = true; }
+
 private:
     BlockHeader m_headerInfo;
     LastBlockHashesFace const& m_lastHashes;
     u256 m_gasUsed;
     u256 m_chainID;
+    bool* m_contextRead = nullptr;
 };
 
 /// Represents a call result.
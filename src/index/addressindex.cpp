@@ -0,0 +1,567 @@
+// Copyright (c) 2026 The Revo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addressindex.h>
+
+#include <chainparams.h>
+#include <node/blockstorage.h>
+#include <script/standard.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <functional>
+#include <map>
+
+constexpr uint8_t DB_ADDRESSINDEX{'a'};
+constexpr uint8_t DB_ADDRESSBALANCE{'A'};
+constexpr uint8_t DB_ADDRESSUNSPENTINDEX{'u'};
+constexpr uint8_t DB_SPENTINDEX{'p'};
+constexpr uint8_t DB_TIMESTAMPINDEX{'S'};
+constexpr uint8_t DB_BLOCKHASHINDEX{'z'};
+
+std::unique_ptr<AddressIndex> g_address_index;
+
+namespace {
+
+/** The entries of a block in the address, unspent and spent indexes, null values are erased */
+struct BlockEntries
+{
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
+    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
+};
+
+/** Address type and 32 bytes hash of a destination, false if it has no address */
+bool GetIndexAddress(const COutPoint& prevout, const CScript& scriptPubKey, int& type, uint256& hashBytes)
+{
+    CTxDestination dest;
+    if (!ExtractDestination(prevout, scriptPubKey, dest)) {
+        return false;
+    }
+    valtype bytesID(std::visit(DataVisitor(), dest));
+    if (bytesID.empty()) {
+        return false;
+    }
+    valtype addressBytes(32);
+    std::copy(bytesID.begin(), bytesID.end(), addressBytes.begin());
+    type = dest.index();
+    hashBytes = uint256(addressBytes);
+    return true;
+}
+
+/**
+ * Collect the entries written when a block is connected, or the updates that undo them if fDisconnect.
+ * The unspent outputs are updated in the order ConnectBlock and DisconnectBlock update the coins, so
+ * the outputs spent in the block they are created in are not left behind.
+ */
+void GetBlockEntries(const CBlock& block, const CBlockUndo& blockUndo, const CBlockIndex* pindex, bool fDisconnect, BlockEntries& entries)
+{
+    const int count = block.vtx.size();
+    for (int n = 0; n < count; n++) {
+        const int i = fDisconnect ? count - 1 - n : n;
+        const CTransaction& tx = *block.vtx[i];
+        const uint256 hash = tx.GetHash();
+
+        auto addOutputs = [&] {
+            for (unsigned int k = 0; k < tx.vout.size(); k++) {
+                const CTxOut& out = tx.vout[k];
+                int type;
+                uint256 hashBytes;
+                if (!GetIndexAddress({hash, k}, out.scriptPubKey, type, hashBytes)) {
+                    continue;
+                }
+                // receiving activity
+                entries.addressIndex.push_back(std::make_pair(CAddressIndexKey(type, hashBytes, pindex->nHeight, i, hash, k, false), out.nValue));
+                // unspent output
+                entries.addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(type, hashBytes, hash, k),
+                    fDisconnect ? CAddressUnspentValue() : CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight, tx.IsCoinStake())));
+            }
+        };
+
+        if (fDisconnect) {
+            addOutputs();
+        }
+        if (i > 0) {
+            const CTxUndo& txundo = blockUndo.vtxundo[i - 1];
+            for (unsigned int j = 0; j < tx.vin.size(); j++) {
+                const COutPoint& prevout = tx.vin[j].prevout;
+                const Coin& coin = txundo.vprevout[j];
+                int type;
+                uint256 hashBytes;
+                if (!GetIndexAddress(prevout, coin.out.scriptPubKey, type, hashBytes)) {
+                    continue;
+                }
+                // spending activity
+                entries.addressIndex.push_back(std::make_pair(CAddressIndexKey(type, hashBytes, pindex->nHeight, i, hash, j, true), coin.out.nValue * -1));
+                // spent output
+                entries.addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(type, hashBytes, prevout.hash, prevout.n),
+                    fDisconnect ? CAddressUnspentValue(coin.out.nValue, coin.out.scriptPubKey, coin.nHeight, coin.fCoinStake) : CAddressUnspentValue()));
+                entries.spentIndex.push_back(std::make_pair(CSpentIndexKey(prevout.hash, prevout.n),
+                    fDisconnect ? CSpentIndexValue() : CSpentIndexValue(hash, j, pindex->nHeight, coin.out.nValue, type, hashBytes)));
+            }
+        }
+        if (!fDisconnect) {
+            addOutputs();
+        }
+    }
+}
+
+/** Erase the entries with a prefix and keys of type K, writing the batch when it grows large */
+template <typename K>
+bool EraseEntries(CDBWrapper& db, CDBIterator& cursor, CDBBatch& batch, uint8_t prefix)
+{
+    cursor.Seek(prefix);
+
+    while (cursor.Valid()) {
+        std::pair<uint8_t, K> key;
+        if (!cursor.GetKey(key) || key.first != prefix) {
+            break;
+        }
+        batch.Erase(key);
+        if (batch.SizeEstimate() > (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize)) {
+            if (!db.WriteBatch(batch)) {
+                return false;
+            }
+            batch.Clear();
+        }
+        cursor.Next();
+    }
+    return true;
+}
+
+/** Copy the entries with a prefix, keys of type K and values of type V to the batch of db, writing it when it grows large */
+template <typename K, typename V>
+bool CopyEntries(CDBWrapper& db, CDBIterator& cursor, CDBBatch& batch, uint8_t prefix, const std::function<void(const K&, const V&)>& fn = {})
+{
+    cursor.Seek(prefix);
+
+    while (cursor.Valid()) {
+        std::pair<uint8_t, K> key;
+        V value;
+        if (!cursor.GetKey(key) || key.first != prefix) {
+            break;
+        }
+        if (!cursor.GetValue(value)) {
+            return false;
+        }
+        batch.Write(key, value);
+        if (fn) {
+            fn(key.second, value);
+        }
+        if (batch.SizeEstimate() > (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize)) {
+            if (!db.WriteBatch(batch)) {
+                return false;
+            }
+            batch.Clear();
+        }
+        cursor.Next();
+    }
+    return true;
+}
+
+} // namespace
+
+/** Access to the address index database (indexes/addressindex/) */
+class AddressIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Add the entries of a block, or remove them if fErase, in batch.
+    bool WriteEntries(CDBBatch& batch, const BlockEntries& entries, bool fErase);
+
+    bool ReadTimestampBlockIndex(const uint256 &hash, unsigned int &ltimestamp) const;
+
+    /// Erase all the entries of the index, the best block is kept.
+    bool EraseAllEntries();
+
+    /// Copy the entries of the index written by older versions to the block index database.
+    bool CopyLegacyEntries(CDBWrapper& db, CDBBatch& batch);
+
+private:
+    /// Add the balance changes to the sums of their addresses, or remove them if fErase.
+    bool UpdateAddressBalances(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount> >&vect, bool fErase);
+};
+
+AddressIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "addressindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool AddressIndex::DB::UpdateAddressBalances(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount> >&vect, bool fErase)
+{
+    std::map<std::pair<unsigned int, uint256>, CAddressBalanceValue> deltas;
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
+        CAmount nValue = fErase ? -it->second : it->second;
+        CAddressBalanceValue& delta = deltas[std::make_pair(it->first.type, it->first.hashBytes)];
+        delta.balance += nValue;
+        if (it->second > 0)
+            delta.received += nValue;
+    }
+
+    for (std::map<std::pair<unsigned int, uint256>, CAddressBalanceValue>::const_iterator it=deltas.begin(); it!=deltas.end(); it++) {
+        const auto key = std::make_pair(DB_ADDRESSBALANCE, CAddressIndexIteratorKey(it->first.first, it->first.second));
+        // An address without a balance entry has a null balance
+        CAddressBalanceValue value;
+        Read(key, value);
+        value.balance += it->second.balance;
+        value.received += it->second.received;
+        if (value.IsNull()) {
+            batch.Erase(key);
+        } else {
+            batch.Write(key, value);
+        }
+    }
+    return true;
+}
+
+bool AddressIndex::DB::WriteEntries(CDBBatch& batch, const BlockEntries& entries, bool fErase)
+{
+    if (!UpdateAddressBalances(batch, entries.addressIndex, fErase))
+        return false;
+
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=entries.addressIndex.begin(); it!=entries.addressIndex.end(); it++) {
+        if (fErase) {
+            batch.Erase(std::make_pair(DB_ADDRESSINDEX, it->first));
+        } else {
+            batch.Write(std::make_pair(DB_ADDRESSINDEX, it->first), it->second);
+        }
+    }
+
+    for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=entries.addressUnspentIndex.begin(); it!=entries.addressUnspentIndex.end(); it++) {
+        if (it->second.IsNull()) {
+            batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, it->first));
+        } else {
+            batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, it->first), it->second);
+        }
+    }
+
+    for (std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >::const_iterator it=entries.spentIndex.begin(); it!=entries.spentIndex.end(); it++) {
+        if (it->second.IsNull()) {
+            batch.Erase(std::make_pair(DB_SPENTINDEX, it->first));
+        } else {
+            batch.Write(std::make_pair(DB_SPENTINDEX, it->first), it->second);
+        }
+    }
+    return true;
+}
+
+bool AddressIndex::DB::ReadTimestampBlockIndex(const uint256 &hash, unsigned int &ltimestamp) const
+{
+    CTimestampBlockIndexValue lts;
+    if (!Read(std::make_pair(DB_BLOCKHASHINDEX, hash), lts))
+       return false;
+
+    ltimestamp = lts.ltimestamp;
+    return true;
+}
+
+bool AddressIndex::DB::EraseAllEntries()
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    CDBBatch batch(*this);
+
+    if (!EraseEntries<CAddressIndexKey>(*this, *pcursor, batch, DB_ADDRESSINDEX) ||
+        !EraseEntries<CAddressIndexIteratorKey>(*this, *pcursor, batch, DB_ADDRESSBALANCE) ||
+        !EraseEntries<CAddressUnspentKey>(*this, *pcursor, batch, DB_ADDRESSUNSPENTINDEX) ||
+        !EraseEntries<CSpentIndexKey>(*this, *pcursor, batch, DB_SPENTINDEX) ||
+        !EraseEntries<CTimestampIndexKey>(*this, *pcursor, batch, DB_TIMESTAMPINDEX) ||
+        !EraseEntries<CTimestampBlockIndexKey>(*this, *pcursor, batch, DB_BLOCKHASHINDEX)) {
+        return false;
+    }
+
+    return WriteBatch(batch);
+}
+
+bool AddressIndex::DB::CopyLegacyEntries(CDBWrapper& db, CDBBatch& batch)
+{
+    // The block index database used the same keys. The balances were not kept by all the older
+    // versions, they are summed from the entries, which are ordered by address.
+    std::pair<unsigned int, uint256> address;
+    CAddressBalanceValue balance;
+    auto writeBalance = [&] {
+        if (!balance.IsNull()) {
+            batch.Write(std::make_pair(DB_ADDRESSBALANCE, CAddressIndexIteratorKey(address.first, address.second)), balance);
+        }
+    };
+    std::function<void(const CAddressIndexKey&, const CAmount&)> sumBalance = [&](const CAddressIndexKey& key, const CAmount& value) {
+        if (key.type != address.first || key.hashBytes != address.second) {
+            writeBalance();
+            address = std::make_pair(key.type, key.hashBytes);
+            balance.SetNull();
+        }
+        balance.balance += value;
+        if (value > 0)
+            balance.received += value;
+    };
+
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    if (!CopyEntries<CAddressIndexKey, CAmount>(*this, *pcursor, batch, DB_ADDRESSINDEX, sumBalance) ||
+        !CopyEntries<CAddressUnspentKey, CAddressUnspentValue>(*this, *pcursor, batch, DB_ADDRESSUNSPENTINDEX) ||
+        !CopyEntries<CSpentIndexKey, CSpentIndexValue>(*this, *pcursor, batch, DB_SPENTINDEX) ||
+        !CopyEntries<CTimestampIndexKey, int>(*this, *pcursor, batch, DB_TIMESTAMPINDEX) ||
+        !CopyEntries<CTimestampBlockIndexKey, CTimestampBlockIndexValue>(*this, *pcursor, batch, DB_BLOCKHASHINDEX)) {
+        return false;
+    }
+    writeBalance();
+    return true;
+}
+
+AddressIndex::AddressIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(std::make_unique<AddressIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+AddressIndex::~AddressIndex() {}
+
+bool AddressIndex::Init()
+{
+    // The balances are sums over the entries, so a build starting from genesis must not add up
+    // the entries left by a build that was interrupted before it recorded its best block.
+    CBlockLocator locator;
+    if ((!m_db->ReadBestBlock(locator) || locator.IsNull()) && !m_db->EraseAllEntries()) {
+        return error("%s: failed to erase the entries of an interrupted build", __func__);
+    }
+
+    return BaseIndex::Init();
+}
+
+bool AddressIndex::ImportLegacyIndex(CDBWrapper& db, const CBlockLocator& locator)
+{
+    LogPrintf("Moving the address index from the block index database to indexes/addressindex...\n");
+
+    // An import that was interrupted is started again
+    CDBBatch batch(*m_db);
+    if (!m_db->EraseAllEntries() || !m_db->CopyLegacyEntries(db, batch)) {
+        return error("%s: failed to copy the address index entries", __func__);
+    }
+    m_db->WriteBestBlock(batch, locator);
+    return m_db->WriteBatch(batch, true);
+}
+
+bool AddressIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    // The outputs of the genesis block are not spendable, it has no entries
+    if (pindex->nHeight == 0) {
+        return true;
+    }
+
+    // The entries of a block are written in the batch of its logical timestamp. A block written
+    // again after an unclean shutdown is skipped, so its entries are not counted twice in the balances.
+    unsigned int blockLogicalTS;
+    if (m_db->ReadTimestampBlockIndex(pindex->GetBlockHash(), blockLogicalTS)) {
+        return true;
+    }
+
+    CBlockUndo blockUndo;
+    if (!UndoReadFromDisk(blockUndo, pindex)) {
+        return error("%s: failed to read undo data of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+
+    BlockEntries entries;
+    GetBlockEntries(block, blockUndo, pindex, false, entries);
+
+    CDBBatch batch(*m_db);
+    if (!m_db->WriteEntries(batch, entries, false)) {
+        return false;
+    }
+
+    // The logical timestamps of the blocks are increasing, even when their timestamps are not
+    unsigned int logicalTS = pindex->nTime;
+    unsigned int prevLogicalTS = 0;
+    if (pindex->pprev && pindex->pprev->nHeight > 0 && !m_db->ReadTimestampBlockIndex(pindex->pprev->GetBlockHash(), prevLogicalTS)) {
+        LogPrintf("%s: Failed to read previous block's logical timestamp\n", __func__);
+    }
+    if (logicalTS <= prevLogicalTS) {
+        logicalTS = prevLogicalTS + 1;
+        LogPrint(BCLog::INDEX, "%s: Previous logical timestamp is newer Actual[%d] prevLogical[%d] Logical[%d]\n", __func__, pindex->nTime, prevLogicalTS, logicalTS);
+    }
+    batch.Write(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexKey(logicalTS, pindex->GetBlockHash())), 0);
+    batch.Write(std::make_pair(DB_BLOCKHASHINDEX, CTimestampBlockIndexKey(pindex->GetBlockHash())), CTimestampBlockIndexValue(logicalTS));
+
+    return m_db->WriteBatch(batch);
+}
+
+bool AddressIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    const Consensus::Params& consensus_params = Params().GetConsensus();
+    for (const CBlockIndex* pindex = current_tip; pindex != new_tip; pindex = pindex->pprev) {
+        // Only the blocks with a logical timestamp have their entries in the index
+        unsigned int logicalTS;
+        if (!m_db->ReadTimestampBlockIndex(pindex->GetBlockHash(), logicalTS)) {
+            continue;
+        }
+
+        CBlock block;
+        CBlockUndo blockUndo;
+        if (!ReadBlockFromDisk(block, pindex, consensus_params) || !UndoReadFromDisk(blockUndo, pindex)) {
+            return error("%s: failed to read block %s from disk", __func__, pindex->GetBlockHash().ToString());
+        }
+
+        BlockEntries entries;
+        GetBlockEntries(block, blockUndo, pindex, true, entries);
+
+        CDBBatch batch(*m_db);
+        if (!m_db->WriteEntries(batch, entries, true)) {
+            return false;
+        }
+        batch.Erase(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexKey(logicalTS, pindex->GetBlockHash())));
+        batch.Erase(std::make_pair(DB_BLOCKHASHINDEX, CTimestampBlockIndexKey(pindex->GetBlockHash())));
+        if (!m_db->WriteBatch(batch)) {
+            return error("%s: failed to rewind block %s", __func__, pindex->GetBlockHash().ToString());
+        }
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+BaseIndex::DB& AddressIndex::GetDB() const { return *m_db; }
+
+bool AddressIndex::ReadAddressIndex(uint256 addressHash, int type,
+                                    std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                                    int start, int end) const
+{
+    std::unique_ptr<CDBIterator> pcursor(m_db->NewIterator());
+
+    if (start > 0 && end > 0) {
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, start)));
+    } else {
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey(type, addressHash)));
+    }
+
+    while (pcursor->Valid()) {
+        std::pair<char,CAddressIndexKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX && key.second.hashBytes == addressHash) {
+            if (end > 0 && key.second.blockHeight > end) {
+                break;
+            }
+            CAmount nValue;
+            if (pcursor->GetValue(nValue)) {
+                addressIndex.push_back(std::make_pair(key.second, nValue));
+                pcursor->Next();
+            } else {
+                return error("failed to get address index value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
+std::unique_ptr<CAddressIndexCursor> AddressIndex::AddressIndexCursor(uint256 addressHash, int type, int start, int end, bool fReverse) const
+{
+    auto i = std::make_unique<CAddressIndexCursor>(m_db->NewIterator(), addressHash, type, start, end, fReverse);
+    if (!fReverse) {
+        i->pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, std::max(start, 0))));
+    } else {
+        // Step back from the first key past the range, a height of -1 is serialized after all the others
+        i->pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, end > 0 ? end + 1 : -1)));
+        if (i->pcursor->Valid()) {
+            i->pcursor->Prev();
+        } else {
+            i->pcursor->SeekToLast();
+        }
+    }
+    i->ReadEntry();
+    return i;
+}
+
+CAddressIndexCursor::CAddressIndexCursor(CDBIterator* pcursorIn, uint256 addressHashIn, int typeIn, int startIn, int endIn, bool fReverseIn) :
+    pcursor(pcursorIn), addressHash(addressHashIn), type(typeIn), start(startIn), end(endIn), fReverse(fReverseIn), fValid(false), value(0) {}
+
+void CAddressIndexCursor::ReadEntry()
+{
+    fValid = false;
+    std::pair<uint8_t, CAddressIndexKey> entry;
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) || entry.first != DB_ADDRESSINDEX ||
+        entry.second.type != type || entry.second.hashBytes != addressHash) {
+        return;
+    }
+    if (fReverse ? (start > 0 && entry.second.blockHeight < start) : (end > 0 && entry.second.blockHeight > end)) {
+        return;
+    }
+    if (!pcursor->GetValue(value)) {
+        error("%s: failed to read address index value", __func__);
+        return;
+    }
+    key = entry.second;
+    fValid = true;
+}
+
+void CAddressIndexCursor::Next()
+{
+    if (fReverse) {
+        pcursor->Prev();
+    } else {
+        pcursor->Next();
+    }
+    ReadEntry();
+}
+
+bool AddressIndex::ReadAddressBalance(uint256 addressHash, int type, CAddressBalanceValue& value) const
+{
+    value.SetNull();
+    const auto key = std::make_pair(DB_ADDRESSBALANCE, CAddressIndexIteratorKey(type, addressHash));
+    // An address without any entry in the index has no balance
+    return !m_db->Exists(key) || m_db->Read(key, value);
+}
+
+bool AddressIndex::ReadAddressUnspentIndex(uint256 addressHash, int type,
+                                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs) const
+{
+    std::unique_ptr<CDBIterator> pcursor(m_db->NewIterator());
+    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorKey(type, addressHash)));
+
+    while (pcursor->Valid()) {
+        std::pair<char,CAddressUnspentKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSUNSPENTINDEX && key.second.hashBytes == addressHash) {
+            CAddressUnspentValue nValue;
+            if (pcursor->GetValue(nValue)) {
+                unspentOutputs.push_back(std::make_pair(key.second, nValue));
+                pcursor->Next();
+            } else {
+                return error("failed to get address unspent value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool AddressIndex::ReadSpentIndex(const CSpentIndexKey &key, CSpentIndexValue &value) const
+{
+    return m_db->Read(std::make_pair(DB_SPENTINDEX, key), value);
+}
+
+bool AddressIndex::ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes, ChainstateManager &chainman) const
+{
+    std::unique_ptr<CDBIterator> pcursor(m_db->NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexIteratorKey(low)));
+
+    while (pcursor->Valid()) {
+        std::pair<char, CTimestampIndexKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_TIMESTAMPINDEX && key.second.timestamp < high) {
+            if (fActiveOnly) {
+                LOCK(cs_main);
+                const CBlockIndex* pblockindex = chainman.m_blockman.LookupBlockIndex(key.second.blockHash);
+                if (pblockindex && chainman.ActiveChain().Contains(pblockindex)) {
+                    hashes.push_back(std::make_pair(key.second.blockHash, key.second.timestamp));
+                }
+            } else {
+                hashes.push_back(std::make_pair(key.second.blockHash, key.second.timestamp));
+            }
+
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2026 The Revo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef REVO_INDEX_ADDRESSINDEX_H
+#define REVO_INDEX_ADDRESSINDEX_H
+
+#include <amount.h>
+#include <index/base.h>
+#include <txdb.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class ChainstateManager;
+
+/** Iterates over the address index entries of an address within a range of heights, oldest or newest first */
+class CAddressIndexCursor
+{
+public:
+    // Use AddressIndex::AddressIndexCursor(), which positions the cursor on the first entry
+    CAddressIndexCursor(CDBIterator* pcursorIn, uint256 addressHashIn, int typeIn, int startIn, int endIn, bool fReverseIn);
+
+    bool Valid() const { return fValid; }
+    const CAddressIndexKey& GetKey() const { return key; }
+    CAmount GetValue() const { return value; }
+    void Next();
+
+private:
+    /** Read the entry under the iterator, or stop when it is past the range */
+    void ReadEntry();
+
+    std::unique_ptr<CDBIterator> pcursor;
+    uint256 addressHash;
+    unsigned int type;
+    int start;
+    int end;
+    bool fReverse;
+
+    bool fValid;
+    CAddressIndexKey key;
+    CAmount value;
+
+    friend class AddressIndex;
+};
+
+/**
+ * AddressIndex maintains the indexes of the block explorer RPCs (-addrindex): the balance
+ * changes of every address with their sums, the unspent outputs of every address, the input
+ * spending every output and the blocks by logical timestamp. The entries of a block are
+ * computed from the block and its undo data, so they are computed again to rewind the index
+ * on a reorg. The entries of a block are written with its logical timestamp, which tells
+ * whether the block is in the index, so the sums never count a block twice.
+ */
+class AddressIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+protected:
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "addressindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit AddressIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~AddressIndex() override;
+
+    /// Copy the entries written by older versions to the block index database db, which were
+    /// indexed up to the locator. Must be called before the index is started.
+    bool ImportLegacyIndex(CDBWrapper& db, const CBlockLocator& locator);
+
+    /// Read the balance changes of an address, between the heights start and end if both are set.
+    bool ReadAddressIndex(uint256 addressHash, int type,
+                          std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                          int start = 0, int end = 0) const;
+
+    /// Iterate over the balance changes of an address from start to end, or from end to start if fReverse. Zero heights are unbounded.
+    std::unique_ptr<CAddressIndexCursor> AddressIndexCursor(uint256 addressHash, int type, int start = 0, int end = 0, bool fReverse = false) const;
+
+    /// Read the sums of the balance changes of an address.
+    bool ReadAddressBalance(uint256 addressHash, int type, CAddressBalanceValue& value) const;
+
+    bool ReadAddressUnspentIndex(uint256 addressHash, int type,
+                                 std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs) const;
+
+    bool ReadSpentIndex(const CSpentIndexKey &key, CSpentIndexValue &value) const;
+
+    /// Read the blocks with a logical timestamp from low to high, excluded, only those of the active chain if fActiveOnly.
+    bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes, ChainstateManager &chainman) const;
+};
+
+/// The global address index, used by the block explorer RPCs. May be null.
+extern std::unique_ptr<AddressIndex> g_address_index;
+
+#endif // REVO_INDEX_ADDRESSINDEX_H
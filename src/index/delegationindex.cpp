@@ -0,0 +1,255 @@
+// Copyright (c) 2026 The Revo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/delegationindex.h>
+
+#include <chainparams.h>
+#include <libethcore/LogEntry.h>
+#include <util/convert.h>
+#include <validation.h>
+
+constexpr uint8_t DB_DELEGATION{'d'};
+constexpr uint8_t DB_STAKER_DELEGATION{'s'};
+constexpr uint8_t DB_BLOCK_UNDO{'u'};
+constexpr uint8_t DB_RESYNC{'r'};
+
+std::unique_ptr<DelegationIndex> g_delegation_index;
+
+/** Previous delegations of the delegates changed by a block, a null delegation means none */
+using DelegationUndo = std::vector<std::pair<uint160, Delegation>>;
+
+/** Access to the delegation index database (indexes/delegationindex/) */
+class DelegationIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    bool ReadDelegation(const uint160& delegate, Delegation& delegation) const;
+
+    bool ReadStakerDelegations(const uint160& staker, std::map<uint160, Delegation>& delegations);
+
+    bool ReadDelegations(const IDelegationFilter& filter, std::map<uint160, Delegation>& delegations);
+
+    /// Replace the delegation of a delegate, a null delegation removes it.
+    void WriteDelegation(CDBBatch& batch, const uint160& delegate, const Delegation& oldDelegation, const Delegation& newDelegation);
+
+    /// Erase all delegations and undo data, and the best block so that the index is built again.
+    bool EraseAll();
+};
+
+DelegationIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "delegationindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool DelegationIndex::DB::ReadDelegation(const uint160& delegate, Delegation& delegation) const
+{
+    return Read(std::make_pair(DB_DELEGATION, delegate), delegation);
+}
+
+bool DelegationIndex::DB::ReadStakerDelegations(const uint160& staker, std::map<uint160, Delegation>& delegations)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(DB_STAKER_DELEGATION, std::make_pair(staker, uint160())));
+
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, std::pair<uint160, uint160>> key;
+        if (!pcursor->GetKey(key) || key.first != DB_STAKER_DELEGATION || key.second.first != staker) {
+            break;
+        }
+        Delegation delegation;
+        if (!pcursor->GetValue(delegation)) {
+            return error("%s: failed to read delegation of %s", __func__, key.second.second.GetReverseHex());
+        }
+        delegations[key.second.second] = delegation;
+        pcursor->Next();
+    }
+    return true;
+}
+
+bool DelegationIndex::DB::ReadDelegations(const IDelegationFilter& filter, std::map<uint160, Delegation>& delegations)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(DB_DELEGATION);
+
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, uint160> key;
+        if (!pcursor->GetKey(key) || key.first != DB_DELEGATION) {
+            break;
+        }
+        DelegationEvent event;
+        event.type = DELEGATION_ADD;
+        if (!pcursor->GetValue(static_cast<Delegation&>(event.item))) {
+            return error("%s: failed to read delegation of %s", __func__, key.second.GetReverseHex());
+        }
+        event.item.delegate = key.second;
+        if (filter.Match(event)) {
+            delegations[key.second] = event.item;
+        }
+        pcursor->Next();
+    }
+    return true;
+}
+
+void DelegationIndex::DB::WriteDelegation(CDBBatch& batch, const uint160& delegate, const Delegation& oldDelegation, const Delegation& newDelegation)
+{
+    if (!oldDelegation.IsNull()) {
+        batch.Erase(std::make_pair(DB_STAKER_DELEGATION, std::make_pair(oldDelegation.staker, delegate)));
+    }
+    if (newDelegation.IsNull()) {
+        batch.Erase(std::make_pair(DB_DELEGATION, delegate));
+    } else {
+        batch.Write(std::make_pair(DB_DELEGATION, delegate), newDelegation);
+        batch.Write(std::make_pair(DB_STAKER_DELEGATION, std::make_pair(newDelegation.staker, delegate)), newDelegation);
+    }
+}
+
+/** Erase the entries with a prefix and keys of type K */
+template <typename K>
+static void EraseEntries(CDBIterator& cursor, CDBBatch& batch, uint8_t prefix)
+{
+    cursor.Seek(prefix);
+    while (cursor.Valid()) {
+        std::pair<uint8_t, K> key;
+        if (!cursor.GetKey(key) || key.first != prefix) {
+            break;
+        }
+        batch.Erase(key);
+        cursor.Next();
+    }
+}
+
+bool DelegationIndex::DB::EraseAll()
+{
+    CDBBatch batch(*this);
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    EraseEntries<uint160>(*pcursor, batch, DB_DELEGATION);
+    EraseEntries<std::pair<uint160, uint160>>(*pcursor, batch, DB_STAKER_DELEGATION);
+    EraseEntries<uint256>(*pcursor, batch, DB_BLOCK_UNDO);
+    batch.Erase(DB_RESYNC);
+    WriteBestBlock(batch, CBlockLocator());
+    return WriteBatch(batch, true);
+}
+
+std::vector<DelegationEvent> GetBlockDelegationEvents(const RevoDelegation& revo_delegation, const CBlock& block, const uint256& block_hash)
+{
+    std::vector<DelegationEvent> events;
+    LOCK(cs_main);
+    for (const CTransactionRef& tx : block.vtx) {
+        if (!tx->HasCreateOrCall()) continue;
+        for (const TransactionReceiptInfo& receipt : pstorageresult->getResult(uintToh256(tx->GetHash()))) {
+            if (receipt.blockHash != block_hash) continue;
+            for (const dev::eth::LogEntry& log : receipt.logs) {
+                DelegationEvent event;
+                if (revo_delegation.GetDelegationEvent(log, event)) {
+                    events.push_back(event);
+                }
+            }
+        }
+    }
+    return events;
+}
+
+DelegationIndex::DelegationIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(std::make_unique<DelegationIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+DelegationIndex::~DelegationIndex() {}
+
+bool DelegationIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    const std::vector<DelegationEvent> events = GetBlockDelegationEvents(m_revo_delegation, block, pindex->GetBlockHash());
+
+    // Apply the events, remembering the state of every touched delegate before the block
+    std::map<uint160, Delegation> previous;
+    std::map<uint160, Delegation> current;
+    for (const DelegationEvent& event : events) {
+        const uint160& delegate = event.item.delegate;
+        if (!previous.count(delegate)) {
+            Delegation delegation;
+            m_db->ReadDelegation(delegate, delegation);
+            previous[delegate] = delegation;
+        }
+        if (event.type == DELEGATION_ADD) {
+            current[delegate] = event.item;
+        } else if (event.type == DELEGATION_REMOVE) {
+            current[delegate] = Delegation();
+        }
+    }
+
+    CDBBatch batch(*m_db);
+    DelegationUndo undo;
+    for (const auto& [delegate, delegation] : current) {
+        const Delegation& oldDelegation = previous[delegate];
+        m_db->WriteDelegation(batch, delegate, oldDelegation, delegation);
+        undo.emplace_back(delegate, oldDelegation);
+    }
+    // Also for blocks without delegation changes, a block without undo data can not be rewound
+    batch.Write(std::make_pair(DB_BLOCK_UNDO, pindex->GetBlockHash()), undo);
+
+    // Blocks older than the checkpoint span can not be reorganized, drop their undo data
+    int undo_height = pindex->nHeight - Params().GetConsensus().MaxCheckpointSpan() - 1;
+    if (undo_height >= 0) {
+        batch.Erase(std::make_pair(DB_BLOCK_UNDO, pindex->GetAncestor(undo_height)->GetBlockHash()));
+    }
+
+    return m_db->WriteBatch(batch);
+}
+
+bool DelegationIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    for (const CBlockIndex* pindex = current_tip; pindex != new_tip; pindex = pindex->pprev) {
+        DelegationUndo undo;
+        if (!m_db->Read(std::make_pair(DB_BLOCK_UNDO, pindex->GetBlockHash()), undo)) {
+            // The delegations can not be restored, build the index again on the next start
+            m_db->Write(DB_RESYNC, true);
+            return error("%s: missing undo data of block %s, %s will be rebuilt on restart", __func__, pindex->GetBlockHash().ToString(), GetName());
+        }
+
+        CDBBatch batch(*m_db);
+        for (const auto& [delegate, delegation] : undo) {
+            Delegation currentDelegation;
+            m_db->ReadDelegation(delegate, currentDelegation);
+            m_db->WriteDelegation(batch, delegate, currentDelegation, delegation);
+        }
+        batch.Erase(std::make_pair(DB_BLOCK_UNDO, pindex->GetBlockHash()));
+        if (!m_db->WriteBatch(batch)) {
+            return error("%s: failed to rewind block %s", __func__, pindex->GetBlockHash().ToString());
+        }
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+bool DelegationIndex::Init()
+{
+    // A rewind found the undo data of a block missing, start again from genesis
+    bool resync = false;
+    if (m_db->Read(DB_RESYNC, resync) && resync) {
+        LogPrintf("%s: rebuilding %s\n", __func__, GetName());
+        if (!m_db->EraseAll()) {
+            return error("%s: failed to erase %s", __func__, GetName());
+        }
+    }
+
+    return BaseIndex::Init();
+}
+
+BaseIndex::DB& DelegationIndex::GetDB() const { return *m_db; }
+
+bool DelegationIndex::LookUpDelegation(const uint160& delegate, Delegation& delegation) const
+{
+    return m_db->ReadDelegation(delegate, delegation);
+}
+
+bool DelegationIndex::LookUpDelegationsForStaker(const uint160& staker, std::map<uint160, Delegation>& delegations) const
+{
+    return m_db->ReadStakerDelegations(staker, delegations);
+}
+
+bool DelegationIndex::LookUpDelegations(const IDelegationFilter& filter, std::map<uint160, Delegation>& delegations) const
+{
+    return m_db->ReadDelegations(filter, delegations);
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2026 The Revo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef REVO_INDEX_DELEGATIONINDEX_H
+#define REVO_INDEX_DELEGATIONINDEX_H
+
+#include <index/base.h>
+#include <revo/revodelegation.h>
+
+#include <map>
+#include <vector>
+
+/**
+ * DelegationIndex maintains the current offline staking delegations, built from the
+ * AddDelegation and RemoveDelegation events of the delegation contract. It is keyed both
+ * by delegate (delegate -> staker, fee, PoD) and by staker (staker -> delegates), so that
+ * the delegations of a super staker are read with a single range scan. The previous state
+ * of every delegation changed by a block is kept for the last checkpoint span of blocks
+ * so that the index can be rewound on a reorg. A rewind missing that data fails and the
+ * index is built again on the next start. Requires -logevents.
+ */
+class DelegationIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+    RevoDelegation m_revo_delegation;
+
+protected:
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "delegationindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit DelegationIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~DelegationIndex() override;
+
+    /// Look up the current delegation of a delegate address.
+    bool LookUpDelegation(const uint160& delegate, Delegation& delegation) const;
+
+    /// Look up all current delegations to a staker address, keyed by delegate address.
+    bool LookUpDelegationsForStaker(const uint160& staker, std::map<uint160, Delegation>& delegations) const;
+
+    /// Look up all current delegations matched by a filter, keyed by delegate address.
+    bool LookUpDelegations(const IDelegationFilter& filter, std::map<uint160, Delegation>& delegations) const;
+};
+
+/**
+ * Collect the delegation events of a block in transaction order. A transaction has a receipt for
+ * every block it was mined in, including blocks of stale forks, so only the receipts of the block
+ * with hash block_hash are read.
+ */
+std::vector<DelegationEvent> GetBlockDelegationEvents(const RevoDelegation& revo_delegation, const CBlock& block, const uint256& block_hash);
+
+/// The global delegation index, used by the delegation RPCs. May be null.
+extern std::unique_ptr<DelegationIndex> g_delegation_index;
+
+#endif // REVO_INDEX_DELEGATIONINDEX_H
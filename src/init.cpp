@@ -21,8 +21,10 @@
 #include <hash.h>
 #include <httprpc.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/delegationindex.h>
 #include <index/txindex.h>
 #include <init/common.h>
 #include <interfaces/chain.h>
@@ -72,6 +74,12 @@
 #endif
 #include <walletinitinterface.h>
 #include <key_io.h>
+#include <revo/statepruner.h>
+#include <revo/contractcall.h>
+#include <libevm/AnalysisCache.h>
+#include <libethereum/CodeCache.h>
+#include <libdevcore/DBFactory.h>
+#include <libdevcore/NodeCache.h>
 
 #include <functional>
 #include <set>
@@ -177,6 +185,15 @@ void Interrupt(NodeContext& node)
     if (g_coin_stats_index) {
         g_coin_stats_index->Interrupt();
     }
+    if (g_address_index) {
+        g_address_index->Interrupt();
+    }
+    if (g_delegation_index) {
+        g_delegation_index->Interrupt();
+    }
+    if (g_state_pruner) {
+        g_state_pruner->Interrupt();
+    }
 }
 
 void Shutdown(NodeContext& node)
@@ -207,6 +224,7 @@ void Shutdown(NodeContext& node)
     StopREST();
     StopRPC();
     StopHTTPServer();
+    g_contract_caller.Stop();
     for (const auto& client : node.chain_clients) {
         client->flush();
     }
@@ -262,6 +280,18 @@ void Shutdown(NodeContext& node)
         g_coin_stats_index->Stop();
         g_coin_stats_index.reset();
     }
+    if (g_address_index) {
+        g_address_index->Stop();
+        g_address_index.reset();
+    }
+    if (g_delegation_index) {
+        g_delegation_index->Stop();
+        g_delegation_index.reset();
+    }
+    if (g_state_pruner) {
+        g_state_pruner->Stop();
+        g_state_pruner.reset();
+    }
     ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Stop(); });
     DestroyAllBlockFilterIndexes();
 
@@ -281,6 +311,10 @@ void Shutdown(NodeContext& node)
         }
         pblocktree.reset();
         pstorageresult.reset();
+        pstatejournal.reset();
+        if (globalState && dev::eth::StateSnapshot::instance().isOpen()) {
+            dev::eth::StateSnapshot::instance().close(globalState->rootHash());
+        }
         globalState.reset();
         globalSealEngine.reset();
     }
@@ -405,6 +439,8 @@ void SetupServerArgs(ArgsManager& argsman)
     argsman.AddArg("-datadir=<dir>", "Specify data directory", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (%d to %d, default: %d). In addition, unused mempool memory is shared for this cache (see -maxmempool).", nMinDbCache, nMaxDbCache, nDefaultDbCache), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-evmcodecache=<n>", strprintf("Maximum size of the cache of EVM contract code in MiB, 0 to disable (default: %u)", dev::eth::CodeCache::c_defaultMaxUsage >> 20), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-evmanalysiscache=<n>", strprintf("Maximum size of the cache of EVM contract code analyses in MiB, 0 to disable (default: %u)", dev::eth::AnalysisCache::c_defaultMaxUsage >> 20), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-loadblock=<file>", "Imports blocks from external file on startup", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -435,6 +471,14 @@ void SetupServerArgs(ArgsManager& argsman)
                  strprintf("Maintain an index of compact filters by block (default: %s, values: %s).", DEFAULT_BLOCKFILTERINDEX, ListBlockFilterTypes()) +
                  " If <type> is not supplied or if <type> = 1, indexes for all known types are enabled.",
                  ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-delegationindex", strprintf("Maintain an index of the offline staking delegations, used by the getdelegationsforstaker rpc call, requires -logevents (default: %u)", DEFAULT_DELEGATIONINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-prunestate=<n>", strprintf("Delete the contract state trie nodes which are not reachable from the state of the last <n> blocks, in the background. The contract state of older blocks is not available anymore. Only the nodes written while -statejournal is enabled are deleted, requires -statejournal. The state of at least max(-checkblocks, %u) blocks is kept. (default: 0 = disabled, >=%u = number of blocks to keep)", MIN_BLOCKS_TO_KEEP, defaultChainParams->GetConsensus().MaxCheckpointSpan()), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-statebatch=<n>", strprintf("Maximum size in MiB of the contract state kept in memory across blocks during initial block download, 0 writes it at the end of every block (default: %u)", DEFAULT_STATE_BATCH), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-statecache=<n>", strprintf("Maximum size in MiB of the contract state trie nodes and database blocks cached in memory, 0 to disable (default: %u)", DEFAULT_STATE_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-statesnapshot", strprintf("Maintain a flat snapshot of the contract accounts and storage, used to read the contract state without walking the state trie (default: %u)", DEFAULT_STATESNAPSHOT), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-statejournal", strprintf("Maintain a journal of the contract state trie nodes touched by each block, needed to prune the contract state (default: %u)", DEFAULT_STATEJOURNAL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-receiptcache=<n>", strprintf("Number of transactions whose decoded contract receipts are kept in memory, used by the gettransactionreceipt and searchlogs rpc calls (default: %u)", DEFAULT_RECEIPT_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-receiptdbcache=<n>", strprintf("Size of the cache of the contract receipt database in MiB (default: %u)", DEFAULT_RECEIPT_DB_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-logevents", strprintf("Maintain a full EVM log index, used by searchlogs and gettransactionreceipt rpc calls (default: %u)", DEFAULT_LOGEVENTS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-addrindex", strprintf("Maintain a full address index (default: %u)", DEFAULT_ADDRINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-deleteblockchaindata", "Delete the local copy of the block chain data", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -508,22 +552,26 @@ void SetupServerArgs(ArgsManager& argsman)
     argsman.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequence=<address>", "Enable publish hash block and tx sequence in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubcontractlog=<address>", "Enable publish contract log entries in <address>, requires -logevents", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashblockhwm=<n>", strprintf("Set publish hash block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashtxhwm=<n>", strprintf("Set publish hash transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawblockhwm=<n>", strprintf("Set publish raw block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtxhwm=<n>", strprintf("Set publish raw transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequencehwm=<n>", strprintf("Set publish hash sequence message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubcontractloghwm=<n>", strprintf("Set publish contract log outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
     hidden_args.emplace_back("-zmqpubrawblock=<address>");
     hidden_args.emplace_back("-zmqpubrawtx=<address>");
     hidden_args.emplace_back("-zmqpubsequence=<n>");
+    hidden_args.emplace_back("-zmqpubcontractlog=<address>");
     hidden_args.emplace_back("-zmqpubhashblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubhashtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubsequencehwm=<n>");
+    hidden_args.emplace_back("-zmqpubcontractloghwm=<n>");
 #endif
 
     argsman.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -582,10 +630,12 @@ void SetupServerArgs(ArgsManager& argsman)
 
     argsman.AddArg("-staker-min-tx-gas-price=<amt>", "Any contract execution with a gas price below this will not be included in a block (defaults to the value specified by the DGP)", ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     argsman.AddArg("-staker-max-tx-gas-limit=<n>", "Any contract execution with a gas limit over this amount will not be included in a block (defaults to soft block gas limit)", ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
+    argsman.AddArg("-staker-contract-cache=<n>", strprintf("Keep the executions of up to <n> contract transactions to reuse them in the next block templates, 0 to disable (default: %u)", DEFAULT_STAKER_CONTRACT_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     argsman.AddArg("-staker-soft-block-gas-limit=<n>", "After this amount of gas is surpassed in a block, no more contract executions will be added to the block (defaults to consensus-critical maximum block gas limit)", ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     argsman.AddArg("-aggressive-staking", "Check more often to publish immediately when valid block is found.", ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     argsman.AddArg("-emergencystaking", "Emergency staking without blockchain synchronization.", ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
 
+    argsman.AddArg("-callcontractthreads=<n>", strprintf("Set the number of threads running read-only contract calls, 0 to run them on the RPC threads (default: %d, maximum: %d)", DEFAULT_CALLCONTRACT_THREADS, MAX_CALLCONTRACT_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rest", strprintf("Accept public REST requests (default: %u)", DEFAULT_REST_ENABLE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcauth=<userpw>", "Username and HMAC-SHA-256 hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcauth. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
@@ -768,6 +818,21 @@ void InitParameterInteraction(ArgsManager& args)
             LogPrintf("%s: parameter interaction: -whitelistforcerelay=1 -> setting -whitelistrelay=1\n", __func__);
     }
 
+    if (args.GetBoolArg("-delegationindex", DEFAULT_DELEGATIONINDEX)) {
+        if (args.SoftSetBoolArg("-logevents", true))
+            LogPrintf("%s: parameter interaction: -delegationindex=1 -> setting -logevents=1\n", __func__);
+    }
+
+    if (args.IsArgSet("-zmqpubcontractlog")) {
+        if (args.SoftSetBoolArg("-logevents", true))
+            LogPrintf("%s: parameter interaction: -zmqpubcontractlog set -> setting -logevents=1\n", __func__);
+    }
+
+    if (args.GetArg("-prunestate", DEFAULT_PRUNESTATE) > 0) {
+        if (args.SoftSetBoolArg("-statejournal", true))
+            LogPrintf("%s: parameter interaction: -prunestate=<n> -> setting -statejournal=1\n", __func__);
+    }
+
 #ifdef ENABLE_WALLET
     // Set the required parameters for super staking
     if(args.GetBoolArg("-superstaking", DEFAULT_SUPER_STAKE))
@@ -1402,6 +1467,9 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         StartScriptCheckWorkerThreads(script_threads);
     }
 
+    int callcontract_threads = std::clamp<int64_t>(args.GetArg("-callcontractthreads", DEFAULT_CALLCONTRACT_THREADS), 0, MAX_CALLCONTRACT_THREADS);
+    g_contract_caller.Start(callcontract_threads);
+
     assert(!node.scheduler);
     node.scheduler = std::make_unique<CScheduler>();
 
@@ -1603,11 +1671,10 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     nTotalCache = std::max(nTotalCache, nMinDbCache << 20); // total cache cannot be less than nMinDbCache
     nTotalCache = std::min(nTotalCache, nMaxDbCache << 20); // total cache cannot be greater than nMaxDbcache
     int64_t nBlockTreeDBCache = std::min(nTotalCache / 8, nMaxBlockDBCache << 20);
-    if (args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX)) {
-        // enable 3/4 of the cache if addressindex and/or spentindex is enabled
-        nBlockTreeDBCache = nTotalCache * 3 / 4;
-    }
     nTotalCache -= nBlockTreeDBCache;
+    // enable 3/4 of the remaining cache for the address index, as it had in the block index database
+    int64_t nAddressIndexCache = args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX) ? nTotalCache * 3 / 4 : 0;
+    nTotalCache -= nAddressIndexCache;
     int64_t nTxIndexCache = std::min(nTotalCache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
     nTotalCache -= nTxIndexCache;
     int64_t filter_index_cache = 0;
@@ -1624,6 +1691,9 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     int64_t nMempoolSizeMax = args.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1f MiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
+    if (args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX)) {
+        LogPrintf("* Using %.1f MiB for address index database\n", nAddressIndexCache * (1.0 / 1024 / 1024));
+    }
     if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
         LogPrintf("* Using %.1f MiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
     }
@@ -1660,6 +1730,7 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                 // fails if it's still open from the previous loop. Close it first:
                 pblocktree.reset();
                 pstorageresult.reset();
+                pstatejournal.reset();
                 globalState.reset();
                 globalSealEngine.reset();
                 pblocktree.reset(new CBlockTreeDB(nBlockTreeDBCache, false, fReset));
@@ -1720,19 +1791,39 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                 const std::string dirRevo(revoStateDir.string());
                 const dev::h256 hashDB(dev::sha3(dev::rlp("")));
                 dev::eth::BaseState existsRevostate = fStatus ? dev::eth::BaseState::PreExisting : dev::eth::BaseState::Empty;
+                // A quarter of the state cache goes to the block caches of the state and UTXO databases,
+                // the rest to the trie node caches in front of them
+                const size_t nStateCache = std::max<int64_t>(0, args.GetArg("-statecache", DEFAULT_STATE_CACHE)) << 20;
+                dev::db::setDatabaseCacheSize(nStateCache / 8);
                 globalState = std::unique_ptr<RevoState>(new RevoState(dev::u256(0), RevoState::openDB(dirRevo, hashDB, dev::WithExisting::Trust), dirRevo, existsRevostate));
+                dev::db::setDatabaseCacheSize(0);
+                if (nStateCache) {
+                    globalState->db().setNodeCache(std::make_shared<dev::NodeCache>(nStateCache * 3 / 8));
+                    globalState->dbUtxo().setNodeCache(std::make_shared<dev::NodeCache>(nStateCache * 3 / 8));
+                }
                 globalSealEngine = std::unique_ptr<dev::eth::SealEngineFace>(cp.createSealEngine());
 
-                pstorageresult.reset(new StorageResults(revoStateDir.string()));
+                pstorageresult.reset(new StorageResults(revoStateDir.string(), GetReceiptDBCacheSize(args), GetReceiptCacheSize(args)));
                 if (fReset) {
                     pstorageresult->wipeResults();
                 }
 
+                if (args.GetBoolArg("-statejournal", DEFAULT_STATEJOURNAL)) {
+                    pstatejournal.reset(new StateJournal(revoStateDir / "journal", 8 << 20, false, fReset));
+                    pstatejournal->Attach(*globalState);
+                }
+
                 fRecordLogOpcodes = args.IsArgSet("-record-log-opcodes");
+                nStateBatchSize = std::max<int64_t>(0, args.GetArg("-statebatch", DEFAULT_STATE_BATCH)) << 20;
+                dev::eth::CodeCache::instance().setMaxUsage(std::max<int64_t>(0, args.GetArg("-evmcodecache", dev::eth::CodeCache::c_defaultMaxUsage >> 20)) << 20);
+                g_contract_exec_cache.SetMaxEntries(std::max<int64_t>(0, args.GetArg("-staker-contract-cache", DEFAULT_STAKER_CONTRACT_CACHE)));
+                dev::eth::AnalysisCache::instance().setMaxUsage(std::max<int64_t>(0, args.GetArg("-evmanalysiscache", dev::eth::AnalysisCache::c_defaultMaxUsage >> 20)) << 20);
                 fIsVMlogFile = fs::exists(gArgs.GetDataDirNet() / "vmExecLogs.json");
 
-                if (fAddressIndex != args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -addrindex");
+                // The address index used to be written to the block index database, it is moved to
+                // its own database when -addrindex is enabled and removed otherwise
+                if (!args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX) && !pblocktree->WipeAddressIndex()) {
+                    strLoadError = _("Error removing the old address index");
                     break;
                 }
 
@@ -1749,6 +1840,12 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                     fLogEvents = false;
                     pblocktree->WriteFlag("logevents", fLogEvents);
                 }
+
+                if (fLogEvents && (!pblocktree->UpgradeAddressHeightIndex() || !pblocktree->UpgradeLogBloomIndex())) {
+                    strLoadError = _("Error upgrading the log events index");
+                    break;
+                }
+
                 ///////////////////////////////////////////////////////////////
 
                 // At this point we're either in reindex or we've loaded a useful
@@ -1821,6 +1918,11 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                 }
                 globalState->db().commit();
                 globalState->dbUtxo().commit();
+
+                if (args.GetBoolArg("-statesnapshot", DEFAULT_STATESNAPSHOT)) {
+                    fs::path snapshotDir = gArgs.GetDataDirNet() / "stateRevo" / "snapshot";
+                    dev::eth::StateSnapshot::instance().open(snapshotDir.string(), globalState->rootHash());
+                }
             }
             ///////////////////////////////////////////////////////////////
 
@@ -1935,6 +2037,53 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         }
     }
 
+    fAddressIndex = args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX);
+    if (fAddressIndex) {
+        g_address_index = std::make_unique<AddressIndex>(nAddressIndexCache, false, fReindex);
+        // The entries written to the block index database by older versions are up to date with the
+        // chain, they are moved rather than built again, which a pruned node could not do
+        bool fHaveLegacyIndex = false;
+        if (pblocktree->ReadFlag("addrindex", fHaveLegacyIndex) && fHaveLegacyIndex) {
+            const CBlockLocator locator = WITH_LOCK(cs_main, return chainman.ActiveChain().GetLocator());
+            if (!g_address_index->ImportLegacyIndex(*pblocktree, locator) || !pblocktree->WipeAddressIndex()) {
+                return InitError(_("Error moving the address index. You need to rebuild the database using -reindex."));
+            }
+        }
+        if (!g_address_index->Start(chainman.ActiveChainstate())) {
+            return false;
+        }
+    }
+
+    if (args.GetBoolArg("-delegationindex", DEFAULT_DELEGATIONINDEX)) {
+        if (!fLogEvents) {
+            return InitError(_("-delegationindex requires -logevents."));
+        }
+        g_delegation_index = std::make_unique<DelegationIndex>(/* cache size */ 0, false, fReindex);
+        if (!g_delegation_index->Start(chainman.ActiveChainstate())) {
+            return false;
+        }
+    }
+
+    int64_t nPruneState = args.GetArg("-prunestate", DEFAULT_PRUNESTATE);
+    if (nPruneState > 0) {
+        if (!pstatejournal) {
+            return InitError(_("-prunestate requires -statejournal."));
+        }
+        if (nPruneState < chainparams.GetConsensus().MaxCheckpointSpan()) {
+            return InitError(strprintf(_("-prunestate must keep at least %d blocks."), chainparams.GetConsensus().MaxCheckpointSpan()));
+        }
+        // Keep the state of the blocks verified at startup and of the blocks a reorg may disconnect
+        const int64_t nMinPruneState = std::max<int64_t>(args.GetArg("-checkblocks", DEFAULT_CHECKBLOCKS), MIN_BLOCKS_TO_KEEP);
+        if (nPruneState < nMinPruneState) {
+            LogPrintf("%s: keeping the contract state of %d blocks instead of -prunestate=%d\n", __func__, nMinPruneState, nPruneState);
+            nPruneState = nMinPruneState;
+        }
+        g_state_pruner = std::make_unique<StatePruner>(chainman, nPruneState);
+        if (!g_state_pruner->Start()) {
+            return InitError(_("Error loading the contract state pruning height."));
+        }
+    }
+
     // ********************************************************* Step 9: load wallet
     for (const auto& client : node.chain_clients) {
         if (!client->load()) {
@@ -8,12 +8,14 @@
 #include <amount.h>
 #include <chain.h>
 #include <chainparams.h>
+#include <checkqueue.h>
 #include <coins.h>
 #include <consensus/consensus.h>
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <deploymentstatus.h>
+#include <index/delegationindex.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <pow.h>
@@ -66,6 +68,106 @@ void updateMinerParams(int nHeight, const Consensus::Params& consensusParams, bo
     }
 }
 
+ContractExecutionCache g_contract_exec_cache;
+
+std::shared_ptr<const ContractExecutionCache::Entry> ContractExecutionCache::Find(const uint256& txid, const CBlock& block, const dev::h256& hashStateRoot, const dev::h256& hashUTXORoot, uint64_t blockGasLimit)
+{
+    LOCK(m_mutex);
+    if (m_tip != block.hashPrevBlock) {
+        // The executions of the previous tip can not be reused on top of a new one
+        m_entries.clear();
+        m_state_nodes.clear();
+        m_utxo_nodes.clear();
+        m_tip = block.hashPrevBlock;
+    }
+
+    auto it = m_entries.find(txid);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    const Entry& entry = *it->second;
+    if (entry.hashStateRoot != hashStateRoot || entry.hashUTXORoot != hashUTXORoot ||
+        entry.blockGasLimit != blockGasLimit || entry.authorScript != AuthorScript(block) ||
+        (entry.contextRead && (entry.nTime != block.nTime || entry.nBits != block.nBits))) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    return it->second;
+}
+
+void ContractExecutionCache::Insert(const uint256& txid, std::shared_ptr<const Entry> entry)
+{
+    LOCK(m_mutex);
+    if (entry->hashPrevBlock != m_tip) {
+        return;
+    }
+    auto it = m_entries.find(txid);
+    if (it != m_entries.end()) {
+        it->second = std::move(entry);
+    } else if (m_entries.size() < m_max_entries) {
+        // Keep the executions found first when full, they are the ones with the best fees
+        m_entries.emplace(txid, std::move(entry));
+    }
+}
+
+void ContractExecutionCache::SetStateNodes(const uint256& hashPrevBlock, dev::OverlayDB::PendingNodes stateNodes, dev::OverlayDB::PendingNodes utxoNodes)
+{
+    LOCK(m_mutex);
+    if (hashPrevBlock != m_tip || m_entries.empty()) {
+        m_state_nodes.clear();
+        m_utxo_nodes.clear();
+        return;
+    }
+    // Every template adds a set of nodes, keep the lookups of the next ones short
+    m_state_nodes = stateNodes.size() > MAX_CACHED_NODE_SETS ? dev::OverlayDB::mergePending(stateNodes) : std::move(stateNodes);
+    m_utxo_nodes = utxoNodes.size() > MAX_CACHED_NODE_SETS ? dev::OverlayDB::mergePending(utxoNodes) : std::move(utxoNodes);
+}
+
+void ContractExecutionCache::GetStateNodes(const uint256& hashPrevBlock, dev::OverlayDB::PendingNodes& stateNodes, dev::OverlayDB::PendingNodes& utxoNodes) const
+{
+    LOCK(m_mutex);
+    if (hashPrevBlock == m_tip) {
+        stateNodes = m_state_nodes;
+        utxoNodes = m_utxo_nodes;
+    }
+}
+
+void ContractExecutionCache::SetMaxEntries(size_t max_entries)
+{
+    LOCK(m_mutex);
+    m_max_entries = max_entries;
+    if (m_entries.size() > m_max_entries) {
+        m_entries.clear();
+        m_state_nodes.clear();
+        m_utxo_nodes.clear();
+    }
+}
+
+void ContractExecutionCache::Clear()
+{
+    LOCK(m_mutex);
+    m_entries.clear();
+    m_state_nodes.clear();
+    m_utxo_nodes.clear();
+}
+
+ContractExecutionCache::Stats ContractExecutionCache::GetStats() const
+{
+    LOCK(m_mutex);
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.entries = m_entries.size();
+    return stats;
+}
+
+const CScript& ContractExecutionCache::AuthorScript(const CBlock& block)
+{
+    return block.IsProofOfStake() ? block.vtx[1]->vout[1].scriptPubKey : block.vtx[0]->vout[0].scriptPubKey;
+}
+
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
 {
     int64_t nOldTime = pblock->nTime;
@@ -146,6 +248,7 @@ void BlockAssembler::resetBlock()
     // These counters do not include coinbase tx
     nBlockTx = 0;
     nFees = 0;
+    nContractFees = 0;
 }
 
 void BlockAssembler::RebuildRefundTransaction(CBlock* pblock){
@@ -271,7 +374,9 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
     //////////////////////////////////////////////////////// revo
     RevoDGP revoDGP(globalState.get(), m_chainstate, fGettingValuesDGP);
-    globalSealEngine->setRevoSchedule(revoDGP.getGasSchedule(nHeight));
+    dev::eth::EVMSchedule schedule = revoDGP.getGasSchedule(nHeight);
+    globalSealEngine->setRevoSchedule(schedule);
+    minContractGas = schedule.txGas;
     uint32_t blockSizeDGP = revoDGP.getBlockSize(nHeight);
     minGasPrice = revoDGP.getMinGasPrice(nHeight);
     if(gArgs.IsArgSet("-staker-min-tx-gas-price")) {
@@ -289,6 +394,16 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     
     dev::h256 oldHashStateRoot(globalState->rootHash());
     dev::h256 oldHashUTXORoot(globalState->rootHashUTXO());
+    // The trie nodes written for the template are dropped afterwards, the cached executions
+    // keep them for the next templates on the same tip
+    const dev::OverlayDB::PendingNodes statePending = globalState->db().pending();
+    const dev::OverlayDB::PendingNodes utxoPending = globalState->dbUtxo().pending();
+    {
+        dev::OverlayDB::PendingNodes stateNodes, utxoNodes;
+        g_contract_exec_cache.GetStateNodes(pindexPrev->GetBlockHash(), stateNodes, utxoNodes);
+        globalState->db().addPending(stateNodes);
+        globalState->dbUtxo().addPending(utxoNodes);
+    }
     ////////////////////////////////////////////////// deploy offline staking contract
     if(nHeight == chainparams.GetConsensus().nOfflineStakeHeight){
         globalState->deployDelegationsContract();
@@ -297,10 +412,17 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
     addPackageTxs(nPackagesSelected, nDescendantsUpdated, minGasPrice, pblock);
+    m_last_block_gas_used = bceResult.usedGas;
+    m_last_block_gas_fees = nContractFees - bceResult.refundSender;
     pblock->hashStateRoot = uint256(h256Touint(dev::h256(globalState->rootHash())));
     pblock->hashUTXORoot = uint256(h256Touint(dev::h256(globalState->rootHashUTXO())));
     globalState->setRoot(oldHashStateRoot);
     globalState->setRootUTXO(oldHashUTXORoot);
+    globalState->db().checkpoint();
+    globalState->dbUtxo().checkpoint();
+    g_contract_exec_cache.SetStateNodes(pindexPrev->GetBlockHash(), globalState->db().pendingSince(statePending), globalState->dbUtxo().pendingSince(utxoPending));
+    globalState->db().rollback(statePending);
+    globalState->dbUtxo().rollback(utxoPending);
 
     //this should already be populated by AddBlock in case of contracts, but if no contracts
     //then it won't get populated
@@ -328,6 +450,11 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     int64_t nTime2 = GetTimeMicros();
 
     LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+    if (LogAcceptCategory(BCLog::BENCH)) {
+        ContractExecutionCache::Stats stats = g_contract_exec_cache.GetStats();
+        LogPrint(BCLog::BENCH, "CreateNewBlock() contract execution cache: %u entries, %u hits, %u misses\n", stats.entries, stats.hits, stats.misses);
+        LogPrint(BCLog::BENCH, "CreateNewBlock() gas: %u used of %u, %.2f satoshis per gas\n", bceResult.usedGas, softBlockGasLimit, bceResult.usedGas ? double(nContractFees - bceResult.refundSender) / bceResult.usedGas : 0.0);
+    }
 
     return std::move(pblocktemplate);
 }
@@ -474,6 +601,26 @@ bool BlockAssembler::TestPackage(uint64_t packageSize, int64_t packageSigOpsCost
     return true;
 }
 
+// Pre-filter the contract transactions of a package before executing them, the trial execution decides:
+// - transactions below the minimum gas price or above the transaction gas limit never fit
+// - every contract output uses at least the base transaction gas, whatever it executes
+bool BlockAssembler::TestPackageGas(const CTxMemPool::setEntries& package, uint64_t minGasPrice) const
+{
+    uint64_t packageGas = 0;
+    for (CTxMemPool::txiter it : package) {
+        const CTransaction& tx = it->GetTx();
+        if (!tx.HasCreateOrCall())
+            continue;
+        if ((uint64_t)it->GetMinGasPrice() < minGasPrice || it->GetGasLimit() > txGasLimit)
+            return false;
+        for (const CTxOut& txout : tx.vout) {
+            if (txout.scriptPubKey.HasOpCreate() || txout.scriptPubKey.HasOpCall())
+                packageGas += minContractGas;
+        }
+    }
+    return bceResult.usedGas + packageGas <= softBlockGasLimit;
+}
+
 // Perform transaction-level checks before adding to block:
 // - transaction finality (locktime)
 // - premature witness (in case segwit transactions are added to mempool before
@@ -505,19 +652,27 @@ bool BlockAssembler::AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64
     uint64_t nBlockWeight = this->nBlockWeight;
     uint64_t nBlockSigOpsCost = this->nBlockSigOpsCost;
 
-    unsigned int contractflags = GetContractScriptFlags(nHeight, chainparams.GetConsensus());
-    RevoTxConverter convert(iter->GetTx(), m_chainstate, &m_mempool, NULL, &pblock->vtx, contractflags);
-
-    ExtractRevoTX resultConverter;
-    if(!convert.extractionRevoTransactions(resultConverter)){
-        //this check already happens when accepting txs into mempool
-        //therefore, this can only be triggered by using raw transactions on the staker itself
-        LogPrintf("AttemptToAddContractToBlock(): Fail to extract contacts from tx %s\n", iter->GetTx().GetHash().ToString());
-        return false;
+    // Reuse the execution of a previous block template when it started from the same state
+    std::shared_ptr<const ContractExecutionCache::Entry> cached = g_contract_exec_cache.Find(iter->GetTx().GetHash(), *pblock, oldHashStateRoot, oldHashUTXORoot, hardBlockGasLimit);
+
+    std::vector<RevoTransaction> revoTransactions;
+    if(cached){
+        revoTransactions = cached->revoTransactions;
+    }else{
+        unsigned int contractflags = GetContractScriptFlags(nHeight, chainparams.GetConsensus());
+        RevoTxConverter convert(iter->GetTx(), m_chainstate, &m_mempool, NULL, &pblock->vtx, contractflags);
+
+        ExtractRevoTX resultConverter;
+        if(!convert.extractionRevoTransactions(resultConverter)){
+            //this check already happens when accepting txs into mempool
+            //therefore, this can only be triggered by using raw transactions on the staker itself
+            LogPrintf("AttemptToAddContractToBlock(): Fail to extract contacts from tx %s\n", iter->GetTx().GetHash().ToString());
+            return false;
+        }
+        revoTransactions = resultConverter.first;
     }
-    std::vector<RevoTransaction> revoTransactions = resultConverter.first;
     dev::u256 txGas = 0;
-    for(RevoTransaction revoTransaction : revoTransactions){
+    for(const RevoTransaction& revoTransaction : revoTransactions){
         txGas += revoTransaction.gas();
         if(txGas > txGasLimit) {
             // Limit the tx gas limit by the soft limit if such a limit has been specified.
@@ -538,22 +693,53 @@ bool BlockAssembler::AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64
             return false;
         }
     }
-    // We need to pass the DGP's block gas limit (not the soft limit) since it is consensus critical.
-    ByteCodeExec exec(*pblock, revoTransactions, hardBlockGasLimit, m_chainstate.m_chain.Tip(), m_chainstate.m_chain);
-    if(!exec.performByteCode()){
-        //error, don't add contract
-        globalState->setRoot(oldHashStateRoot);
-        globalState->setRootUTXO(oldHashUTXORoot);
-        LogPrintf("AttemptToAddContractToBlock(): Perform byte code fails for the contract tx %s\n", iter->GetTx().GetHash().ToString());
-        return false;
-    }
-
     ByteCodeExecResult testExecResult;
-    if(!exec.processingResults(testExecResult)){
-        globalState->setRoot(oldHashStateRoot);
-        globalState->setRootUTXO(oldHashUTXORoot);
-        LogPrintf("AttemptToAddContractToBlock(): Processing results fails for the contract tx %s\n", iter->GetTx().GetHash().ToString());
-        return false;
+    if(cached){
+        testExecResult.usedGas = cached->result.usedGas;
+        testExecResult.refundSender = cached->result.refundSender;
+        testExecResult.refundOutputs = cached->result.refundOutputs;
+        for(const CTransaction& t : cached->result.valueTransfers){
+            testExecResult.valueTransfers.push_back(t);
+        }
+        globalState->setRoot(cached->hashStateRootAfter);
+        globalState->setRootUTXO(cached->hashUTXORootAfter);
+    }else{
+        // We need to pass the DGP's block gas limit (not the soft limit) since it is consensus critical.
+        ByteCodeExec exec(*pblock, revoTransactions, hardBlockGasLimit, m_chainstate.m_chain.Tip(), m_chainstate.m_chain);
+        if(!exec.performByteCode()){
+            //error, don't add contract
+            globalState->setRoot(oldHashStateRoot);
+            globalState->setRootUTXO(oldHashUTXORoot);
+            LogPrintf("AttemptToAddContractToBlock(): Perform byte code fails for the contract tx %s\n", iter->GetTx().GetHash().ToString());
+            return false;
+        }
+
+        if(!exec.processingResults(testExecResult)){
+            globalState->setRoot(oldHashStateRoot);
+            globalState->setRootUTXO(oldHashUTXORoot);
+            LogPrintf("AttemptToAddContractToBlock(): Processing results fails for the contract tx %s\n", iter->GetTx().GetHash().ToString());
+            return false;
+        }
+
+        auto entry = std::make_shared<ContractExecutionCache::Entry>();
+        entry->hashPrevBlock = pblock->hashPrevBlock;
+        entry->hashStateRoot = oldHashStateRoot;
+        entry->hashUTXORoot = oldHashUTXORoot;
+        entry->authorScript = ContractExecutionCache::AuthorScript(*pblock);
+        entry->blockGasLimit = hardBlockGasLimit;
+        entry->contextRead = exec.readBlockContext();
+        entry->nTime = pblock->nTime;
+        entry->nBits = pblock->nBits;
+        entry->revoTransactions = std::move(revoTransactions);
+        entry->result.usedGas = testExecResult.usedGas;
+        entry->result.refundSender = testExecResult.refundSender;
+        entry->result.refundOutputs = testExecResult.refundOutputs;
+        for(const CTransaction& t : testExecResult.valueTransfers){
+            entry->result.valueTransfers.push_back(t);
+        }
+        entry->hashStateRootAfter = globalState->rootHash();
+        entry->hashUTXORootAfter = globalState->rootHashUTXO();
+        g_contract_exec_cache.Insert(iter->GetTx().GetHash(), std::move(entry));
     }
 
     if(bceResult.usedGas + testExecResult.usedGas > softBlockGasLimit){
@@ -618,6 +804,7 @@ bool BlockAssembler::AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64
     ++nBlockTx;
     this->nBlockSigOpsCost += iter->GetSigOpCost();
     nFees += iter->GetFee();
+    nContractFees += iter->GetFee();
     inBlock.insert(iter);
 
     for (CTransaction &t : bceResult.valueTransfers) {
@@ -831,6 +1018,17 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
             continue;
         }
 
+        // Skip packages whose contracts can not fit in the gas left before converting and
+        // executing them, the block gas limit is the second dimension of the block size
+        if (!TestPackageGas(ancestors, minGasPrice)) {
+            if (fUsingModified) {
+                mapModifiedTx.get<ancestor_score_or_gas_price>().erase(modit);
+                failedTx.insert(iter);
+            }
+            ++nConsecutiveFailed;
+            continue;
+        }
+
         // This transaction will make it in; reset the failed counter.
         nConsecutiveFailed = 0;
 
@@ -938,6 +1136,20 @@ public:
 
         return true;
     }
+
+    /** Read the matching delegations from the delegation index, when it has indexed the chain up to nHeight */
+    bool ReadIndexedDelegations(int32_t nHeight, std::map<uint160, Delegation>& delegations) const
+    {
+        if(!g_delegation_index)
+            return false;
+
+        const IndexSummary summary = g_delegation_index->GetSummary();
+        if(!summary.synced || summary.best_block_height < nHeight)
+            return false;
+
+        delegations.clear();
+        return g_delegation_index->LookUpDelegations(*this, delegations);
+    }
 };
 
 class DelegationsStaker : public DelegationFilterBase
@@ -1042,7 +1254,11 @@ public:
 
         std::map<uint160, Delegation> delegations_staker;
         int checkpointSpan = Params().GetConsensus().CheckpointSpan(nHeight);
-        if(nHeight <= checkpointSpan)
+        if(ReadIndexedDelegations(nHeight, delegations_staker))
+        {
+            // The delegation index has the current delegations, no need to search the log events
+        }
+        else if(nHeight <= checkpointSpan)
         {
             // Get delegations from events
             std::vector<DelegationEvent> events;
@@ -1104,7 +1320,11 @@ public:
         {
             // When log events are enabled, search the log events to get complete list of my delegations
             int checkpointSpan = Params().GetConsensus().CheckpointSpan(nHeight);
-            if(nHeight <= checkpointSpan)
+            if(ReadIndexedDelegations(nHeight, pwallet->m_my_delegations))
+            {
+                // The delegation index has the current delegations, no need to search the log events
+            }
+            else if(nHeight <= checkpointSpan)
             {
                 // Get delegations from events
                 std::vector<DelegationEvent> events;
@@ -1320,7 +1540,7 @@ public:
     bool fAggressiveStaking = false;
     bool fError = false;
     int numThreads = 1;
-    boost::thread_group threads;
+    CCheckQueue<CKernelCheck> kernelQueue{16};
     mutable RecursiveMutex cs_worker;
     bool privateKeysDisabled = false;;
 
@@ -1341,6 +1561,7 @@ public:
     std::vector<COutPoint> setSelectedCoins;
     std::vector<COutPoint> setDelegateCoins;
     std::vector<COutPoint> prevouts;
+    std::vector<CStakeKernel> stakeKernels;
     std::map<uint32_t, bool> mapSolveBlockTime;
     std::multimap<uint256, SolveItem> mapSolvedBlock;
     std::map<uint32_t, std::vector<COutPoint>> mapSolveSelectedCoins;
@@ -1384,6 +1605,17 @@ public:
         }
         if(pwallet) numThreads = pwallet->m_num_threads;
         if(pwallet) privateKeysDisabled = pwallet->IsWalletFlagSet(WALLET_FLAG_DISABLE_PRIVATE_KEYS);
+
+        // The staker thread joins the workers while waiting for the kernel search to finish
+        if(numThreads > 1)
+        {
+            kernelQueue.StartWorkerThreads(numThreads - 1, threadName);
+        }
+    }
+
+    ~StakeMinerPriv()
+    {
+        kernelQueue.StopWorkerThreads();
     }
 
     void clearCache()
@@ -1400,6 +1632,7 @@ public:
         setSelectedCoins.clear();
         setDelegateCoins.clear();
         prevouts.clear();
+        stakeKernels.clear();
         mapSolveBlockTime.clear();
         mapSolvedBlock.clear();
         mapSolveSelectedCoins.clear();
@@ -1663,6 +1896,7 @@ protected:
 
             LOCK(cs_main);
             d->pwallet->UpdateMinerStakeCache(true, d->prevouts, d->pindexPrev);
+            PrepareStakeKernels(d->pindexPrev, d->prevouts, d->pwallet->minerStakeCache, d->stakeKernels);
         }
 
         d->beginningTime = GetAdjustedTime();
@@ -1697,50 +1931,34 @@ protected:
         if(searchInterval > 0) d->pwallet->m_last_coin_stake_search_interval = searchInterval;
     }
 
-    void SloveBlock(uint32_t blockTime, size_t delegateSize, size_t from, size_t to)
-    {
-        std::multimap<uint256, SolveItem> tmpSolvedBlock;
-        for(size_t i = from; i < to; i++)
-        {
-            const COutPoint &prevoutStake = d->prevouts[i];
-            uint256 hashProofOfStake;
-            if (CheckKernelCache(d->pindexPrev, d->pblock->nBits, blockTime, prevoutStake, d->pwallet->minerStakeCache, hashProofOfStake))
-            {
-                bool delegate = i < delegateSize;
-                tmpSolvedBlock.insert(std::make_pair(hashProofOfStake, SolveItem(prevoutStake, blockTime, delegate)));
-            }
-        }
-
-        if(tmpSolvedBlock.size() > 0)
-        {
-            LOCK(d->cs_worker);
-            d->mapSolveBlockTime[blockTime] = true;
-            d->mapSolvedBlock.insert(tmpSolvedBlock.begin(), tmpSolvedBlock.end());
-        }
-    }
-
     void SloveBlock(const uint32_t& blockTime)
     {
         // Init variables
         size_t listSize = d->prevouts.size();
         size_t delegateSize = d->setDelegateCoins.size();
-
-        // Solve block
-        int numThreads = std::min(d->numThreads, (int)listSize);
-        if(listSize < 1000 || numThreads < 2)
+        int64_t nStart = GetTimeMicros();
+
+        // Solve block, small lists are not worth waking up the kernel check workers
+        CKernelSearch search(d->pindexPrev, d->pblock->nBits, blockTime, d->stakeKernels, [this]{ return d->pwallet->IsStakeClosing(); });
+        std::vector<std::pair<size_t, uint256>> vSolved;
+        bool fQueue = listSize >= 1000 && d->numThreads > 1;
+        SearchStakeKernels(search, fQueue ? &d->kernelQueue : nullptr, vSolved);
+        if(vSolved.size() > 0)
         {
-            SloveBlock(blockTime, delegateSize, 0, listSize);
-        }
-        else
-        {
-            size_t chunk = listSize / numThreads;
-            for(int i = 0; i < numThreads; i++)
+            LOCK(d->cs_worker);
+            d->mapSolveBlockTime[blockTime] = true;
+            for(const std::pair<size_t, uint256>& solved : vSolved)
             {
-                size_t from = i * chunk;
-                size_t to = i == (numThreads -1) ? listSize : from + chunk;
-                d->threads.create_thread([this, blockTime, delegateSize, from, to]{SloveBlock(blockTime, delegateSize, from, to);});
+                bool delegate = solved.first < delegateSize;
+                d->mapSolvedBlock.insert(std::make_pair(solved.second, SolveItem(d->prevouts[solved.first], blockTime, delegate)));
             }
-            d->threads.join_all();
+        }
+
+        // Update the kernel search speed
+        int64_t nElapsed = GetTimeMicros() - nStart;
+        if(listSize > 0 && nElapsed > 0)
+        {
+            d->pwallet->m_stake_kernels_per_second = listSize * 1000000 / nElapsed;
         }
 
         // Populate the list with the potential solwed blocks
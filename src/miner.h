@@ -10,6 +10,7 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <map>
 #include <memory>
 #include <optional>
 #include <stdint.h>
@@ -67,6 +68,82 @@ static const int32_t DEFAULT_MAX_STAKER_WAIT_FOR_BEST_BLOCK_HEADER = 4000;
 //How much time to spend trying to process transactions when using the generate RPC call
 static const int32_t POW_MINER_MAX_TIME = 60;
 
+//How many contract transaction executions to keep for the next block templates
+static const int64_t DEFAULT_STAKER_CONTRACT_CACHE = 5000;
+
+//How many sets of trie nodes of block templates to keep before merging them
+static const size_t MAX_CACHED_NODE_SETS = 8;
+
+/**
+ * Results of the trial executions of mempool contract transactions done for block templates.
+ * The staker builds a new template for every time slot on the same tip, executing the same
+ * contract transactions again and again. An execution is reused when it starts from the same
+ * state roots on the same tip, paying the same block author, so it leads to the same state roots.
+ * The time and difficulty of the block only have to match when the execution read them.
+ */
+class ContractExecutionCache
+{
+public:
+    struct Entry {
+        //Context of the execution
+        uint256 hashPrevBlock;
+        dev::h256 hashStateRoot;
+        dev::h256 hashUTXORoot;
+        CScript authorScript;
+        uint64_t blockGasLimit = 0;
+        bool contextRead = false;
+        uint32_t nTime = 0;
+        uint32_t nBits = 0;
+
+        //Outcome of the execution
+        std::vector<RevoTransaction> revoTransactions;
+        ByteCodeExecResult result;
+        dev::h256 hashStateRootAfter;
+        dev::h256 hashUTXORootAfter;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+    };
+
+    /** Return the execution of txid which can be reused in block, nullptr if there is none */
+    std::shared_ptr<const Entry> Find(const uint256& txid, const CBlock& block, const dev::h256& hashStateRoot, const dev::h256& hashUTXORoot, uint64_t blockGasLimit);
+
+    /** Store the execution of txid, replacing the previous one */
+    void Insert(const uint256& txid, std::shared_ptr<const Entry> entry);
+
+    /** Keep the trie nodes written by the executions of a block template on top of a tip,
+      * the state after a reused execution is read from them */
+    void SetStateNodes(const uint256& hashPrevBlock, dev::OverlayDB::PendingNodes stateNodes, dev::OverlayDB::PendingNodes utxoNodes);
+
+    /** Get the trie nodes kept for the block templates on top of a tip */
+    void GetStateNodes(const uint256& hashPrevBlock, dev::OverlayDB::PendingNodes& stateNodes, dev::OverlayDB::PendingNodes& utxoNodes) const;
+
+    /** Set the maximum number of executions kept, 0 disables the cache */
+    void SetMaxEntries(size_t max_entries);
+
+    void Clear();
+
+    Stats GetStats() const;
+
+    /** Script paying the block author, which the EVM gets the coinbase address from */
+    static const CScript& AuthorScript(const CBlock& block);
+
+private:
+    mutable Mutex m_mutex;
+    uint256 m_tip GUARDED_BY(m_mutex);
+    std::map<uint256, std::shared_ptr<const Entry>> m_entries GUARDED_BY(m_mutex);
+    dev::OverlayDB::PendingNodes m_state_nodes GUARDED_BY(m_mutex);
+    dev::OverlayDB::PendingNodes m_utxo_nodes GUARDED_BY(m_mutex);
+    size_t m_max_entries GUARDED_BY(m_mutex){DEFAULT_STAKER_CONTRACT_CACHE};
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+    uint64_t m_misses GUARDED_BY(m_mutex){0};
+};
+
+extern ContractExecutionCache g_contract_exec_cache;
+
 struct CBlockTemplate
 {
     CBlock block;
@@ -240,6 +317,7 @@ private:
     uint64_t nBlockTx;
     uint64_t nBlockSigOpsCost;
     CAmount nFees;
+    CAmount nContractFees;
     CTxMemPool::setEntries inBlock;
 
     // Chain context for the block
@@ -271,6 +349,7 @@ public:
     uint64_t hardBlockGasLimit;
     uint64_t softBlockGasLimit;
     uint64_t txGasLimit;
+    uint64_t minContractGas = 0;
 /////////////////////////////////////////////
 
     // The original constructed reward tx (either coinbase or coinstake) without gas refund adjustments
@@ -285,6 +364,8 @@ public:
 
     inline static std::optional<int64_t> m_last_block_num_txs{};
     inline static std::optional<int64_t> m_last_block_weight{};
+    inline static std::optional<uint64_t> m_last_block_gas_used{};
+    inline static std::optional<CAmount> m_last_block_gas_fees{};
 
 private:
     // utility functions
@@ -308,6 +389,9 @@ private:
     void onlyUnconfirmed(CTxMemPool::setEntries& testSet);
     /** Test if a new package would "fit" in the block */
     bool TestPackage(uint64_t packageSize, int64_t packageSigOpsCost) const;
+    /** Test if the contract transactions of a package could "fit" in the gas left in the block,
+      * using the minimum gas they can use */
+    bool TestPackageGas(const CTxMemPool::setEntries& package, uint64_t minGasPrice) const;
     /** Perform checks on each transaction in a package:
       * locktime, premature-witness, serialized size (if necessary)
       * These checks should always succeed, and they're here
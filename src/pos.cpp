@@ -14,6 +14,7 @@
 #include <chainparams.h>
 #include <script/sign.h>
 #include <consensus/consensus.h>
+#include <crypto/common.h>
 #include <util/signstr.h>
 #include <revo/revodelegation.h>
 #include <script/standard.h>
@@ -482,6 +483,137 @@ void CacheKernel(std::map<COutPoint, CStakeCache>& cache, const COutPoint& prevo
     cache.insert({prevout, c});
 }
 
+CStakeKernel::CStakeKernel(const uint256& nStakeModifier, const COutPoint& prevout_, const CStakeCache& stake):
+    valid(true),
+    prevout(prevout_),
+    blockFromTime(stake.blockFromTime),
+    amount(stake.amount)
+{
+    // Same serialization as in CheckStakeKernelHash(): modifier, block from time, prevout, block time
+    unsigned char head[64];
+    memcpy(head, nStakeModifier.begin(), 32);
+    WriteLE32(head + 32, blockFromTime);
+    memcpy(head + 36, prevout.hash.begin(), 28);
+    midstate.Write(head, sizeof(head));
+
+    memcpy(tail, prevout.hash.begin() + 28, 4);
+    WriteLE32(tail + 4, prevout.n);
+}
+
+void PrepareStakeKernels(CBlockIndex* pindexPrev, const std::vector<COutPoint>& prevouts, const std::map<COutPoint, CStakeCache>& cache, std::vector<CStakeKernel>& kernels)
+{
+    kernels.clear();
+    kernels.reserve(prevouts.size());
+    for(const COutPoint& prevout : prevouts)
+    {
+        auto it = cache.find(prevout);
+        if(it != cache.end()) {
+            kernels.emplace_back(pindexPrev->nStakeModifier, prevout, it->second);
+        }
+        else {
+            kernels.emplace_back();
+        }
+    }
+}
+
+void CheckKernelBatch(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTimeBlock, const std::vector<CStakeKernel>& kernels, size_t from, size_t to, std::vector<std::pair<size_t, uint256>>& solved)
+{
+    // The target does not depend on the prevout, compute it once for the batch
+    int nHeight = pindexPrev->nHeight + 1;
+    bool fNoBNOverflow = nHeight >= Params().GetConsensus().nReduceBlocktimeHeight;
+    arith_uint256 bnBaseTarget;
+    bnBaseTarget.SetCompact(nBits);
+    bool fLogKernel = LogInstance().WillLogCategory(BCLog::COINSTAKE);
+
+    unsigned char tail[12];
+    WriteLE32(tail + 8, nTimeBlock);
+    for(size_t i = from; i < to && i < kernels.size(); i++)
+    {
+        const CStakeKernel& kernel = kernels[i];
+        if(!kernel.valid || nTimeBlock < kernel.blockFromTime)
+            continue;
+
+        // Finish the kernel hash from the cached midstate
+        uint256 hashProofOfStake;
+        memcpy(tail, kernel.tail, 8);
+        CSHA256(kernel.midstate).Write(tail, sizeof(tail)).Finalize(hashProofOfStake.begin());
+        CSHA256().Write(hashProofOfStake.begin(), CSHA256::OUTPUT_SIZE).Finalize(hashProofOfStake.begin());
+
+        // Weighted target check, see CheckStakeKernelHash()
+        arith_uint256 bnWeight = arith_uint256(kernel.amount);
+        arith_uint256 bnTarget = bnBaseTarget;
+        arith_uint256 bnProofOfStake = UintToArith256(hashProofOfStake);
+        if(fNoBNOverflow)
+            bnProofOfStake /= bnWeight;
+        else
+            bnTarget *= bnWeight;
+
+        if (bnProofOfStake > bnTarget)
+            continue;
+
+        if (fLogKernel)
+        {
+            LogPrintf("CheckKernelBatch() : check modifier=%s nTimeBlockFrom=%u nPrevout=%u nTimeBlock=%u hashProof=%s\n",
+                pindexPrev->nStakeModifier.GetHex().c_str(),
+                kernel.blockFromTime, kernel.prevout.n, nTimeBlock,
+                hashProofOfStake.ToString());
+        }
+
+        solved.emplace_back(i, hashProofOfStake);
+    }
+}
+
+bool CKernelCheck::operator()()
+{
+    if(search->fnInterrupt && search->fnInterrupt())
+        return false;
+
+    std::vector<std::pair<size_t, uint256>> solved;
+    CheckKernelBatch(search->pindexPrev, search->nBits, search->nTimeBlock, search->kernels, from, to, solved);
+    if(solved.size() > 0)
+    {
+        LOCK(search->cs_solved);
+        search->solved.insert(search->solved.end(), solved.begin(), solved.end());
+    }
+    return true;
+}
+
+bool SearchStakeKernels(CKernelSearch& search, CCheckQueue<CKernelCheck>* queue, std::vector<std::pair<size_t, uint256>>& solved)
+{
+    std::vector<CKernelCheck> vChecks;
+    for(size_t from = 0; from < search.kernels.size(); from += KERNEL_CHECK_SIZE)
+    {
+        vChecks.emplace_back(&search, from, std::min(from + KERNEL_CHECK_SIZE, search.kernels.size()));
+    }
+
+    bool ret = true;
+    if(queue)
+    {
+        // The calling thread joins the workers while waiting
+        CCheckQueueControl<CKernelCheck> control(queue);
+        control.Add(vChecks);
+        ret = control.Wait();
+    }
+    else
+    {
+        for(CKernelCheck& check : vChecks)
+        {
+            if(!check())
+            {
+                ret = false;
+                break;
+            }
+        }
+    }
+
+    // The workers finish their ranges in any order
+    LOCK(search.cs_solved);
+    solved = std::move(search.solved);
+    search.solved.clear();
+    std::sort(solved.begin(), solved.end());
+    return ret;
+}
+
 /**
  * Proof-of-stake functions needed in the wallet but wallet independent
  */
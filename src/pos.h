@@ -15,6 +15,11 @@
 #include <chainparams.h>
 #include <script/sign.h>
 #include <consensus/consensus.h>
+#include <crypto/sha256.h>
+#include <checkqueue.h>
+#include <sync.h>
+
+#include <functional>
 
 struct CStakeCache{
     CStakeCache(uint32_t blockFromTime_, CAmount amount_) : blockFromTime(blockFromTime_), amount(amount_){
@@ -25,6 +30,24 @@ struct CStakeCache{
 
 void CacheKernel(std::map<COutPoint, CStakeCache>& cache, const COutPoint& prevout, CBlockIndex* pindexPrev, CCoinsViewCache& view);
 
+// Kernel hash input of a stake prevout for a fixed stake modifier.
+// The first 64 bytes of the kernel (stake modifier, block from time and most of the prevout hash)
+// do not depend on the block time, so their SHA256 midstate is computed once and reused.
+struct CStakeKernel{
+    CStakeKernel() {}
+    CStakeKernel(const uint256& nStakeModifier, const COutPoint& prevout_, const CStakeCache& stake);
+    bool valid = false;
+    COutPoint prevout;
+    uint32_t blockFromTime = 0;
+    CAmount amount = 0;
+    CSHA256 midstate;
+    unsigned char tail[12] = {}; // End of the prevout hash, prevout index and block time
+};
+
+// Prepare the kernels of the prevouts for the stake modifier of pindexPrev.
+// The result is aligned with prevouts, prevouts missing from the cache produce invalid kernels.
+void PrepareStakeKernels(CBlockIndex* pindexPrev, const std::vector<COutPoint>& prevouts, const std::map<COutPoint, CStakeCache>& cache, std::vector<CStakeKernel>& kernels);
+
 // Compute the hash modifier for proof-of-stake
 uint256 ComputeStakeModifier(const CBlockIndex* pindexPrev, const uint256& kernel);
 
@@ -53,6 +76,53 @@ bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTimeBloc
 bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTimeBlock, const COutPoint& prevout, CCoinsViewCache& view, const std::map<COutPoint, CStakeCache>& cache, CChain& chain);
 bool CheckKernelCache(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTimeBlock, const COutPoint& prevout, const std::map<COutPoint, CStakeCache>& cache, uint256& hashProofOfStake);
 
+// Batched CheckKernelCache() over kernels[from, to) prepared by PrepareStakeKernels()
+// Appends the index and proof hash of every kernel that meets the target to solved
+void CheckKernelBatch(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTimeBlock, const std::vector<CStakeKernel>& kernels, size_t from, size_t to, std::vector<std::pair<size_t, uint256>>& solved);
+
+// Number of kernels hashed by a single kernel check
+static const size_t KERNEL_CHECK_SIZE = 256;
+
+// Kernel search for a candidate block time, shared by its kernel checks
+struct CKernelSearch{
+    CKernelSearch(CBlockIndex* pindexPrev_, unsigned int nBits_, uint32_t nTimeBlock_, const std::vector<CStakeKernel>& kernels_, std::function<bool()> fnInterrupt_ = {}) :
+        pindexPrev(pindexPrev_), nBits(nBits_), nTimeBlock(nTimeBlock_), kernels(kernels_), fnInterrupt(std::move(fnInterrupt_)) {}
+    CBlockIndex* pindexPrev;
+    unsigned int nBits;
+    uint32_t nTimeBlock;
+    const std::vector<CStakeKernel>& kernels;
+    std::function<bool()> fnInterrupt; // Stops the search early when it returns true
+    Mutex cs_solved;
+    std::vector<std::pair<size_t, uint256>> solved GUARDED_BY(cs_solved);
+};
+
+// Closure checking the kernels[from, to) of a kernel search
+class CKernelCheck
+{
+private:
+    CKernelSearch *search = nullptr;
+    size_t from = 0;
+    size_t to = 0;
+
+public:
+    CKernelCheck() {}
+    CKernelCheck(CKernelSearch *search_, size_t from_, size_t to_) : search(search_), from(from_), to(to_) {}
+
+    bool operator()();
+
+    void swap(CKernelCheck &check)
+    {
+        std::swap(search, check.search);
+        std::swap(from, check.from);
+        std::swap(to, check.to);
+    }
+};
+
+// Check all kernels of a search in ranges of KERNEL_CHECK_SIZE, on the queue when it is not null and serially otherwise
+// Sets solved to the index and proof hash of every kernel that meets the target, ordered by index
+// Returns false if the search was interrupted
+bool SearchStakeKernels(CKernelSearch& search, CCheckQueue<CKernelCheck>* queue, std::vector<std::pair<size_t, uint256>>& solved);
+
 unsigned int GetStakeMaxCombineInputs();
 
 int64_t GetStakeCombineThreshold();
@@ -0,0 +1,222 @@
+#include <revo/contractcall.h>
+
+#include <chainparams.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <revo/revoDGP.h>
+#include <timedata.h>
+#include <util/convert.h>
+#include <util/threadnames.h>
+#include <util/time.h>
+
+#include <future>
+
+ContractCaller g_contract_caller;
+
+ContractCallSnapshot::ContractCallSnapshot(CChainState& chainstate) :
+    hashBlock(chainstate.m_chain.Tip()->GetBlockHash()),
+    nHeight(chainstate.m_chain.Height()),
+    blockGasLimit(RevoDGP(globalState.get(), chainstate, fGettingValuesDGP).getBlockGasLimit(nHeight + 1))
+{
+    AssertLockHeld(cs_main);
+    CBlockIndex* pindex = chainstate.m_chain.Tip();
+    hashStateRoot = globalState->rootHash();
+    hashUTXORoot = globalState->rootHashUTXO();
+    db = globalState->db();
+    dbUtxo = globalState->dbUtxo();
+
+    // The calls are executed in a block on top of the tip with the author of the tip, like in CallContract
+    CBlock block;
+    dev::Address author;
+    if(ReadBlockFromDisk(block, pindex, Params().GetConsensus())){
+        author = ByteCodeExec::EthAddrFromScript(block.IsProofOfStake() ? block.vtx[1]->vout[1].scriptPubKey : block.vtx[0]->vout[0].scriptPubKey);
+    }
+    header.setNumber(nHeight + 1);
+    header.setDifficulty(dev::u256(pindex->nBits));
+    header.setGasLimit(blockGasLimit);
+    header.setAuthor(author);
+    lastHashes.set(pindex);
+
+    chainParams = globalSealEngine->chainParams();
+    revoSchedule = globalSealEngine->getRevoSchedule();
+}
+
+bool ContractCallSnapshot::AddressInUse(const dev::Address& addr) const
+{
+    RevoState state(dev::u256(0), db, dbUtxo);
+    state.setRoot(hashStateRoot);
+    return state.addressInUse(addr);
+}
+
+std::vector<ResultExecute> ContractCallSnapshot::Call(const std::vector<ContractCall>& calls) const
+{
+    // The calls share the state, the environment and the seal engine. A reverted execution clears the account
+    // cache of the state, so each call reads its accounts again, from the trie nodes kept by the state databases.
+    RevoState state(dev::u256(0), db, dbUtxo);
+    state.setRoot(hashStateRoot);
+    state.setRootUTXO(hashUTXORoot);
+
+    dev::eth::BlockHeader callHeader(header);
+    callHeader.setTimestamp(GetAdjustedTime());
+    dev::u256 gasUsed;
+    dev::eth::EnvInfo envInfo(callHeader, lastHashes, gasUsed, chainParams.chainID);
+
+    // The seal engine collects the accounts to delete during an execution, so concurrent calls need their own
+    std::unique_ptr<dev::eth::SealEngineFace> sealEngine(dev::eth::SealEngineRegistrar::create(chainParams));
+    sealEngine->setRevoSchedule(revoSchedule);
+
+    std::vector<ResultExecute> results;
+    results.reserve(calls.size());
+    for(const ContractCall& call : calls){
+        uint64_t gasLimit = call.gasLimit == 0 ? blockGasLimit - 1 : call.gasLimit;
+        dev::Address senderAddress = call.sender == dev::Address() ? dev::Address("ffffffffffffffffffffffffffffffffffffffff") : call.sender;
+        dev::u256 nonce = state.getNonce(senderAddress);
+
+        RevoTransaction callTransaction = call.addrContract == dev::Address() ?
+            RevoTransaction(call.nAmount, 1, dev::u256(gasLimit), call.opcode, nonce) :
+            RevoTransaction(call.nAmount, 1, dev::u256(gasLimit), call.addrContract, call.opcode, nonce);
+        callTransaction.forceSender(senderAddress);
+        callTransaction.setVersion(VersionVM::GetEVMDefault());
+
+        if(!callTransaction.isCreation() && !state.addressInUse(callTransaction.receiveAddress())){
+            dev::eth::ExecutionResult execRes;
+            execRes.excepted = dev::eth::TransactionException::Unknown;
+            results.push_back(ResultExecute{execRes, RevoTransactionReceipt(dev::h256(), dev::h256(), dev::u256(), dev::eth::LogEntries()), CTransaction()});
+            continue;
+        }
+
+        results.push_back(state.execute(envInfo, *sealEngine, callTransaction, nHeight, dev::eth::Permanence::Reverted));
+        sealEngine->deleteAddresses.clear();
+    }
+    return results;
+}
+
+ResultExecute ContractCallSnapshot::Call(const dev::Address& addrContract, const std::vector<unsigned char>& opcode, const dev::Address& sender, uint64_t gasLimit, CAmount nAmount) const
+{
+    return Call(std::vector<ContractCall>{{addrContract, opcode, sender, gasLimit, nAmount}})[0];
+}
+
+ContractCaller::~ContractCaller()
+{
+    Stop();
+}
+
+void ContractCaller::Start(int threads)
+{
+    LOCK(m_queue_mutex);
+    assert(m_threads.empty());
+    m_running = threads > 0;
+    for (int n = 0; n < threads; ++n) {
+        m_threads.emplace_back([this, n] {
+            util::ThreadRename(strprintf("callcontract.%i", n));
+            ThreadWorker();
+        });
+    }
+}
+
+void ContractCaller::Stop()
+{
+    {
+        LOCK(m_queue_mutex);
+        m_running = false;
+        m_queue_cv.notify_all();
+    }
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+
+    // The snapshot keeps the state databases open
+    LOCK(m_snapshot_mutex);
+    m_snapshot.reset();
+}
+
+std::shared_ptr<const ContractCallSnapshot> ContractCaller::GetSnapshot(CChainState& chainstate)
+{
+    const uint256 hashTip = WITH_LOCK(g_best_block_mutex, return g_best_block);
+
+    // g_best_block is only set once a block is connected after startup, the tip did not change before
+    {
+        LOCK(m_snapshot_mutex);
+        if (m_snapshot && (hashTip.IsNull() || m_snapshot->hashBlock == hashTip)) {
+            return m_snapshot;
+        }
+    }
+
+    LOCK2(cs_main, m_snapshot_mutex);
+    if (!m_snapshot || m_snapshot->hashBlock != chainstate.m_chain.Tip()->GetBlockHash()) {
+        m_snapshot = std::make_shared<const ContractCallSnapshot>(chainstate);
+        LOCK(m_stats_mutex);
+        m_stats.snapshots++;
+    }
+    return m_snapshot;
+}
+
+std::vector<ResultExecute> ContractCaller::Call(const ContractCallSnapshot& snapshot, const std::vector<ContractCall>& calls)
+{
+    std::packaged_task<std::vector<ResultExecute>()> task([&] {
+        const int64_t nTimeStart = GetTimeMicros();
+        std::vector<ResultExecute> results = snapshot.Call(calls);
+        const int64_t nTime = GetTimeMicros() - nTimeStart;
+        uint64_t gasUsed = 0;
+        for (const ResultExecute& result : results) {
+            gasUsed += (uint64_t)result.execRes.gasUsed;
+        }
+
+        LOCK(m_stats_mutex);
+        m_stats.calls += calls.size();
+        m_stats.requests++;
+        m_stats.gasUsed += gasUsed;
+        m_stats.totalTime += nTime;
+        m_stats.maxTime = std::max(m_stats.maxTime, nTime);
+        LogPrint(BCLog::BENCH, "callcontract: %u calls, %u gas in %.2fms at height %d [%u calls, %.2fms/call, max %.2fms]\n",
+            calls.size(), gasUsed, nTime * 0.001, snapshot.nHeight, m_stats.calls, m_stats.totalTime * 0.001 / std::max<uint64_t>(m_stats.calls, 1), m_stats.maxTime * 0.001);
+        return results;
+    });
+    std::future<std::vector<ResultExecute>> results = task.get_future();
+
+    bool queued = false;
+    {
+        LOCK(m_queue_mutex);
+        if (m_running) {
+            // The task is waited for below, so it may be referenced
+            m_queue.emplace_back([&task] { task(); });
+            m_queue_cv.notify_one();
+            queued = true;
+        }
+    }
+    if (!queued) {
+        task();
+    }
+    return results.get();
+}
+
+ResultExecute ContractCaller::Call(const ContractCallSnapshot& snapshot, const dev::Address& addrContract, const std::vector<unsigned char>& opcode, const dev::Address& sender, uint64_t gasLimit, CAmount nAmount)
+{
+    return Call(snapshot, std::vector<ContractCall>{{addrContract, opcode, sender, gasLimit, nAmount}})[0];
+}
+
+ContractCaller::Stats ContractCaller::GetStats() const
+{
+    LOCK(m_stats_mutex);
+    return m_stats;
+}
+
+void ContractCaller::ThreadWorker()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            WAIT_LOCK(m_queue_mutex, lock);
+            while (m_running && m_queue.empty()) {
+                m_queue_cv.wait(lock);
+            }
+            if (!m_running && m_queue.empty()) {
+                break;
+            }
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef CONTRACTCALL_H
+#define CONTRACTCALL_H
+
+#include <amount.h>
+#include <revo/revostate.h>
+#include <sync.h>
+#include <uint256.h>
+#include <validation.h>
+
+#include <libethcore/BlockHeader.h>
+#include <libethcore/ChainOperationParams.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+class CChainState;
+
+/** Default number of threads running the read-only contract calls of the RPC server */
+static const int DEFAULT_CALLCONTRACT_THREADS = 4;
+/** Maximum number of threads running the read-only contract calls */
+static const int MAX_CALLCONTRACT_THREADS = 64;
+
+/** Maximum number of calls in a callcontractbatch request */
+static const size_t MAX_CALLCONTRACT_BATCH = 1000;
+
+/** A read-only contract call, with the parameters of CallContract */
+struct ContractCall
+{
+    dev::Address addrContract;
+    std::vector<unsigned char> opcode;
+    dev::Address sender;
+    uint64_t gasLimit{0};
+    CAmount nAmount{0};
+};
+
+/**
+ * Everything a read-only contract call needs from the chain tip, copied once under cs_main.
+ * The state is read through copies of the overlays of globalState, which share its databases,
+ * so the calls neither take cs_main nor see the changes of the blocks connected meanwhile.
+ */
+class ContractCallSnapshot
+{
+public:
+    /** Take a snapshot of the tip of chainstate. Requires cs_main. */
+    explicit ContractCallSnapshot(CChainState& chainstate);
+
+    /** Run calls like CallContract does, one after the other on a state of their own in the same block */
+    std::vector<ResultExecute> Call(const std::vector<ContractCall>& calls) const;
+
+    ResultExecute Call(const dev::Address& addrContract, const std::vector<unsigned char>& opcode, const dev::Address& sender = dev::Address(), uint64_t gasLimit = 0, CAmount nAmount = 0) const;
+
+    /** Whether a contract exists at addr in the snapshot */
+    bool AddressInUse(const dev::Address& addr) const;
+
+    const uint256 hashBlock;
+    const int nHeight;
+    const uint64_t blockGasLimit;
+
+private:
+    dev::h256 hashStateRoot;
+    dev::h256 hashUTXORoot;
+    dev::OverlayDB db;
+    dev::OverlayDB dbUtxo;
+
+    /** Header of the block the calls are executed in, without its timestamp */
+    dev::eth::BlockHeader header;
+    LastHashes lastHashes;
+    dev::eth::ChainOperationParams chainParams;
+    dev::eth::EVMSchedule revoSchedule;
+};
+
+/**
+ * Runs the read-only contract calls of the RPC server (callcontract) on a pool of threads,
+ * against a snapshot of the chain tip which is only taken again when the tip changed.
+ */
+class ContractCaller
+{
+public:
+    struct Stats
+    {
+        uint64_t calls{0};
+        uint64_t gasUsed{0};
+        uint64_t requests{0}; //!< a batch of calls is one request
+        int64_t totalTime{0}; //!< microseconds
+        int64_t maxTime{0}; //!< microseconds, of the slowest request
+        uint64_t snapshots{0};
+    };
+
+    ~ContractCaller();
+
+    /** Start the worker threads. Without any, the calls run on the thread of the caller. */
+    void Start(int threads);
+    void Stop();
+
+    /** The snapshot of the current tip. Only takes cs_main when the tip changed since the last one. */
+    std::shared_ptr<const ContractCallSnapshot> GetSnapshot(CChainState& chainstate);
+
+    /** Run calls on the snapshot on a worker thread, and wait for their results */
+    std::vector<ResultExecute> Call(const ContractCallSnapshot& snapshot, const std::vector<ContractCall>& calls);
+
+    ResultExecute Call(const ContractCallSnapshot& snapshot, const dev::Address& addrContract, const std::vector<unsigned char>& opcode, const dev::Address& sender = dev::Address(), uint64_t gasLimit = 0, CAmount nAmount = 0);
+
+    Stats GetStats() const;
+
+private:
+    void ThreadWorker();
+
+    Mutex m_snapshot_mutex;
+    std::shared_ptr<const ContractCallSnapshot> m_snapshot GUARDED_BY(m_snapshot_mutex);
+
+    Mutex m_queue_mutex;
+    std::condition_variable m_queue_cv GUARDED_BY(m_queue_mutex);
+    std::deque<std::function<void()>> m_queue GUARDED_BY(m_queue_mutex);
+    bool m_running GUARDED_BY(m_queue_mutex){false};
+    std::vector<std::thread> m_threads;
+
+    mutable Mutex m_stats_mutex;
+    Stats m_stats GUARDED_BY(m_stats_mutex);
+};
+
+extern ContractCaller g_contract_caller;
+
+#endif // CONTRACTCALL_H
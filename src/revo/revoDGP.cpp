@@ -1,5 +1,107 @@
 #include <revo/revoDGP.h>
 #include <chainparams.h>
+#include <hash.h>
+#include <util/convert.h>
+
+RevoDGPCache g_dgp_cache;
+
+// A new entry is only added when the DGP changes, so this is never reached in practice
+static const size_t MAX_DGP_CACHE_ENTRIES = 10000;
+
+// The EVM instructions reading the block, the transaction, the gas left or other accounts
+static const std::set<uint8_t> EVM_CONTEXT_INSTRUCTIONS = {
+    0x31 /* BALANCE */, 0x3a /* GASPRICE */, 0x3b /* EXTCODESIZE */, 0x3c /* EXTCODECOPY */, 0x3f /* EXTCODEHASH */,
+    0x40 /* BLOCKHASH */, 0x41 /* COINBASE */, 0x42 /* TIMESTAMP */, 0x43 /* NUMBER */, 0x44 /* DIFFICULTY */,
+    0x45 /* GASLIMIT */, 0x46 /* CHAINID */, 0x47 /* SELFBALANCE */, 0x48 /* BASEFEE */, 0x5a /* GAS */,
+    0xf0 /* CREATE */, 0xf1 /* CALL */, 0xf2 /* CALLCODE */, 0xf4 /* DELEGATECALL */, 0xf5 /* CREATE2 */,
+    0xfa /* STATICCALL */, 0xff /* SELFDESTRUCT */
+};
+
+// The EVM instructions after which the next one is only reached by a jump
+static const std::set<uint8_t> EVM_HALTING_INSTRUCTIONS = {
+    0x00 /* STOP */, 0x56 /* JUMP */, 0xf3 /* RETURN */, 0xfd /* REVERT */, 0xfe /* INVALID */
+};
+
+static const uint8_t EVM_JUMPDEST = 0x5b;
+static const uint8_t EVM_PUSH1 = 0x60;
+static const uint8_t EVM_PUSH32 = 0x7f;
+
+bool RevoDGPCache::GetInstances(const uint256& key, std::vector<std::pair<unsigned int, dev::Address>>& result) const
+{
+    LOCK(cs_cache);
+    auto it = instances.find(key);
+    if(it == instances.end())
+        return false;
+    result.clear();
+    for(const auto& i : it->second){
+        result.emplace_back(i.first, uintToh160(i.second));
+    }
+    return true;
+}
+
+void RevoDGPCache::SetInstances(const uint256& key, const std::vector<std::pair<unsigned int, dev::Address>>& value)
+{
+    LOCK(cs_cache);
+    if(instances.size() >= MAX_DGP_CACHE_ENTRIES)
+        instances.clear();
+    std::vector<std::pair<unsigned int, uint160>>& entry = instances[key];
+    entry.clear();
+    for(const auto& i : value){
+        entry.emplace_back(i.first, h160Touint(i.second));
+    }
+}
+
+bool RevoDGPCache::GetTemplateData(const uint256& key, std::vector<unsigned char>& data) const
+{
+    LOCK(cs_cache);
+    auto it = templateData.find(key);
+    if(it == templateData.end())
+        return false;
+    data = it->second;
+    return true;
+}
+
+void RevoDGPCache::SetTemplateData(const uint256& key, const std::vector<unsigned char>& data)
+{
+    LOCK(cs_cache);
+    if(templateData.size() >= MAX_DGP_CACHE_ENTRIES)
+        templateData.clear();
+    templateData[key] = data;
+}
+
+uint256 RevoDGPCache::TemplateKey(const dev::Address& addr, const dev::h256& storageRoot, const dev::h256& codeHash, const std::vector<unsigned char>& data)
+{
+    CHashWriter key(SER_GETHASH, 0);
+    key << uint8_t('t') << h160Touint(addr) << h256Touint(storageRoot) << h256Touint(codeHash) << data;
+    return key.GetHash();
+}
+
+bool RevoDGPCache::ReadsOwnStateOnly(const std::vector<unsigned char>& code)
+{
+    // Only the instructions that can be reached are checked, so the metadata appended by the compiler is
+    // skipped: the code after an instruction ending the execution is only reached by jumping to a JUMPDEST
+    bool reachable = true;
+    for(size_t i = 0; i < code.size(); i++){
+        const uint8_t op = code[i];
+        if(op == EVM_JUMPDEST)
+            reachable = true;
+        if(reachable && EVM_CONTEXT_INSTRUCTIONS.count(op))
+            return false;
+        if(EVM_HALTING_INSTRUCTIONS.count(op))
+            reachable = false;
+        // The data of a push is not an instruction, even when it is a JUMPDEST
+        if(op >= EVM_PUSH1 && op <= EVM_PUSH32)
+            i += op - EVM_PUSH1 + 1;
+    }
+    return true;
+}
+
+void RevoDGPCache::Clear()
+{
+    LOCK(cs_cache);
+    instances.clear();
+    templateData.clear();
+}
 
 std::vector<uint32_t> createDataSchedule(const dev::eth::EVMSchedule& schedule)
 {
@@ -100,8 +202,7 @@ uint64_t RevoDGP::getBlockGasLimit(unsigned int blockHeight){
 }
 
 bool RevoDGP::initStorages(const dev::Address& addr, unsigned int blockHeight, std::vector<unsigned char> data){
-    initStorageDGP(addr);
-    createParamsInstance();
+    initParamsInstance(addr);
     dev::Address address = getAddressForBlock(blockHeight);
     if(address != dev::Address()){
         if(!dgpevm){
@@ -114,6 +215,18 @@ bool RevoDGP::initStorages(const dev::Address& addr, unsigned int blockHeight, s
     return false;
 }
 
+void RevoDGP::initParamsInstance(const dev::Address& addr){
+    // The instances only change with the storage of the DGP contract
+    CHashWriter key(SER_GETHASH, 0);
+    key << uint8_t('i') << h160Touint(addr) << h256Touint(state->storageRoot(addr));
+    if(g_dgp_cache.GetInstances(key.GetHash(), paramsInstance))
+        return;
+
+    initStorageDGP(addr);
+    createParamsInstance();
+    g_dgp_cache.SetInstances(key.GetHash(), paramsInstance);
+}
+
 void RevoDGP::initStorageDGP(const dev::Address& addr){
     storageDGP = state->storage(addr);
 }
@@ -123,7 +236,16 @@ void RevoDGP::initStorageTemplate(const dev::Address& addr){
 }
 
 void RevoDGP::initDataTemplate(const dev::Address& addr, std::vector<unsigned char>& data){
-    dataTemplate = CallContract(addr, data, chainstate)[0].execRes.output;
+    // The key only covers the code and the storage of the template, so only the results of
+    // templates which read nothing else, like the block or other accounts, are cached
+    const uint256 key = RevoDGPCache::TemplateKey(addr, state->storageRoot(addr), state->codeHash(addr), data);
+    if(g_dgp_cache.GetTemplateData(key, dataTemplate))
+        return;
+
+    std::vector<ResultExecute> result = CallContract(addr, data, chainstate);
+    dataTemplate = result[0].execRes.output;
+    if(result[0].execRes.excepted == dev::eth::TransactionException::None && RevoDGPCache::ReadsOwnStateOnly(state->code(addr)))
+        g_dgp_cache.SetTemplateData(key, dataTemplate);
 }
 
 void RevoDGP::createParamsInstance(){
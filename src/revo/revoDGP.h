@@ -5,6 +5,8 @@
 #include <primitives/block.h>
 #include <validation.h>
 #include <util/strencodings.h>
+#include <sync.h>
+#include <uint256.h>
 
 static const dev::Address GasScheduleDGP = dev::Address("0000000000000000000000000000000000000080");
 static const dev::Address BlockSizeDGP = dev::Address("0000000000000000000000000000000000000081");
@@ -23,6 +25,43 @@ static const uint64_t MIN_BLOCK_GAS_LIMIT_DGP = 1000000;
 static const uint64_t MAX_BLOCK_GAS_LIMIT_DGP = 1000000000;
 static const uint64_t DEFAULT_BLOCK_GAS_LIMIT_DGP = 1000000000;
 
+/**
+ * Parameters read from the DGP contracts, by the state of the contracts they were read from.
+ * The DGP contract storage and the parameter templates only change when a block changes them,
+ * which changes their storage root, so an entry never becomes stale. The data returned by a
+ * template is only cached when its code cannot read anything but its own storage.
+ */
+class RevoDGPCache {
+
+public:
+
+    bool GetInstances(const uint256& key, std::vector<std::pair<unsigned int, dev::Address>>& instances) const;
+
+    void SetInstances(const uint256& key, const std::vector<std::pair<unsigned int, dev::Address>>& instances);
+
+    bool GetTemplateData(const uint256& key, std::vector<unsigned char>& data) const;
+
+    void SetTemplateData(const uint256& key, const std::vector<unsigned char>& data);
+
+    /** Key of the data returned by a template for the call data */
+    static uint256 TemplateKey(const dev::Address& addr, const dev::h256& storageRoot, const dev::h256& codeHash, const std::vector<unsigned char>& data);
+
+    /** Whether the code reads no state but its own storage, its call data and its code */
+    static bool ReadsOwnStateOnly(const std::vector<unsigned char>& code);
+
+    void Clear();
+
+private:
+
+    mutable Mutex cs_cache;
+
+    std::map<uint256, std::vector<std::pair<unsigned int, uint160>>> instances GUARDED_BY(cs_cache);
+
+    std::map<uint256, std::vector<unsigned char>> templateData GUARDED_BY(cs_cache);
+};
+
+extern RevoDGPCache g_dgp_cache;
+
 class RevoDGP {
     
 public:
@@ -41,6 +80,8 @@ private:
 
     bool initStorages(const dev::Address& addr, unsigned int blockHeight, std::vector<unsigned char> data = std::vector<unsigned char>());
 
+    void initParamsInstance(const dev::Address& addr);
+
     void initStorageDGP(const dev::Address& addr);
 
     void initStorageTemplate(const dev::Address& addr);
@@ -279,7 +279,7 @@ bool RevoDelegation::FilterDelegationEvents(std::vector<DelegationEvent> &events
     std::set<dev::h160> addresses;
     addresses.insert(priv->delegationsAddress);
     std::vector<std::vector<uint256>> hashesToBlock;
-    curheight = pblocktree->ReadHeightIndex(fromBlock, toBlock, minconf, hashesToBlock, addresses, chainman);
+    curheight = pblocktree->ReadHeightIndex(fromBlock, toBlock, minconf, hashesToBlock, addresses, {}, chainman);
 
     if (curheight == -1) {
         return error("Incorrect params");
@@ -318,6 +318,11 @@ bool RevoDelegation::FilterDelegationEvents(std::vector<DelegationEvent> &events
     return true;
 }
 
+bool RevoDelegation::GetDelegationEvent(const dev::eth::LogEntry &log, DelegationEvent &event) const
+{
+    return priv->GetDelegationEvent(log, event);
+}
+
 std::map<uint160, Delegation> RevoDelegation::DelegationsFromEvents(const std::vector<DelegationEvent> &events)
 {
     std::map<uint160, Delegation> delegations;
@@ -4,12 +4,14 @@
 #include <vector>
 #include <map>
 #include <stdint.h>
+#include <serialize.h>
 #include <uint256.h>
 
 class RevoDelegationPriv;
 class ContractABI;
 class ChainstateManager;
 class CChainState;
+namespace dev { namespace eth { struct LogEntry; } }
 
 extern const std::string strDelegationsABI;
 const ContractABI &DelegationABI();
@@ -32,6 +34,8 @@ struct Delegation
     uint8_t fee;
     uint32_t blockHeight;
     std::vector<unsigned char> PoD; //Proof Of Delegation
+
+    SERIALIZE_METHODS(Delegation, obj) { READWRITE(obj.staker, obj.fee, obj.blockHeight, obj.PoD); }
 };
 
 inline bool operator==(const Delegation& lhs, const Delegation& rhs)
@@ -131,6 +135,14 @@ public:
      */
     bool FilterDelegationEvents(std::vector<DelegationEvent>& events, const IDelegationFilter& filter, ChainstateManager &chainman, int fromBlock = 0, int toBlock = -1, int minconf = 0) const;
 
+    /**
+     * @brief GetDelegationEvent Parse a delegation contract log entry
+     * @param log Log entry from a transaction receipt
+     * @param event Output delegation event
+     * @return true if the log is a delegation event, false otherwise
+     */
+    bool GetDelegationEvent(const dev::eth::LogEntry& log, DelegationEvent& event) const;
+
     /**
      * @brief DelegationsFromEvents Get the delegations from the events
      * @param events Delegation event list
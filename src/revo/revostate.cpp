@@ -22,7 +22,16 @@ RevoState::RevoState() : dev::eth::State(dev::Invalid256, dev::OverlayDB(), dev:
     stateUTXO = SecureTrieDB<Address, OverlayDB>(&dbUTXO);
 }
 
+RevoState::RevoState(u256 const& _accountStartNonce, OverlayDB const& _db, OverlayDB const& _dbUtxo) :
+        State(_accountStartNonce, _db, BaseState::PreExisting), dbUTXO(_dbUtxo) {
+    stateUTXO = SecureTrieDB<Address, OverlayDB>(&dbUTXO);
+}
+
 ResultExecute RevoState::execute(EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, RevoTransaction const& _t, CChain& _chain, Permanence _p, OnOpFunc const& _onOp){
+    return execute(_envInfo, _sealEngine, _t, _chain.Height(), _p, _onOp);
+}
+
+ResultExecute RevoState::execute(EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, RevoTransaction const& _t, int _height, Permanence _p, OnOpFunc const& _onOp){
 
     assert(_t.getVersion().toRaw() == VersionVM::GetEVMDefault().toRaw());
 
@@ -58,7 +67,7 @@ ResultExecute RevoState::execute(EnvInfo const& _envInfo, SealEngineFace const&
         startGasUsed = _envInfo.gasUsed();
         if (!e.execute()){
             e.go(onOp);
-            if(_chain.Height() >= consensusParams.QIP7Height){
+            if(_height >= consensusParams.QIP7Height){
             	validateTransfersWithChangeLog();
             }
         } else {
@@ -97,7 +106,7 @@ ResultExecute RevoState::execute(EnvInfo const& _envInfo, SealEngineFace const&
         printfErrorLog(dev::eth::toTransactionException(_e));
         res.excepted = dev::eth::toTransactionException(_e);
         res.gasUsed = _t.gas();
-        if(_chain.Height() < consensusParams.nFixUTXOCacheHFHeight  && _p != Permanence::Reverted){
+        if(_height < consensusParams.nFixUTXOCacheHFHeight  && _p != Permanence::Reverted){
             deleteAccounts(_sealEngine.deleteAddresses);
             commit(CommitBehaviour::RemoveEmptyAccounts);
         } else {
@@ -0,0 +1,104 @@
+#include <revo/statejournal.h>
+#include <revo/revostate.h>
+#include <util/convert.h>
+
+#include <libdevcore/OverlayDB.h>
+
+constexpr uint8_t DB_STATE_JOURNAL{'j'};
+constexpr uint8_t DB_PRUNE_HEIGHT{'P'};
+
+namespace {
+
+void AppendNodes(dev::h256Hash const& touched, std::vector<uint256>& nodes)
+{
+    nodes.reserve(nodes.size() + touched.size());
+    for (dev::h256 const& hash : touched) {
+        nodes.push_back(h256Touint(hash));
+    }
+}
+
+} // namespace
+
+StateJournal::StateJournal(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe) :
+    CDBWrapper(path, nCacheSize, fMemory, fWipe),
+    m_state_journal(std::make_shared<dev::OverlayJournal>()),
+    m_utxo_journal(std::make_shared<dev::OverlayJournal>())
+{}
+
+void StateJournal::Attach(RevoState& state)
+{
+    state.db().setJournal(m_state_journal);
+    state.dbUtxo().setJournal(m_utxo_journal);
+}
+
+bool StateJournal::WriteBlock(int nHeight, const uint256& blockHash)
+{
+    StateJournalKey key(nHeight, blockHash);
+
+    // A block connected again after a reorg keeps the nodes touched the first time
+    StateJournalEntry entry;
+    Read(std::make_pair(DB_STATE_JOURNAL, key), entry);
+    AppendNodes(m_state_journal->takeTouched(), entry.stateNodes);
+    AppendNodes(m_utxo_journal->takeTouched(), entry.utxoNodes);
+    if (entry.IsNull()) {
+        return true;
+    }
+
+    return Write(std::make_pair(DB_STATE_JOURNAL, key), entry);
+}
+
+bool StateJournal::ReadEntries(int nMaxHeight, std::vector<std::pair<StateJournalKey, StateJournalEntry>>& entries)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(DB_STATE_JOURNAL, StateJournalKey()));
+
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, StateJournalKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_STATE_JOURNAL || key.second.height > (uint32_t)nMaxHeight) {
+            break;
+        }
+        StateJournalEntry entry;
+        if (!pcursor->GetValue(entry)) {
+            return error("%s: failed to read state journal entry of block %s", __func__, key.second.blockHash.ToString());
+        }
+        entries.emplace_back(key.second, std::move(entry));
+        pcursor->Next();
+    }
+    return true;
+}
+
+bool StateJournal::EraseEntries(const std::vector<StateJournalKey>& keys)
+{
+    CDBBatch batch(*this);
+    for (const StateJournalKey& key : keys) {
+        batch.Erase(std::make_pair(DB_STATE_JOURNAL, key));
+    }
+    return WriteBatch(batch, true);
+}
+
+bool StateJournal::ReadPruneHeight(int& nHeight)
+{
+    nHeight = 0;
+    return !Exists(DB_PRUNE_HEIGHT) || Read(DB_PRUNE_HEIGHT, nHeight);
+}
+
+bool StateJournal::WritePruneHeight(int nHeight)
+{
+    return Write(DB_PRUNE_HEIGHT, nHeight, true);
+}
+
+size_t StateJournal::CountEntries()
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(DB_STATE_JOURNAL, StateJournalKey()));
+
+    size_t count = 0;
+    for (; pcursor->Valid(); pcursor->Next()) {
+        std::pair<uint8_t, StateJournalKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_STATE_JOURNAL) {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
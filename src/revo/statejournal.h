@@ -0,0 +1,75 @@
+#ifndef STATEJOURNAL_H
+#define STATEJOURNAL_H
+
+#include <dbwrapper.h>
+#include <uint256.h>
+
+#include <memory>
+#include <vector>
+
+class RevoState;
+namespace dev { class OverlayJournal; }
+
+/** Key of the journal entry of a block, ordered by height */
+struct StateJournalKey
+{
+    uint32_t height{0};
+    uint256 blockHash;
+
+    StateJournalKey() {}
+    StateJournalKey(uint32_t _height, const uint256& _blockHash) : height(_height), blockHash(_blockHash) {}
+
+    SERIALIZE_METHODS(StateJournalKey, obj) { READWRITE(Using<BigEndianFormatter<4>>(obj.height), obj.blockHash); }
+};
+
+/** Trie nodes written or released while connecting a block */
+struct StateJournalEntry
+{
+    std::vector<uint256> stateNodes;
+    std::vector<uint256> utxoNodes;
+
+    SERIALIZE_METHODS(StateJournalEntry, obj) { READWRITE(obj.stateNodes, obj.utxoNodes); }
+
+    bool IsNull() const { return stateNodes.empty() && utxoNodes.empty(); }
+};
+
+/**
+ * Undo journal of the contract state tries (stateRevo/journal).
+ * The state and UTXO tries are only ever appended to, and a node that is no longer part of the
+ * latest trie is still referenced by the roots of the blocks before it, which DisconnectBlock and
+ * the ConnectTip failure paths restore with setRoot. The journal records per block the nodes that
+ * connecting it touched, so that the nodes which are not reachable from the roots of the last
+ * blocks any more can be found and deleted without scanning the whole database.
+ */
+class StateJournal : public CDBWrapper
+{
+public:
+    explicit StateJournal(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    /// Record the nodes touched by the state and UTXO tries of the global state.
+    void Attach(RevoState& state);
+
+    /// Move the nodes touched since the previous block into the entry of the connected block.
+    bool WriteBlock(int nHeight, const uint256& blockHash);
+
+    /// Read the entries of the blocks up to and including a height.
+    bool ReadEntries(int nMaxHeight, std::vector<std::pair<StateJournalKey, StateJournalEntry>>& entries);
+
+    bool EraseEntries(const std::vector<StateJournalKey>& keys);
+
+    /// Height up to which the contract state has been pruned, 0 if never.
+    bool ReadPruneHeight(int& nHeight);
+    bool WritePruneHeight(int nHeight);
+
+    /// Number of blocks in the journal.
+    size_t CountEntries();
+
+    dev::OverlayJournal& StateNodes() { return *m_state_journal; }
+    dev::OverlayJournal& UTXONodes() { return *m_utxo_journal; }
+
+private:
+    std::shared_ptr<dev::OverlayJournal> m_state_journal;
+    std::shared_ptr<dev::OverlayJournal> m_utxo_journal;
+};
+
+#endif // STATEJOURNAL_H
@@ -0,0 +1,250 @@
+#include <revo/statepruner.h>
+#include <revo/statejournal.h>
+#include <util/convert.h>
+#include <util/thread.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <libdevcore/OverlayDB.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieCommon.h>
+
+std::unique_ptr<StatePruner> g_state_pruner;
+
+namespace {
+
+/** Marks the nodes reachable from trie roots, following the storage tries and code of accounts */
+class TrieMarker
+{
+public:
+    TrieMarker(const dev::OverlayDB& db, dev::h256Hash& live, const CThreadInterrupt& interrupt) :
+        m_db(db), m_live(live), m_interrupt(interrupt) {}
+
+    /// Returns false if a node is missing or the pass was interrupted.
+    bool Mark(const dev::h256& root, bool accounts)
+    {
+        m_pending.emplace_back(root, accounts);
+        while (!m_pending.empty()) {
+            auto [hash, isAccountTrie] = m_pending.back();
+            m_pending.pop_back();
+            if (!m_live.insert(hash).second || hash == dev::EmptyTrie) {
+                continue;
+            }
+            std::string node = m_db.lookup(hash);
+            if (node.empty()) {
+                return error("%s: missing trie node %s", __func__, hash.hex());
+            }
+            VisitNode(dev::RLP(node), isAccountTrie);
+            if (++m_visited % 10000 == 0 && m_interrupt) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void VisitNode(const dev::RLP& node, bool accounts)
+    {
+        if (!node.isList()) return;
+        if (node.itemCount() == 2) {
+            if (!dev::isLeaf(node)) {
+                VisitChild(node[1], accounts);
+            } else if (accounts) {
+                // [nonce, balance, storageRoot, codeHash(, version)]
+                dev::RLP account(node[1].payload());
+                m_pending.emplace_back(account[2].toHash<dev::h256>(), false);
+                dev::h256 codeHash = account[3].toHash<dev::h256>();
+                if (codeHash != dev::EmptySHA3) {
+                    m_live.insert(codeHash);
+                }
+            }
+        } else if (node.itemCount() == 17) {
+            for (unsigned i = 0; i < 16; i++) {
+                VisitChild(node[i], accounts);
+            }
+        }
+    }
+
+    void VisitChild(const dev::RLP& child, bool accounts)
+    {
+        // Nodes shorter than a hash are embedded in their parent
+        if (child.isList()) {
+            VisitNode(child, accounts);
+        } else if (child.isData() && child.size() == 32) {
+            m_pending.emplace_back(child.toHash<dev::h256>(), accounts);
+        }
+    }
+
+    const dev::OverlayDB& m_db;
+    dev::h256Hash& m_live;
+    const CThreadInterrupt& m_interrupt;
+    std::vector<std::pair<dev::h256, bool>> m_pending;
+    uint64_t m_visited{0};
+};
+
+} // namespace
+
+StatePruner::StatePruner(ChainstateManager& chainman, int depth, int interval) :
+    m_chainman(chainman), m_depth(depth), m_interval(interval)
+{
+    m_stats.depth = depth;
+}
+
+StatePruner::~StatePruner()
+{
+    Stop();
+}
+
+bool StatePruner::Start()
+{
+    int nPruneHeight = 0;
+    if (!pstatejournal->ReadPruneHeight(nPruneHeight)) {
+        return error("%s: failed to read the pruned height of the contract state", __func__);
+    }
+    {
+        LOCK(m_stats_mutex);
+        m_stats.pruneHeight = nPruneHeight;
+    }
+    m_thread = std::thread(&util::TraceThread, "stateprune", [this] { ThreadPrune(); });
+    return true;
+}
+
+void StatePruner::Interrupt()
+{
+    m_interrupt();
+}
+
+void StatePruner::Stop()
+{
+    Interrupt();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+StatePrunerStats StatePruner::GetStats() const
+{
+    LOCK(m_stats_mutex);
+    return m_stats;
+}
+
+bool StatePruner::IsPruned(int nHeight) const
+{
+    LOCK(m_stats_mutex);
+    return nHeight <= m_stats.pruneHeight;
+}
+
+bool StatePruner::CanRewindTo(int nHeight, int nTipHeight) const
+{
+    return !IsPruned(nHeight) && nTipHeight - nHeight < m_depth;
+}
+
+void StatePruner::ThreadPrune()
+{
+    while (!m_interrupt) {
+        bool fPruned = false;
+        try {
+            fPruned = Prune();
+        } catch (const std::exception& e) {
+            LogPrintf("%s: %s\n", __func__, e.what());
+        }
+        if (!fPruned) {
+            LogPrintf("%s: failed to prune the contract state, stopping\n", __func__);
+            return;
+        }
+        if (!m_interrupt.sleep_for(std::chrono::minutes(1))) {
+            return;
+        }
+    }
+}
+
+bool StatePruner::Prune()
+{
+    int nPruneHeight = 0;
+    std::vector<std::pair<dev::h256, dev::h256>> roots;
+    dev::OverlayDB stateDB;
+    dev::OverlayDB utxoDB;
+    {
+        LOCK(cs_main);
+        const CBlockIndex* tip = m_chainman.ActiveTip();
+        if (!tip) return true;
+        nPruneHeight = tip->nHeight - m_depth;
+        if (nPruneHeight - GetStats().pruneHeight < m_interval) return true;
+
+        for (const CBlockIndex* pindex = tip; pindex && pindex->nHeight > nPruneHeight; pindex = pindex->pprev) {
+            dev::h256 hashStateRoot = dev::EmptyTrie;
+            dev::h256 hashUTXORoot = dev::EmptyTrie;
+            if (pindex->hashStateRoot != uint256() && pindex->hashUTXORoot != uint256()) {
+                hashStateRoot = uintToh256(pindex->hashStateRoot);
+                hashUTXORoot = uintToh256(pindex->hashUTXORoot);
+            }
+            roots.emplace_back(hashStateRoot, hashUTXORoot);
+        }
+        stateDB = globalState->db();
+        utxoDB = globalState->dbUtxo();
+
+        // Blocks connected from now on may reference nodes that are not reachable from the roots above
+        pstatejournal->StateNodes().startTracking();
+        pstatejournal->UTXONodes().startTracking();
+    }
+
+    int64_t nStart = GetTimeMillis();
+    std::vector<std::pair<StateJournalKey, StateJournalEntry>> entries;
+    dev::h256Hash stateLive;
+    dev::h256Hash utxoLive;
+    size_t nStateDeleted = 0;
+    size_t nUTXODeleted = 0;
+    bool fMarked = pstatejournal->ReadEntries(nPruneHeight, entries);
+    if (fMarked) {
+        TrieMarker stateMarker(stateDB, stateLive, m_interrupt);
+        TrieMarker utxoMarker(utxoDB, utxoLive, m_interrupt);
+        for (const auto& [hashStateRoot, hashUTXORoot] : roots) {
+            if (!stateMarker.Mark(hashStateRoot, true) || !utxoMarker.Mark(hashUTXORoot, false)) {
+                fMarked = false;
+                break;
+            }
+        }
+    }
+    if (fMarked) {
+        // The state of the blocks up to the prune height is unavailable from now on, also after a restart
+        fMarked = pstatejournal->WritePruneHeight(nPruneHeight);
+    }
+    if (fMarked) {
+        {
+            LOCK(m_stats_mutex);
+            m_stats.pruneHeight = nPruneHeight;
+        }
+        dev::h256Hash stateCandidates;
+        dev::h256Hash utxoCandidates;
+        std::vector<StateJournalKey> keys;
+        for (const auto& [key, entry] : entries) {
+            for (const uint256& hash : entry.stateNodes) stateCandidates.insert(uintToh256(hash));
+            for (const uint256& hash : entry.utxoNodes) utxoCandidates.insert(uintToh256(hash));
+            keys.push_back(key);
+        }
+        nStateDeleted = stateDB.sweep(dev::h256s(stateCandidates.begin(), stateCandidates.end()), stateLive);
+        nUTXODeleted = utxoDB.sweep(dev::h256s(utxoCandidates.begin(), utxoCandidates.end()), utxoLive);
+        fMarked = pstatejournal->EraseEntries(keys);
+    }
+    pstatejournal->StateNodes().stopTracking();
+    pstatejournal->UTXONodes().stopTracking();
+
+    if (!fMarked) {
+        // An interrupted pass is simply retried on the next start
+        return static_cast<bool>(m_interrupt);
+    }
+
+    if (nStateDeleted) stateDB.compact();
+    if (nUTXODeleted) utxoDB.compact();
+
+    LogPrintf("Pruned %u contract state trie nodes of %u blocks up to height %d, %u live nodes (%dms)\n",
+        nStateDeleted + nUTXODeleted, entries.size(), nPruneHeight, stateLive.size() + utxoLive.size(), GetTimeMillis() - nStart);
+
+    LOCK(m_stats_mutex);
+    m_stats.lastPassTime = GetTime();
+    m_stats.liveNodes = stateLive.size() + utxoLive.size();
+    m_stats.garbageNodes = nStateDeleted + nUTXODeleted;
+    m_stats.prunedNodes += nStateDeleted + nUTXODeleted;
+    return true;
+}
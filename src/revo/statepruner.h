@@ -0,0 +1,77 @@
+#ifndef STATEPRUNER_H
+#define STATEPRUNER_H
+
+#include <sync.h>
+#include <threadinterrupt.h>
+
+#include <memory>
+#include <stdint.h>
+#include <thread>
+
+class ChainstateManager;
+
+/** Minimum number of prunable blocks in the state journal before a pruning pass starts */
+static const int STATE_PRUNE_INTERVAL = 500;
+
+struct StatePrunerStats
+{
+    int depth{0};
+    int pruneHeight{0};
+    int64_t lastPassTime{0};
+    uint64_t liveNodes{0};
+    uint64_t garbageNodes{0};
+    uint64_t prunedNodes{0};
+};
+
+/**
+ * Deletes the contract state and UTXO trie nodes which are not reachable any more from the
+ * hashStateRoot and hashUTXORoot of the last blocks (-prunestate).
+ * A pass runs in the background once the state journal holds enough blocks older than the
+ * prune depth: it marks every node reachable from the roots of the blocks within the depth,
+ * deletes the nodes touched by the older blocks which were not marked and compacts the database.
+ * Nodes written while the pass runs are never deleted, so blocks can be connected concurrently.
+ * The contract state of blocks older than the depth is no longer available afterwards, the
+ * pruned height is kept in the state journal. Only the nodes journaled since -statejournal was
+ * enabled are candidates, the nodes written before are never deleted.
+ */
+class StatePruner
+{
+public:
+    StatePruner(ChainstateManager& chainman, int depth, int interval = STATE_PRUNE_INTERVAL);
+    ~StatePruner();
+
+    /// Load the height pruned by the previous runs and start pruning in the background.
+    bool Start();
+    void Interrupt();
+    void Stop();
+
+    StatePrunerStats GetStats() const;
+
+    /// Whether the contract state of the block at a height may have been deleted.
+    bool IsPruned(int nHeight) const;
+
+    /// Whether the chain with its tip at nTipHeight can be rewound to the block at nHeight,
+    /// the contract state of the blocks deeper than the prune depth may be deleted by the next pass.
+    bool CanRewindTo(int nHeight, int nTipHeight) const;
+
+private:
+    void ThreadPrune();
+
+    /// Run a pruning pass if enough blocks are prunable. Returns false on error.
+    bool Prune();
+
+    ChainstateManager& m_chainman;
+    const int m_depth;
+    const int m_interval;
+
+    std::thread m_thread;
+    CThreadInterrupt m_interrupt;
+
+    mutable Mutex m_stats_mutex;
+    StatePrunerStats m_stats GUARDED_BY(m_stats_mutex);
+};
+
+/// The global state pruner, started with -prunestate. May be null.
+extern std::unique_ptr<StatePruner> g_state_pruner;
+
+#endif // STATEPRUNER_H
@@ -1,128 +1,196 @@
 #include <revo/storageresults.h>
 #include <util/convert.h>
 
-StorageResults::StorageResults(std::string const& _path){
-	path = _path + "/resultsDB";
-    leveldb::Options options;
-    options.create_if_missing = true;
-    leveldb::Status status = leveldb::DB::Open(options, path, &db);
-    assert(status.ok());
-    LogPrintf("Opened LevelDB successfully\n");
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+/** Database key of the receipts of a transaction, the hex of its hash without length prefix */
+struct ResultKey {
+    std::string hex;
+
+    explicit ResultKey(dev::h256 const& hashTx) : hex(hashTx.hex()) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const { s.write(hex.data(), hex.size()); }
+};
+
+/** Database value of the receipts of a transaction, the raw RLP of TransactionReceiptInfoSerialized */
+struct ResultValue {
+    dev::bytes rlp;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const { s.write((const char*)rlp.data(), rlp.size()); }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        rlp.resize(s.size());
+        s.read((char*)rlp.data(), rlp.size());
+    }
+};
+
+} // namespace
+
+size_t GetReceiptDBCacheSize(const ArgsManager& args)
+{
+    int64_t nCacheSize = args.GetArg("-receiptdbcache", DEFAULT_RECEIPT_DB_CACHE);
+    return std::clamp<int64_t>(nCacheSize, 0, std::numeric_limits<int64_t>::max() >> 20) << 20;
+}
+
+size_t GetReceiptCacheSize(const ArgsManager& args)
+{
+    return std::max<int64_t>(0, args.GetArg("-receiptcache", DEFAULT_RECEIPT_CACHE));
+}
+
+StorageResults::StorageResults(std::string const& _path, size_t nCacheSize, size_t nReceiptCacheSize) :
+    path(_path + "/resultsDB"),
+    cacheSize(nCacheSize),
+    db(std::make_unique<CDBWrapper>(path, nCacheSize)),
+    m_receipts_max_size(nReceiptCacheSize)
+{
 }
 
 StorageResults::~StorageResults()
 {
-    delete db;
-    db = NULL;
 }
 
 void StorageResults::addResult(dev::h256 hashTx, std::vector<TransactionReceiptInfo>& result){
+    LOCK(cs_results);
 	m_cache_result.insert(std::make_pair(hashTx, result));
 }
 
 void StorageResults::clearCacheResult(){
+    LOCK(cs_results);
     m_cache_result.clear();
 }
 
 void StorageResults::wipeResults(){
-    LogPrintf("Wiping LevelDB in %s\n", path);
-    bool opened = db;
-    if (opened) {
-        delete db;
-    }
-    leveldb::Status result = leveldb::DestroyDB(path, leveldb::Options());
-    if (opened) {
-        leveldb::Options options;
-        options.create_if_missing = true;
-        leveldb::Status status = leveldb::DB::Open(options, path, &db);
-        assert(status.ok());
-    }
+    LOCK(cs_results);
+    m_cache_result.clear();
+    m_receipts_lru.clear();
+    m_receipts.clear();
+    db.reset();
+    db = std::make_unique<CDBWrapper>(path, cacheSize, false, true);
 }
 
 void StorageResults::deleteResults(std::vector<CTransactionRef> const& txs){
-
+    LOCK(cs_results);
+    CDBBatch batch(*db);
     for(CTransactionRef tx : txs){
         dev::h256 hashTx = uintToh256(tx->GetHash());
         m_cache_result.erase(hashTx);
 
-        std::string keyTemp = hashTx.hex();
-	    leveldb::Slice key(keyTemp);
-        leveldb::Status status = db->Delete(leveldb::WriteOptions(), key);
-        assert(status.ok());
+        auto it = m_receipts.find(hashTx);
+        if(it != m_receipts.end()){
+            m_receipts_lru.erase(it->second);
+            m_receipts.erase(it);
+        }
+
+        batch.Erase(ResultKey(hashTx));
     }
+    bool ret = db->WriteBatch(batch);
+    assert(ret);
 }
 
 std::vector<TransactionReceiptInfo> StorageResults::getResult(dev::h256 const& hashTx){
-    std::vector<TransactionReceiptInfo> result;
+    LOCK(cs_results);
 	auto it = m_cache_result.find(hashTx);
-	if (it == m_cache_result.end()){
-		if(readResult(hashTx, result))
-			m_cache_result.insert(std::make_pair(hashTx, result));
-    } else {
-		result = it->second;
+	if (it != m_cache_result.end()){
+		return it->second;
+    }
+
+    auto itReceipts = m_receipts.find(hashTx);
+    if (itReceipts != m_receipts.end()){
+        m_receipts_lru.splice(m_receipts_lru.begin(), m_receipts_lru, itReceipts->second);
+        return itReceipts->second->second;
     }
+
+    std::vector<TransactionReceiptInfo> result;
+	if(readResult(hashTx, result))
+		cacheReceipts(hashTx, result);
 	return result;
 }
 
+size_t StorageResults::receiptCacheSize(){
+    LOCK(cs_results);
+    return m_receipts.size();
+}
+
+bool StorageResults::isReceiptCached(dev::h256 const& hashTx){
+    LOCK(cs_results);
+    return m_receipts.count(hashTx);
+}
+
+void StorageResults::cacheReceipts(dev::h256 const& hashTx, std::vector<TransactionReceiptInfo> const& result){
+    if(m_receipts_max_size == 0)
+        return;
+    auto it = m_receipts.find(hashTx);
+    if(it != m_receipts.end()){
+        // The receipts were written again, replace the cached ones
+        it->second->second = result;
+        m_receipts_lru.splice(m_receipts_lru.begin(), m_receipts_lru, it->second);
+        return;
+    }
+    while(m_receipts.size() >= m_receipts_max_size){
+        m_receipts.erase(m_receipts_lru.back().first);
+        m_receipts_lru.pop_back();
+    }
+    m_receipts_lru.emplace_front(hashTx, result);
+    m_receipts.emplace(hashTx, m_receipts_lru.begin());
+}
+
 void StorageResults::commitResults(){
+    LOCK(cs_results);
     if(m_cache_result.size()){
 
+        CDBBatch batch(*db);
         for (auto const& i: m_cache_result){
-            std::string valueTemp;
-            std::string keyTemp = i.first.hex();
-            leveldb::Slice key(keyTemp);
-            leveldb::Status status = db->Get(leveldb::ReadOptions(), key, &valueTemp);
-
-            if(status.IsNotFound()){
-
-                TransactionReceiptInfoSerialized tris;
-
-                for(size_t j = 0; j < i.second.size(); j++){
-                    tris.blockHashes.push_back(uintToh256(i.second[j].blockHash));
-                    tris.blockNumbers.push_back(i.second[j].blockNumber);
-                    tris.transactionHashes.push_back(uintToh256(i.second[j].transactionHash));
-                    tris.transactionIndexes.push_back(i.second[j].transactionIndex);
-                    tris.senders.push_back(i.second[j].from);
-                    tris.receivers.push_back(i.second[j].to);
-                    tris.cumulativeGasUsed.push_back(dev::u256(i.second[j].cumulativeGasUsed));
-                    tris.gasUsed.push_back(dev::u256(i.second[j].gasUsed));
-                    tris.contractAddresses.push_back(i.second[j].contractAddress);
-                    tris.logs.push_back(logEntriesSerialization(i.second[j].logs));
-                    tris.excepted.push_back(uint32_t(static_cast<int>(i.second[j].excepted)));
-                    tris.exceptedMessage.push_back(i.second[j].exceptedMessage);
-                    tris.outputIndexes.push_back(i.second[j].outputIndex);
-                    tris.blooms.push_back(i.second[j].bloom);
-                    tris.stateRoots.push_back(i.second[j].stateRoot);
-                    tris.utxoRoots.push_back(i.second[j].utxoRoot);
-                }
-
-                dev::RLPStream streamRLP(16);
-                streamRLP << tris.blockHashes << tris.blockNumbers << tris.transactionHashes << tris.transactionIndexes << tris.senders;
-                streamRLP << tris.receivers << tris.cumulativeGasUsed << tris.gasUsed << tris.contractAddresses << tris.logs << tris.excepted << tris.exceptedMessage << tris.outputIndexes << tris.blooms << tris.stateRoots << tris.utxoRoots;
-
-                dev::bytes data = streamRLP.out();
-                std::string stringData(data.begin(), data.end());
-                leveldb::Slice value(stringData);
-                status = db->Put(leveldb::WriteOptions(), key, value);
-                assert(status.ok());
+            TransactionReceiptInfoSerialized tris;
+
+            for(size_t j = 0; j < i.second.size(); j++){
+                tris.blockHashes.push_back(uintToh256(i.second[j].blockHash));
+                tris.blockNumbers.push_back(i.second[j].blockNumber);
+                tris.transactionHashes.push_back(uintToh256(i.second[j].transactionHash));
+                tris.transactionIndexes.push_back(i.second[j].transactionIndex);
+                tris.senders.push_back(i.second[j].from);
+                tris.receivers.push_back(i.second[j].to);
+                tris.cumulativeGasUsed.push_back(dev::u256(i.second[j].cumulativeGasUsed));
+                tris.gasUsed.push_back(dev::u256(i.second[j].gasUsed));
+                tris.contractAddresses.push_back(i.second[j].contractAddress);
+                tris.logs.push_back(logEntriesSerialization(i.second[j].logs));
+                tris.excepted.push_back(uint32_t(static_cast<int>(i.second[j].excepted)));
+                tris.exceptedMessage.push_back(i.second[j].exceptedMessage);
+                tris.outputIndexes.push_back(i.second[j].outputIndex);
+                tris.blooms.push_back(i.second[j].bloom);
+                tris.stateRoots.push_back(i.second[j].stateRoot);
+                tris.utxoRoots.push_back(i.second[j].utxoRoot);
             }
+
+            dev::RLPStream streamRLP(16);
+            streamRLP << tris.blockHashes << tris.blockNumbers << tris.transactionHashes << tris.transactionIndexes << tris.senders;
+            streamRLP << tris.receivers << tris.cumulativeGasUsed << tris.gasUsed << tris.contractAddresses << tris.logs << tris.excepted << tris.exceptedMessage << tris.outputIndexes << tris.blooms << tris.stateRoots << tris.utxoRoots;
+
+            ResultValue value;
+            streamRLP.swapOut(value.rlp);
+            batch.Write(ResultKey(i.first), value);
+            cacheReceipts(i.first, i.second);
         }
+        bool ret = db->WriteBatch(batch);
+        assert(ret);
         m_cache_result.clear();
     }
 }
 
 bool StorageResults::readResult(dev::h256 const& _key, std::vector<TransactionReceiptInfo>& _result){
 
-    std::string value;
-    std::string keyTemp = _key.hex();;
-    leveldb::Slice key(keyTemp);
-    leveldb::Status s = db->Get(leveldb::ReadOptions(), key, &value);
-
-	if(!s.IsNotFound() && s.ok()){
+    ResultValue value;
+	if(db->Read(ResultKey(_key), value)){
         
         TransactionReceiptInfoSerialized tris;
 
-		dev::RLP state(value);
+		dev::RLP state(value.rlp);
         tris.blockHashes = state[0].toVector<dev::h256>();
 		tris.blockNumbers = state[1].toVector<uint32_t>();
 		tris.transactionHashes = state[2].toVector<dev::h256>();
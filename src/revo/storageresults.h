@@ -2,9 +2,12 @@
 #include <primitives/transaction.h>
 #include <libethereum/State.h>
 #include <libethereum/Transaction.h>
-#include <leveldb/db.h>
+#include <dbwrapper.h>
+#include <sync.h>
 #include <util/system.h>
 
+#include <list>
+
 using logEntriesSerialize = std::vector<std::pair<dev::Address, std::pair<dev::h256s, dev::bytes>>>;
 
 struct TransactionReceiptInfo{
@@ -45,11 +48,22 @@ struct TransactionReceiptInfoSerialized{
     std::vector<dev::h256> utxoRoots;
 };
 
+/** Default for -receiptdbcache, the MiB of cache of the receipt database */
+static const int64_t DEFAULT_RECEIPT_DB_CACHE = 8;
+/** Default for -receiptcache, the number of transactions whose decoded receipts are kept in memory */
+static const int64_t DEFAULT_RECEIPT_CACHE = 10000;
+
+/** The cache size of the receipt database in bytes, set by -receiptdbcache */
+size_t GetReceiptDBCacheSize(const ArgsManager& args);
+
+/** The number of transactions whose decoded receipts are kept in memory, set by -receiptcache */
+size_t GetReceiptCacheSize(const ArgsManager& args);
+
 class StorageResults{
 
 public:
 
-	StorageResults(std::string const& _path);
+    StorageResults(std::string const& _path, size_t nCacheSize = DEFAULT_RECEIPT_DB_CACHE << 20, size_t nReceiptCacheSize = DEFAULT_RECEIPT_CACHE);
     ~StorageResults();
 
 	void addResult(dev::h256 hashTx, std::vector<TransactionReceiptInfo>& result);
@@ -64,17 +78,36 @@ public:
 
     void wipeResults();
 
+    /** Number of transactions whose decoded receipts are in memory */
+    size_t receiptCacheSize();
+
+    /** Whether the decoded receipts of a written or read transaction are in memory */
+    bool isReceiptCached(dev::h256 const& hashTx);
+
 private:
 
 	bool readResult(dev::h256 const& _key, std::vector<TransactionReceiptInfo>& _result);
 
+    /** Keep the decoded receipts of a transaction written to or read from the database in memory */
+    void cacheReceipts(dev::h256 const& hashTx, std::vector<TransactionReceiptInfo> const& result) EXCLUSIVE_LOCKS_REQUIRED(cs_results);
+
 	logEntriesSerialize logEntriesSerialization(dev::eth::LogEntries const& _logs);
 
 	dev::eth::LogEntries logEntriesDeserialize(logEntriesSerialize const& _logs);
 
 	std::string path;
 
-    leveldb::DB* db;
+    size_t cacheSize;
+
+    std::unique_ptr<CDBWrapper> db;
+
+    Mutex cs_results;
+
+    /** Receipts of the block being connected, written by commitResults */
+	std::unordered_map<dev::h256, std::vector<TransactionReceiptInfo>> m_cache_result GUARDED_BY(cs_results);
 
-	std::unordered_map<dev::h256, std::vector<TransactionReceiptInfo>> m_cache_result;
+    /** Decoded receipts of the most recently written or read transactions, most recent first */
+    std::list<std::pair<dev::h256, std::vector<TransactionReceiptInfo>>> m_receipts_lru GUARDED_BY(cs_results);
+    std::unordered_map<dev::h256, decltype(m_receipts_lru)::iterator> m_receipts GUARDED_BY(cs_results);
+    size_t m_receipts_max_size;
 };
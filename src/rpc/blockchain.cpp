@@ -16,8 +16,10 @@
 #include <deploymentinfo.h>
 #include <deploymentstatus.h>
 #include <hash.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/delegationindex.h>
 #include <node/blockstorage.h>
 #include <node/coinstats.h>
 #include <node/context.h>
@@ -49,6 +51,8 @@
 #include <txdb.h>
 #include <util/convert.h>
 #include <revo/revodelegation.h>
+#include <revo/statepruner.h>
+#include <revo/contractcall.h>
 #include <util/tokenstr.h>
 #include <rpc/contract_util.h>
 
@@ -1061,6 +1065,9 @@ static RPCHelpMan getstorage()
             if((blockNum < 0 && blockNum != -1) || blockNum > active_chain.Height())
                 throw JSONRPCError(RPC_INVALID_PARAMS, "Incorrect block number");
 
+            if(blockNum != -1 && g_state_pruner && g_state_pruner->IsPruned(blockNum))
+                throw JSONRPCError(RPC_MISC_ERROR, "Contract state of the block has been pruned");
+
             if(blockNum != -1)
                 ts.SetRoot(uintToh256(active_chain[blockNum]->hashStateRoot), uintToh256(active_chain[blockNum]->hashUTXORoot));
                 
@@ -1106,6 +1113,91 @@ static RPCHelpMan getstorage()
     };
 }
 
+static std::vector<RPCResult> NodeCacheResult()
+{
+    return {
+        {RPCResult::Type::NUM, "usage", "the memory used by the cached nodes in bytes"},
+        {RPCResult::Type::NUM, "maxusage", "the maximum memory used by the cached nodes in bytes"},
+        {RPCResult::Type::NUM, "hits", "the number of node reads served by the cache since startup"},
+        {RPCResult::Type::NUM, "misses", "the number of node reads from the database since startup"},
+        {RPCResult::Type::NUM, "hitrate", "the share of the node reads served by the cache"},
+    };
+}
+
+static UniValue NodeCacheToJSON(const dev::NodeCache& cache)
+{
+    UniValue ret(UniValue::VOBJ);
+    const uint64_t hits = cache.hits();
+    const uint64_t misses = cache.misses();
+    ret.pushKV("usage", (uint64_t)cache.usage());
+    ret.pushKV("maxusage", (uint64_t)cache.maxUsage());
+    ret.pushKV("hits", hits);
+    ret.pushKV("misses", misses);
+    ret.pushKV("hitrate", hits + misses ? (double)hits / (hits + misses) : 0.0);
+    return ret;
+}
+
+static RPCHelpMan getstateinfo()
+{
+    return RPCHelpMan{"getstateinfo",
+                "\nReturns information about the contract state journal and pruning (-statejournal, -prunestate).\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::BOOL, "journal", "whether the trie nodes touched by each block are journaled"},
+                        {RPCResult::Type::NUM, "journalblocks", /* optional */ true, "the number of blocks in the journal"},
+                        {RPCResult::Type::BOOL, "pruning", "whether the contract state is pruned"},
+                        {RPCResult::Type::NUM, "depth", /* optional */ true, "the number of blocks for which the contract state is kept"},
+                        {RPCResult::Type::NUM, "pruneheight", /* optional */ true, "the height up to which the contract state has been pruned"},
+                        {RPCResult::Type::NUM_TIME, "lastpass", /* optional */ true, "the time of the last pruning pass in " + UNIX_EPOCH_TIME},
+                        {RPCResult::Type::NUM, "livenodes", /* optional */ true, "the number of trie nodes reachable from the kept state roots in the last pass"},
+                        {RPCResult::Type::NUM, "garbagenodes", /* optional */ true, "the number of unreachable trie nodes deleted by the last pass"},
+                        {RPCResult::Type::NUM, "prunednodes", /* optional */ true, "the number of trie nodes deleted since startup"},
+                        {RPCResult::Type::OBJ, "cache", /* optional */ true, "the trie node caches, if -statecache is enabled",
+                        {
+                            {RPCResult::Type::OBJ, "state", "the node cache of the state trie", NodeCacheResult()},
+                            {RPCResult::Type::OBJ, "utxo", "the node cache of the UTXO trie", NodeCacheResult()},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getstateinfo", "")
+            + HelpExampleRpc("getstateinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    UniValue result(UniValue::VOBJ);
+    {
+        LOCK(cs_main);
+        result.pushKV("journal", pstatejournal != nullptr);
+        if (pstatejournal) {
+            result.pushKV("journalblocks", (uint64_t)pstatejournal->CountEntries());
+        }
+    }
+    result.pushKV("pruning", g_state_pruner != nullptr);
+    if (g_state_pruner) {
+        StatePrunerStats stats = g_state_pruner->GetStats();
+        result.pushKV("depth", stats.depth);
+        result.pushKV("pruneheight", stats.pruneHeight);
+        result.pushKV("lastpass", stats.lastPassTime);
+        result.pushKV("livenodes", stats.liveNodes);
+        result.pushKV("garbagenodes", stats.garbageNodes);
+        result.pushKV("prunednodes", stats.prunedNodes);
+    }
+    {
+        LOCK(cs_main);
+        if (globalState && globalState->db().nodeCache()) {
+            UniValue cache(UniValue::VOBJ);
+            cache.pushKV("state", NodeCacheToJSON(*globalState->db().nodeCache()));
+            cache.pushKV("utxo", NodeCacheToJSON(*globalState->dbUtxo().nodeCache()));
+            result.pushKV("cache", cache);
+        }
+    }
+    return result;
+},
+    };
+}
+
 static RPCHelpMan getblockheader()
 {
     return RPCHelpMan{"getblockheader",
@@ -1360,6 +1452,48 @@ RPCHelpMan callcontract()
     };
 }
 
+RPCHelpMan callcontractbatch()
+{
+    return RPCHelpMan{"callcontractbatch",
+                "\nCall several contract methods offline, like callcontract, on the same state and in the same block.\n"
+                "The calls do not see the changes of each other. The results are returned in the order of the calls.\n",
+                {
+                    {"calls", RPCArg::Type::ARR, RPCArg::Optional::NO, "The calls, at most " + ToString(MAX_CALLCONTRACT_BATCH),
+                        {
+                            {"", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED, "",
+                                {
+                                    {"address", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The contract address, or empty address \"\""},
+                                    {"data", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The data hex string"},
+                                    {"senderaddress", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "The sender address string"},
+                                    {"gaslimit", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "The gas limit for executing the contract."},
+                                    {"amount", RPCArg::Type::AMOUNT, RPCArg::Optional::OMITTED, "The amount in " + CURRENCY_UNIT + " to send. eg 0.1, default: 0"},
+                                },
+                            },
+                        },
+                    },
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "blockhash", "The hash of the block the calls were executed on top of"},
+                        {RPCResult::Type::NUM, "height", "The height of that block"},
+                        {RPCResult::Type::ARR, "results", "The results of the calls, as returned by callcontract",
+                        {
+                            {RPCResult::Type::ELISION, "", ""},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("callcontractbatch", "'[{\"address\":\"eb23c0b3e6042821da281a2e2364feb22dd543e3\",\"data\":\"06fdde03\"},{\"address\":\"eb23c0b3e6042821da281a2e2364feb22dd543e3\",\"data\":\"95d89b41\"}]'")
+            + HelpExampleRpc("callcontractbatch", "[{\"address\":\"eb23c0b3e6042821da281a2e2364feb22dd543e3\",\"data\":\"06fdde03\"},{\"address\":\"eb23c0b3e6042821da281a2e2364feb22dd543e3\",\"data\":\"95d89b41\"}]")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    return CallToContractBatch(request.params, chainman);
+},
+    };
+}
+
 class WaitForLogsParams {
 public:
     int fromBlock;
@@ -1480,7 +1614,7 @@ RPCHelpMan waitforlogs()
         {
             LOCK(cs_main);
             curheight = pblocktree->ReadHeightIndex(params.fromBlock, params.toBlock, params.minconf,
-                    hashesToBlock, addresses, chainman);
+                    hashesToBlock, addresses, filterTopics, chainman);
         }
 
         // if curheight >= fromBlock. Blockchain extended with new log entries. Return next block height to client.
@@ -1651,6 +1785,58 @@ RPCHelpMan searchlogs()
     };
 }
 
+RPCHelpMan searchlogspage()
+{
+    return RPCHelpMan{"searchlogspage",
+                "\nSearch logs a page at a time, requires -logevents to be enabled.\n"
+                "Returns at most limit receipts, in block order, and a cursor if more receipts match. Pass the cursor\n"
+                "with the same parameters to get the next page. The index is read from a snapshot, without blocking validation.\n",
+                {
+                    {"fromblock", RPCArg::Type::NUM, RPCArg::Optional::NO, "The number of the earliest block (latest may be given to mean the most recent block)."},
+                    {"toblock", RPCArg::Type::NUM, RPCArg::Optional::NO, "The number of the latest block (-1 may be given to mean the most recent block)."},
+                    {"addressfilter", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED_NAMED_ARG, "Addresses filter conditions for logs.",
+                    {
+                        {"addresses", RPCArg::Type::ARR, RPCArg::Optional::OMITTED, "An address or a list of addresses to only get logs from particular account(s).",
+                            {
+                                {"address", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, ""},
+                            },
+                        },
+                    }},
+                    {"topicfilter", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED_NAMED_ARG, "Topics filter conditions for logs.",
+                    {
+                        {"topics", RPCArg::Type::ARR, RPCArg::Optional::OMITTED, "An array of values from which at least one must appear in the log entries. The order is important, if you want to leave topics out use null, e.g. [null, \"0x00...\"].",
+                            {
+                                {"topic", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, ""},
+                            },
+                        },
+                    }},
+                    {"minconf", RPCArg::Type::NUM, RPCArg::Default{0}, "Minimal number of confirmations before a log is returned"},
+                    {"limit", RPCArg::Type::NUM, RPCArg::Default{(int)DEFAULT_SEARCHLOGS_PAGE_SIZE}, "The maximum number of receipts returned, at most " + ToString(MAX_SEARCHLOGS_PAGE_SIZE)},
+                    {"cursor", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED_NAMED_ARG, "The cursor returned by the previous page"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "entries", "The matching receipts, as returned by searchlogs",
+                        {
+                            {RPCResult::Type::ELISION, "", ""},
+                        }},
+                        {RPCResult::Type::NUM, "count", "The number of receipts returned"},
+                        {RPCResult::Type::STR_HEX, "cursor", /* optional */ true, "The cursor of the next page, omitted on the last page"},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("searchlogspage", "0 100 '{\"addresses\": [\"12ae42729af478ca92c8c66773a3e32115717be4\"]}' '{}' 0 500")
+            + HelpExampleRpc("searchlogspage", "0 100 {\"addresses\": [\"12ae42729af478ca92c8c66773a3e32115717be4\"]} {} 0 500")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    return SearchLogsPage(request.params, chainman);
+},
+    };
+}
+
 RPCHelpMan gettransactionreceipt()
 {
     return RPCHelpMan{"gettransactionreceipt",
@@ -1815,7 +2001,8 @@ RPCHelpMan getdelegationsforstaker()
 {
     return RPCHelpMan{"getdelegationsforstaker",
                 "requires -logevents to be enabled\n"
-                "\nGet the current list of delegates for a super staker.\n",
+                "\nGet the current list of delegates for a super staker.\n"
+                "The delegations are read from the delegation index when -delegationindex is enabled.\n",
                 {
                     {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The revo address string for staker"},
                 },
@@ -1828,7 +2015,7 @@ RPCHelpMan getdelegationsforstaker()
                             {RPCResult::Type::STR, "staker", "The staker address"},
                             {RPCResult::Type::NUM, "fee", "The percentage of the reward"},
                             {RPCResult::Type::NUM, "blockHeight", "The block height"},
-                            {RPCResult::Type::NUM, "weight", "Delegate weight, displayed when address index is enabled"},
+                            {RPCResult::Type::NUM, "weight", "Delegate weight, displayed when the address index is enabled and synced"},
                             {RPCResult::Type::STR_HEX, "PoD", "The proof of delegation"},
                         }}
                 }},
@@ -1842,6 +2029,10 @@ RPCHelpMan getdelegationsforstaker()
     if (!fLogEvents)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Events indexing disabled");
 
+    const bool fDelegationIndex = g_delegation_index && g_delegation_index->BlockUntilSyncedToCurrentChain();
+    // The weight of the delegates is read from the address index, it is left out until the index is synced
+    const bool fAddressIndexReady = g_address_index && g_address_index->BlockUntilSyncedToCurrentChain();
+
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
     LOCK(cs_main);
 
@@ -1858,15 +2049,22 @@ RPCHelpMan getdelegationsforstaker()
     }
 
     // Get delegations for staker
-    RevoDelegation revoDelegation;
-    std::vector<DelegationEvent> events;
     PKHash pkhash = std::get<PKHash>(dest);
     uint160 address = uint160(pkhash);
-    DelegationsStakerFilter filter(address);
-    if(!revoDelegation.FilterDelegationEvents(events, filter, chainman)) {
-        throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to get delegations for staker");
+    std::map<uint160, Delegation> delegations;
+    if(fDelegationIndex) {
+        if(!g_delegation_index->LookUpDelegationsForStaker(address, delegations)) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to get delegations for staker");
+        }
+    } else {
+        RevoDelegation revoDelegation;
+        std::vector<DelegationEvent> events;
+        DelegationsStakerFilter filter(address);
+        if(!revoDelegation.FilterDelegationEvents(events, filter, chainman)) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to get delegations for staker");
+        }
+        delegations = revoDelegation.DelegationsFromEvents(events);
     }
-    std::map<uint160, Delegation> delegations = revoDelegation.DelegationsFromEvents(events);
 
     // Get chain parameters
     std::map<COutPoint, uint32_t> immatureStakes = GetImmatureStakes(chainman);
@@ -1880,7 +2078,7 @@ RPCHelpMan getdelegationsforstaker()
         delegation.pushKV("staker", EncodeDestination(PKHash(it->second.staker)));
         delegation.pushKV("fee", (int64_t)it->second.fee);
         delegation.pushKV("blockHeight", (int64_t)it->second.blockHeight);
-        if(fAddressIndex)
+        if(fAddressIndexReady)
         {
             delegation.pushKV("weight", getDelegateWeight(it->first, immatureStakes, height));
         }
@@ -2748,6 +2946,14 @@ static RPCHelpMan preciousblock()
     };
 }
 
+/** Throw if the contract state of the block the active chain would be rewound to may be pruned */
+static void EnsureStateRewindable(const CChain& active_chain, const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    if (g_state_pruner && !g_state_pruner->CanRewindTo(pindex->nHeight, active_chain.Height())) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Cannot rewind the chain to block %d, its contract state is deeper than -prunestate=%d blocks and may be pruned", pindex->nHeight, g_state_pruner->GetStats().depth));
+    }
+}
+
 static RPCHelpMan invalidateblock()
 {
     return RPCHelpMan{"invalidateblock",
@@ -2773,6 +2979,9 @@ static RPCHelpMan invalidateblock()
         if (!pblockindex) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
         }
+        if (pblockindex->pprev && chainman.ActiveChain().Contains(pblockindex)) {
+            EnsureStateRewindable(chainman.ActiveChain(), pblockindex->pprev);
+        }
     }
     chainman.ActiveChainstate().InvalidateBlock(state, pblockindex);
 
@@ -2813,6 +3022,10 @@ static RPCHelpMan reconsiderblock()
         if (!pblockindex) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
         }
+        const CBlockIndex* pfork = chainman.ActiveChain().FindFork(pblockindex);
+        if (pfork && pfork != chainman.ActiveChain().Tip()) {
+            EnsureStateRewindable(chainman.ActiveChain(), pfork);
+        }
 
         chainman.ActiveChainstate().ResetBlockFailureFlags(pblockindex);
     }
@@ -3992,12 +4205,14 @@ static const CRPCCommand commands[] =
     { "blockchain",         &exportchain,                        },
     { "blockchain",         &getaccountinfo,                     },
     { "blockchain",         &getstorage,                         },
+    { "blockchain",         &getstateinfo,                       },
 
     { "blockchain",         &preciousblock,                      },
     { "blockchain",         &scantxoutset,                       },
     { "blockchain",         &getblockfilter,                     },
 
     { "blockchain",         &callcontract,                       },
+    { "blockchain",         &callcontractbatch,                  },
 
     { "blockchain",         &erc20name,                          },
     { "blockchain",         &erc20symbol,                        },
@@ -4010,6 +4225,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         &listcontracts,                      },
     { "blockchain",         &gettransactionreceipt,              },
     { "blockchain",         &searchlogs,                         },
+    { "blockchain",         &searchlogspage,                     },
 
     { "blockchain",         &waitforlogs,                        },
     { "blockchain",         &getestimatedannualroi,              },
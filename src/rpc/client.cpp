@@ -111,6 +111,12 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "searchlogs", 2, "addressfilter"},
     { "searchlogs", 3, "topicfilter"},
     { "searchlogs", 4, "minconf"},
+    { "searchlogspage", 0, "fromblock"},
+    { "searchlogspage", 1, "toblock"},
+    { "searchlogspage", 2, "addressfilter"},
+    { "searchlogspage", 3, "topicfilter"},
+    { "searchlogspage", 4, "minconf"},
+    { "searchlogspage", 5, "limit"},
     { "waitforlogs", 0, "fromblock"},
     { "waitforlogs", 1, "toblock"},
     { "waitforlogs", 2, "filter"},
@@ -242,6 +248,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "erc20burnfrom", 6, "checkoutputs" },
     { "callcontract", 3, "gaslimit" },
     { "callcontract", 4, "amount" },
+    { "callcontractbatch", 0, "calls" },
     { "reservebalance", 0, "reserve"},
     { "reservebalance", 1, "amount"},
     { "listcontracts", 0, "start" },
@@ -1,9 +1,15 @@
 #include <rpc/contract_util.h>
 #include <rpc/util.h>
+#include <revo/contractcall.h>
 #include <util/system.h>
 #include <key_io.h>
 #include <rpc/server.h>
 #include <txdb.h>
+#include <streams.h>
+#include <util/strencodings.h>
+
+#include <optional>
+#include <tuple>
 
 UniValue executionResultToJSON(const dev::eth::ExecutionResult& exRes)
 {
@@ -46,62 +52,118 @@ UniValue transactionReceiptToJSON(const RevoTransactionReceipt& txRec)
     return result;
 }
 
-UniValue CallToContract(const UniValue& params, ChainstateManager &chainman)
+static ContractCall ParseContractCall(const ContractCallSnapshot& snapshot, const std::string& strAddr, const std::string& data, const UniValue& sender, const UniValue& gasLimit, const UniValue& amount)
 {
-    LOCK(cs_main);
-
-    std::string strAddr = params[0].get_str();
-    std::string data = params[1].get_str();
-
+    ContractCall call;
     if(data.size() % 2 != 0 || !CheckHex(data))
         throw JSONRPCError(RPC_TYPE_ERROR, "Invalid data (data not hex)");
+    call.opcode = ParseHex(data);
 
-    dev::Address addrAccount;
     if(strAddr.size() > 0)
     {
         if(strAddr.size() != 40 || !CheckHex(strAddr))
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Incorrect address");
 
-        addrAccount = dev::Address(strAddr);
-        if(!globalState->addressInUse(addrAccount))
+        call.addrContract = dev::Address(strAddr);
+        if(!snapshot.AddressInUse(call.addrContract))
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Address does not exist");
     }
 
-    dev::Address senderAddress;
-    if(!params[2].isNull()){
-        CTxDestination revoSenderAddress = DecodeDestination(params[2].get_str());
+    if(!sender.isNull()){
+        CTxDestination revoSenderAddress = DecodeDestination(sender.get_str());
         if (IsValidDestination(revoSenderAddress)) {
             PKHash keyid = std::get<PKHash>(revoSenderAddress);
-            senderAddress = dev::Address(HexStr(valtype(keyid.begin(),keyid.end())));
+            call.sender = dev::Address(HexStr(valtype(keyid.begin(),keyid.end())));
         }else{
-            senderAddress = dev::Address(params[2].get_str());
+            call.sender = dev::Address(sender.get_str());
         }
 
     }
-    uint64_t gasLimit=0;
-    if(!params[3].isNull()){
-        gasLimit = params[3].get_int64();
+    if(!gasLimit.isNull()){
+        call.gasLimit = gasLimit.get_int64();
     }
 
-    CAmount nAmount = 0;
-    if (!params[4].isNull()){
-        nAmount = AmountFromValue(params[4]);
-        if (nAmount < 0)
+    if (!amount.isNull()){
+        call.nAmount = AmountFromValue(amount);
+        if (call.nAmount < 0)
             throw JSONRPCError(RPC_TYPE_ERROR, "Invalid amount for send");
     }
+    return call;
+}
+
+static UniValue ContractCallToJSON(const std::string& strAddr, const ResultExecute& execResult)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("address", strAddr);
+    result.pushKV("executionResult", executionResultToJSON(execResult.execRes));
+    result.pushKV("transactionReceipt", transactionReceiptToJSON(execResult.txRec));
+    return result;
+}
+
+UniValue CallToContract(const UniValue& params, ChainstateManager &chainman)
+{
+    // Read-only calls run on a snapshot of the tip, without holding cs_main
+    std::shared_ptr<const ContractCallSnapshot> snapshot = g_contract_caller.GetSnapshot(chainman.ActiveChainstate());
 
+    std::string strAddr = params[0].get_str();
+    ContractCall call = ParseContractCall(*snapshot, strAddr, params[1].get_str(), params[2], params[3], params[4]);
 
-    std::vector<ResultExecute> execResults = CallContract(addrAccount, ParseHex(data), chainman.ActiveChainstate(), senderAddress, gasLimit, nAmount);
+    std::vector<ResultExecute> execResults = g_contract_caller.Call(*snapshot, std::vector<ContractCall>(1, call));
 
     if(fRecordLogOpcodes){
+        LOCK(cs_main);
         writeVMlog(execResults, chainman.ActiveChain());
     }
 
-    UniValue result(UniValue::VOBJ);
-    result.pushKV("address", strAddr);
-    result.pushKV("executionResult", executionResultToJSON(execResults[0].execRes));
-    result.pushKV("transactionReceipt", transactionReceiptToJSON(execResults[0].txRec));
+    return ContractCallToJSON(strAddr, execResults[0]);
+}
+
+UniValue CallToContractBatch(const UniValue& params, ChainstateManager &chainman)
+{
+    const UniValue& calls = params[0].get_array();
+    if(calls.size() > MAX_CALLCONTRACT_BATCH)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Too many calls, the maximum is %u", MAX_CALLCONTRACT_BATCH));
+
+    // All the calls are executed on the same snapshot of the tip
+    std::shared_ptr<const ContractCallSnapshot> snapshot = g_contract_caller.GetSnapshot(chainman.ActiveChainstate());
+
+    std::vector<std::string> addresses;
+    std::vector<ContractCall> batch;
+    for(size_t i = 0; i < calls.size(); i++){
+        const UniValue& call = calls[i].get_obj();
+        RPCTypeCheckObj(call,
+            {
+                {"address", UniValueType(UniValue::VSTR)},
+                {"data", UniValueType(UniValue::VSTR)},
+                {"senderaddress", UniValueType(UniValue::VSTR)},
+                {"gaslimit", UniValueType(UniValue::VNUM)},
+                {"amount", UniValueType()}, // NUM or STR
+            }, true, true);
+        if(call["data"].isNull())
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Call %u: Missing data", i));
+        try {
+            addresses.push_back(call["address"].isNull() ? "" : call["address"].get_str());
+            batch.push_back(ParseContractCall(*snapshot, addresses.back(), call["data"].get_str(), call["senderaddress"], call["gaslimit"], call["amount"]));
+        } catch (const UniValue& objError) {
+            throw JSONRPCError(find_value(objError, "code").get_int(), strprintf("Call %u: %s", i, find_value(objError, "message").get_str()));
+        }
+    }
+
+    std::vector<ResultExecute> execResults = g_contract_caller.Call(*snapshot, batch);
+
+    if(fRecordLogOpcodes){
+        LOCK(cs_main);
+        writeVMlog(execResults, chainman.ActiveChain());
+    }
 
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("blockhash", snapshot->hashBlock.GetHex());
+    result.pushKV("height", snapshot->nHeight);
+    UniValue results(UniValue::VARR);
+    for(size_t i = 0; i < execResults.size(); i++){
+        results.push_back(ContractCallToJSON(addresses[i], execResults[i]));
+    }
+    result.pushKV("results", results);
     return result;
 }
 
@@ -310,6 +372,34 @@ private:
 
 };
 
+/** Whether a receipt has a log with one of the non-null topics at its position, or any log if there are no topics */
+static bool MatchesTopics(const TransactionReceiptInfo& receipt, const std::vector<boost::optional<dev::h256>>& topics)
+{
+    if (receipt.logs.empty()) {
+        return false;
+    }
+
+    if (topics.empty()) {
+        return true;
+    }
+
+    for (size_t i = 0; i < topics.size(); i++) {
+        const auto& tc = topics[i];
+
+        if (!tc) {
+            continue;
+        }
+
+        for (const auto& log: receipt.logs) {
+            if (i < log.topics.size() && tc.get() == log.topics[i]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 UniValue SearchLogs(const UniValue& _params, ChainstateManager &chainman)
 {
     if(!fLogEvents)
@@ -323,7 +413,7 @@ UniValue SearchLogs(const UniValue& _params, ChainstateManager &chainman)
 
     std::vector<std::vector<uint256>> hashesToBlock;
 
-    curheight = pblocktree->ReadHeightIndex(params.fromBlock, params.toBlock, params.minconf, hashesToBlock, params.addresses, chainman);
+    curheight = pblocktree->ReadHeightIndex(params.fromBlock, params.toBlock, params.minconf, hashesToBlock, params.addresses, params.topics, chainman);
 
     if (curheight == -1) {
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Incorrect params");
@@ -348,44 +438,149 @@ UniValue SearchLogs(const UniValue& _params, ChainstateManager &chainman)
             std::vector<TransactionReceiptInfo> receipts = pstorageresult->getResult(uintToh256(e));
 
             for(const auto& receipt : receipts) {
-                if(receipt.logs.empty()) {
+                if (!MatchesTopics(receipt, topics)) {
                     continue;
                 }
 
-                if (!topics.empty()) {
-                    for (size_t i = 0; i < topics.size(); i++) {
-                        const auto& tc = topics[i];
+                UniValue tri(UniValue::VOBJ);
+                transactionReceiptInfoToJSON(receipt, tri);
+                result.push_back(tri);
+            }
+        }
+    }
+
+    return result;
+}
 
-                        if (!tc) {
-                            continue;
-                        }
+/** Position of a receipt in the chain, the continuation point of searchlogspage */
+struct SearchLogsCursor {
+    uint32_t height{0};
+    uint32_t txIndex{0};
+    //! Index of the receipt among the receipts of its transaction
+    uint32_t receiptIndex{0};
 
-                        for (const auto& log: receipt.logs) {
-                            auto filterTopicContent = tc.get();
+    SERIALIZE_METHODS(SearchLogsCursor, obj) { READWRITE(obj.height, obj.txIndex, obj.receiptIndex); }
 
-                            if (i >= log.topics.size()) {
-                                continue;
-                            }
+    friend bool operator<(const SearchLogsCursor& a, const SearchLogsCursor& b)
+    {
+        return std::tie(a.height, a.txIndex, a.receiptIndex) < std::tie(b.height, b.txIndex, b.receiptIndex);
+    }
+};
 
-                            if (filterTopicContent == log.topics[i]) {
-                                goto push;
-                            }
-                        }
-                    }
+static std::string EncodeSearchLogsCursor(const SearchLogsCursor& cursor)
+{
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << cursor;
+    return HexStr(ss);
+}
+
+static SearchLogsCursor DecodeSearchLogsCursor(const std::string& str)
+{
+    SearchLogsCursor cursor;
+    if (!IsHex(str)) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+    CDataStream ss(ParseHex(str), SER_NETWORK, PROTOCOL_VERSION);
+    try {
+        ss >> cursor;
+    } catch (const std::exception&) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+    if (!ss.empty()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+    return cursor;
+}
+
+UniValue SearchLogsPage(const UniValue& _params, ChainstateManager &chainman)
+{
+    if(!fLogEvents)
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Events indexing disabled");
 
-                    // Skip the log if none of the topics are matched
+    SearchLogsParams params(_params);
+
+    size_t limit = parseUInt(_params[5], DEFAULT_SEARCHLOGS_PAGE_SIZE);
+    if (limit == 0 || limit > MAX_SEARCHLOGS_PAGE_SIZE) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("limit must be between 1 and %u", MAX_SEARCHLOGS_PAGE_SIZE));
+    }
+
+    std::optional<SearchLogsCursor> resume;
+    if (!_params[6].isNull()) {
+        resume = DecodeSearchLogsCursor(_params[6].get_str());
+    }
+
+    unsigned int low = params.fromBlock;
+    unsigned int high = params.toBlock;
+    if (high < low || high == 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Incorrect params");
+    }
+
+    UniValue entries(UniValue::VARR);
+    std::optional<SearchLogsCursor> next;
+
+    bool fEmpty = false;
+    if (params.minconf > 0) {
+        int maxHeight = WITH_LOCK(cs_main, return chainman.ActiveChain().Height()) - (int)params.minconf;
+        fEmpty = maxHeight < (int)low;
+        high = std::min<int>(high, maxHeight);
+    }
+    if (resume) {
+        if (resume->height < low || resume->height > params.toBlock) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor out of the block range");
+        }
+        low = resume->height;
+        fEmpty |= low > high;
+    }
+
+    if (!fEmpty) {
+        // Read the index from a snapshot so that new blocks can be connected while the page is built
+        CDBWrapper::Snapshot snapshot(*pblocktree);
+        std::optional<SearchLogsCursor> last;
+        pblocktree->ReadHeightIndexBlocks(snapshot, low, high, params.addresses, params.topics,
+                [&](unsigned int height, const std::vector<uint256>& hashesTx) {
+            std::vector<TransactionReceiptInfo> receipts;
+            for (const uint256& hashTx : hashesTx) {
+                for (TransactionReceiptInfo& receipt : pstorageresult->getResult(uintToh256(hashTx))) {
+                    // The receipts may be newer than the snapshot after a reorg
+                    if (receipt.blockNumber == height) {
+                        receipts.push_back(std::move(receipt));
+                    }
+                }
+            }
+            // Receipts of a transaction are stored in output order
+            std::stable_sort(receipts.begin(), receipts.end(), [](const TransactionReceiptInfo& a, const TransactionReceiptInfo& b) {
+                return a.transactionIndex < b.transactionIndex;
+            });
+
+            SearchLogsCursor pos{height, 0, 0};
+            for (size_t i = 0; i < receipts.size(); i++) {
+                const TransactionReceiptInfo& receipt = receipts[i];
+                pos.receiptIndex = (i > 0 && receipt.transactionIndex == pos.txIndex) ? pos.receiptIndex + 1 : 0;
+                pos.txIndex = receipt.transactionIndex;
+
+                if ((resume && !(*resume < pos)) || !MatchesTopics(receipt, params.topics)) {
                     continue;
                 }
-
-            push:
+                if (entries.size() == limit) {
+                    next = last;
+                    return false;
+                }
 
                 UniValue tri(UniValue::VOBJ);
                 transactionReceiptInfoToJSON(receipt, tri);
-                result.push_back(tri);
+                entries.push_back(tri);
+                last = pos;
             }
-        }
+            return true;
+        });
     }
 
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("entries", entries);
+    result.pushKV("count", (int) entries.size());
+    if (next) {
+        result.pushKV("cursor", EncodeSearchLogsCursor(*next));
+    }
     return result;
 }
 
@@ -9,8 +9,16 @@ class ChainstateManager;
 
 UniValue CallToContract(const UniValue& params, ChainstateManager &chainman);
 
+UniValue CallToContractBatch(const UniValue& params, ChainstateManager &chainman);
+
 UniValue SearchLogs(const UniValue& params, ChainstateManager &chainman);
 
+/** Default and maximum number of receipts returned by a page of searchlogspage */
+static const size_t DEFAULT_SEARCHLOGS_PAGE_SIZE = 1000;
+static const size_t MAX_SEARCHLOGS_PAGE_SIZE = 10000;
+
+UniValue SearchLogsPage(const UniValue& params, ChainstateManager &chainman);
+
 void assignJSON(UniValue& entry, const TransactionReceiptInfo& resExec);
 
 void assignJSON(UniValue& logEntry, const dev::eth::LogEntry& log,
@@ -449,6 +449,8 @@ static RPCHelpMan getmininginfo()
                         {RPCResult::Type::NUM, "blocks", "The current block"},
                         {RPCResult::Type::NUM, "currentblockweight", /* optional */ true, "The block weight of the last assembled block (only present if a block was ever assembled)"},
                         {RPCResult::Type::NUM, "currentblocktx", /* optional */ true, "The number of block transactions of the last assembled block (only present if a block was ever assembled)"},
+                        {RPCResult::Type::NUM, "currentblockgasused", /* optional */ true, "The gas used by the contracts of the last assembled block (only present if a block was ever assembled)"},
+                        {RPCResult::Type::NUM, "currentblockfeepergas", /* optional */ true, "The fees paid by the contract transactions of the last assembled block after refunds, in " + CURRENCY_ATOM + " per gas used (only present if the block used gas)"},
                         {RPCResult::Type::NUM, "difficulty", "The current difficulty"},
                         {RPCResult::Type::NUM, "networkhashps", "The network hashes per second"},
                         {RPCResult::Type::NUM, "pooledtx", "The size of the mempool"},
@@ -488,6 +490,12 @@ static RPCHelpMan getmininginfo()
     obj.pushKV("blocks",           active_chain.Height());
     if (BlockAssembler::m_last_block_weight) obj.pushKV("currentblockweight", *BlockAssembler::m_last_block_weight);
     if (BlockAssembler::m_last_block_num_txs) obj.pushKV("currentblocktx", *BlockAssembler::m_last_block_num_txs);
+    if (BlockAssembler::m_last_block_gas_used) {
+        obj.pushKV("currentblockgasused", *BlockAssembler::m_last_block_gas_used);
+        if (*BlockAssembler::m_last_block_gas_used && BlockAssembler::m_last_block_gas_fees) {
+            obj.pushKV("currentblockfeepergas", double(*BlockAssembler::m_last_block_gas_fees) / *BlockAssembler::m_last_block_gas_used);
+        }
+    }
 
     diff.pushKV("proof-of-work",   GetDifficulty(GetLastBlockIndex(pindexBestHeader, false)));
     diff.pushKV("proof-of-stake",  GetDifficulty(GetLastBlockIndex(pindexBestHeader, true)));
@@ -529,6 +537,7 @@ static RPCHelpMan getstakinginfo()
                         {RPCResult::Type::NUM, "pooledtx", "The size of the mempool"},
                         {RPCResult::Type::NUM, "difficulty", "The current difficulty"},
                         {RPCResult::Type::NUM, "search-interval", "The staker search interval"},
+                        {RPCResult::Type::NUM, "kernelspersecond", "The number of stake kernels checked per second in the last search"},
                         {RPCResult::Type::NUM, "weight", "The staker weight"},
                         {RPCResult::Type::NUM, "netstakeweight", "Network stake weight"},
                         {RPCResult::Type::NUM, "expectedtime", "Expected time to earn reward"},
@@ -547,6 +556,7 @@ static RPCHelpMan getstakinginfo()
     uint64_t nStakerWeight = 0;
     uint64_t nDelegateWeight = 0;
     uint64_t lastCoinStakeSearchInterval = 0;
+    uint64_t nKernelsPerSecond = 0;
     bool staking_enabled = false;
 #ifdef ENABLE_WALLET
     std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
@@ -558,6 +568,7 @@ static RPCHelpMan getstakinginfo()
         nWeight = pwallet->GetStakeWeight(&nStakerWeight, &nDelegateWeight);
         lastCoinStakeSearchInterval = pwallet->m_enabled_staking ? pwallet->m_last_coin_stake_search_interval : 0;
         staking_enabled = pwallet->m_enabled_staking;
+        nKernelsPerSecond = staking_enabled ? pwallet->m_stake_kernels_per_second.load() : 0;
     }
 #endif
 
@@ -582,6 +593,7 @@ static RPCHelpMan getstakinginfo()
 
     obj.pushKV("difficulty", GetDifficulty(GetLastBlockIndex(pindexBestHeader, true)));
     obj.pushKV("search-interval", (int)lastCoinStakeSearchInterval);
+    obj.pushKV("kernelspersecond", nKernelsPerSecond);
 
     obj.pushKV("weight", (uint64_t)nStakerWeight);
     obj.pushKV("delegateweight", (uint64_t)nDelegateWeight);
@@ -3,15 +3,20 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <clientversion.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/delegationindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
 #include <interfaces/init.h>
 #include <interfaces/ipc.h>
 #include <key_io.h>
+#include <libevm/AnalysisCache.h>
+#include <libethereum/CodeCache.h>
 #include <node/context.h>
 #include <outputtype.h>
 #include <rpc/blockchain.h>
@@ -19,6 +24,7 @@
 #include <rpc/util.h>
 #include <scheduler.h>
 #include <script/descriptor.h>
+#include <streams.h>
 #include <util/check.h>
 #include <util/message.h> // For MessageSign(), MessageVerify()
 #include <util/strencodings.h>
@@ -172,6 +178,72 @@ bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> a,
     return a.second.time < b.second.time;
 }
 
+/** The page of address index entries requested with the limit, cursor and reverse parameters */
+struct AddressIndexPage
+{
+    int limit{0}; //!< no limit if zero
+    bool fReverse{false};
+    std::optional<CAddressIndexKey> after;
+};
+
+static AddressIndexPage getAddressIndexPageFromParams(const UniValue& params)
+{
+    AddressIndexPage page;
+    if (!params[0].isObject()) {
+        return page;
+    }
+
+    UniValue limitValue = find_value(params[0].get_obj(), "limit");
+    if (!limitValue.isNull()) {
+        page.limit = limitValue.get_int();
+        if (page.limit <= 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Limit is expected to be greater than zero");
+        }
+    }
+
+    UniValue reverseValue = find_value(params[0].get_obj(), "reverse");
+    if (!reverseValue.isNull()) {
+        page.fReverse = reverseValue.get_bool();
+    }
+
+    UniValue cursorValue = find_value(params[0].get_obj(), "cursor");
+    if (!cursorValue.isNull()) {
+        const std::string& cursor = cursorValue.get_str();
+        if (!IsHex(cursor)) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+        CDataStream ss(ParseHex(cursor), SER_DISK, CLIENT_VERSION);
+        CAddressIndexKey key;
+        try {
+            ss >> key;
+        } catch (const std::exception&) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+        if (!ss.empty()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+        page.after = key;
+    }
+
+    return page;
+}
+
+/** The cursor of the next page, which continues after the entry key */
+static std::string getAddressIndexCursor(const CAddressIndexKey& key)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << key;
+    return HexStr(ss);
+}
+
+/** Wait for the address index to reach the tip, the entries of a partially synced index are incomplete */
+static void syncAddressIndex()
+{
+    if (g_address_index && !g_address_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("address index is still syncing (height %d)", g_address_index->GetSummary().best_block_height));
+    }
+}
+
 bool getAddressFromIndex(const int &type, const uint256 &hash, std::string &address)
 {
     if (type == 2) {
@@ -206,11 +278,14 @@ RPCHelpMan getaddressdeltas()
                         {"start", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "The start block height"},
                         {"end", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "The end block height"},
                         {"chainInfo", RPCArg::Type::BOOL, RPCArg::Optional::OMITTED, "Include chain info in results, only applies if start and end specified"},
+                        {"limit", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "The maximum number of deltas to return"},
+                        {"cursor", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "Continue after the deltas returned by a previous call, from its cursor"},
+                        {"reverse", RPCArg::Type::BOOL, RPCArg::Default{false}, "Return the newest deltas first"},
                     }
                 }
             },
             {
-                RPCResult{"if chainInfo is set to false",
+                RPCResult{"if chainInfo is set to false and limit is not set",
                     RPCResult::Type::ARR, "", "",
                     {
                         {RPCResult::Type::OBJ, "", "",
@@ -224,7 +299,7 @@ RPCHelpMan getaddressdeltas()
                         }}
                     },
                 },
-                RPCResult{"if chainInfo is set to true",
+                RPCResult{"if chainInfo is set to true or limit is set",
                     RPCResult::Type::OBJ, "", "",
                     {
                         {RPCResult::Type::ARR, "deltas", "List of delta",
@@ -239,12 +314,13 @@ RPCHelpMan getaddressdeltas()
                                 {RPCResult::Type::STR, "address", "The revo address"},
                             }}
                         }},
-                        {RPCResult::Type::OBJ, "start", "Start block",
+                        {RPCResult::Type::STR_HEX, "cursor", /* optional */ true, "The cursor of the next deltas, if the limit was reached"},
+                        {RPCResult::Type::OBJ, "start", /* optional */ true, "Start block, if chainInfo is set",
                         {
                             {RPCResult::Type::STR_HEX, "hash", "The block hash"},
                             {RPCResult::Type::NUM, "height", "The block height"},
                         }},
-                        {RPCResult::Type::OBJ, "end", "End block",
+                        {RPCResult::Type::OBJ, "end", /* optional */ true, "End block, if chainInfo is set",
                         {
                             {RPCResult::Type::STR_HEX, "hash", "The block hash"},
                             {RPCResult::Type::NUM, "height", "The block height"},
@@ -256,7 +332,8 @@ RPCHelpMan getaddressdeltas()
                 HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"]}'")
         + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"]}") +
                 HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"start\": 5000, \"end\": 5500, \"chainInfo\": true}'")
-        + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"start\": 5000, \"end\": 5500, \"chainInfo\": true}")
+        + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"start\": 5000, \"end\": 5500, \"chainInfo\": true}") +
+                HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"limit\": 100, \"reverse\": true}'")
             },
     [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
@@ -290,39 +367,45 @@ RPCHelpMan getaddressdeltas()
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    const AddressIndexPage page = getAddressIndexPageFromParams(request.params);
 
-    for (std::vector<std::pair<uint256, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
-    }
+    syncAddressIndex();
 
+    // The deltas are written as the index is read, only up to the limit
     UniValue deltas(UniValue::VARR);
+    std::optional<CAddressIndexKey> last;
+    bool fMore = false;
+
+    if (!GetAddressIndex(addresses, start, end, page.fReverse, page.after, [&](const CAddressIndexKey& key, CAmount value) {
+        if (page.limit > 0 && deltas.size() == (size_t)page.limit) {
+            fMore = true;
+            return false;
+        }
 
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
         std::string address;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
+        if (!getAddressFromIndex(key.type, key.hashBytes, address)) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
         }
 
         UniValue delta(UniValue::VOBJ);
-        delta.pushKV("satoshis", it->second);
-        delta.pushKV("txid", it->first.txhash.GetHex());
-        delta.pushKV("index", (int)it->first.index);
-        delta.pushKV("blockindex", (int)it->first.txindex);
-        delta.pushKV("height", it->first.blockHeight);
+        delta.pushKV("satoshis", value);
+        delta.pushKV("txid", key.txhash.GetHex());
+        delta.pushKV("index", (int)key.index);
+        delta.pushKV("blockindex", (int)key.txindex);
+        delta.pushKV("height", key.blockHeight);
         delta.pushKV("address", address);
         deltas.push_back(delta);
+        last = key;
+        return true;
+    })) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
     }
 
     UniValue result(UniValue::VOBJ);
+    result.pushKV("deltas", deltas);
+    if (fMore) {
+        result.pushKV("cursor", getAddressIndexCursor(*last));
+    }
 
     if (includeChainInfo && start > 0 && end > 0) {
         ChainstateManager& chainman = EnsureAnyChainman(request.context);
@@ -345,10 +428,11 @@ RPCHelpMan getaddressdeltas()
         endInfo.pushKV("hash", endIndex->GetBlockHash().GetHex());
         endInfo.pushKV("height", end);
 
-        result.pushKV("deltas", deltas);
         result.pushKV("start", startInfo);
         result.pushKV("end", endInfo);
 
+        return result;
+    } else if (page.limit > 0) {
         return result;
     } else {
         return deltas;
@@ -393,29 +477,33 @@ RPCHelpMan getaddressbalance()
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-
-    for (std::vector<std::pair<uint256, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-        }
-    }
-
     CAmount balance = 0;
     CAmount received = 0;
     CAmount immature = 0;
 
+    syncAddressIndex();
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
-    LOCK(cs_main);
-    CChain& active_chain = chainman.ActiveChain();
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        if (it->second > 0) {
-            received += it->second;
+    const int nHeight = WITH_LOCK(cs_main, return chainman.ActiveChain().Height());
+    // Only the entries of the blocks that are not mature yet need to be read
+    const int nStart = std::max(nHeight - Params().GetConsensus().CoinbaseMaturity(nHeight) + 1, 1);
+
+    for (std::vector<std::pair<uint256, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+        CAmount addressBalance = 0;
+        CAmount addressReceived = 0;
+        if (!GetAddressBalance((*it).first, (*it).second, addressBalance, addressReceived)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        balance += addressBalance;
+        received += addressReceived;
+
+        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+        if (nHeight > 0 && !GetAddressIndex((*it).first, (*it).second, addressIndex, nStart, nHeight)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator itIndex=addressIndex.begin(); itIndex!=addressIndex.end(); itIndex++) {
+            if (itIndex->first.txindex == 1)
+                immature += itIndex->second; //immature stake outputs
         }
-        balance += it->second;
-        int nHeight = active_chain.Height();
-        if (it->first.txindex == 1 && ((nHeight - it->first.blockHeight) < Params().GetConsensus().CoinbaseMaturity(nHeight)))
-            immature += it->second; //immature stake outputs
     }
 
     UniValue result(UniValue::VOBJ);
@@ -504,6 +592,7 @@ RPCHelpMan getaddressutxos()
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    syncAddressIndex();
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
 
     for (std::vector<std::pair<uint256, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
@@ -693,6 +782,7 @@ RPCHelpMan getblockhashes()
     std::vector<std::pair<uint256, unsigned int> > blockHashes;
     bool found = false;
 
+    syncAddressIndex();
     found = GetTimestampIndex(high, low, fActiveOnly, blockHashes, chainman);
 
     if (!found) {
@@ -759,6 +849,7 @@ RPCHelpMan getspentinfo()
     CSpentIndexKey key(txid, outputIndex);
     CSpentIndexValue value;
 
+    syncAddressIndex();
     if (!GetSpentIndex(key, value, mempool)) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unable to get spent info");
     }
@@ -787,20 +878,36 @@ RPCHelpMan getaddresstxids()
                             },
                             {"start", RPCArg::Type::NUM, RPCArg::Optional::OMITTED_NAMED_ARG, "The start block height"},
                             {"end", RPCArg::Type::NUM, RPCArg::Optional::OMITTED_NAMED_ARG, "The end block height"},
+                            {"limit", RPCArg::Type::NUM, RPCArg::Optional::OMITTED_NAMED_ARG, "The maximum number of txids to return"},
+                            {"cursor", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED_NAMED_ARG, "Continue after the txids returned by a previous call, from its cursor"},
+                            {"reverse", RPCArg::Type::BOOL, RPCArg::Default{false}, "Return the newest txids first"},
                         }
                     }
                 },
-                RPCResult{
-                    RPCResult::Type::ARR, "", "",
-                    {
-                        {RPCResult::Type::STR_HEX, "transactionid", "The transaction id"},
-                    }
+                {
+                    RPCResult{"if limit is not set",
+                        RPCResult::Type::ARR, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "transactionid", "The transaction id"},
+                        }
+                    },
+                    RPCResult{"if limit is set",
+                        RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::ARR, "txids", "",
+                            {
+                                {RPCResult::Type::STR_HEX, "transactionid", "The transaction id"},
+                            }},
+                            {RPCResult::Type::STR_HEX, "cursor", /* optional */ true, "The cursor of the next txids, if the limit was reached"},
+                        }
+                    },
                 },
                 RPCExamples{
                     HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"]}'")
             + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"]}") +
                     HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"start\": 5000, \"end\": 5500}'")
-            + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"start\": 5000, \"end\": 5500}")
+            + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"start\": 5000, \"end\": 5500}") +
+                    HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"QD1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"limit\": 100, \"reverse\": true}'")
                 },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
@@ -822,43 +929,45 @@ RPCHelpMan getaddresstxids()
         }
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-
-    for (std::vector<std::pair<uint256, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
+    if (start <= 0 || end <= 0) {
+        start = 0;
+        end = 0;
     }
 
-    std::set<std::pair<int, std::string> > txids;
-    UniValue result(UniValue::VARR);
+    const AddressIndexPage page = getAddressIndexPageFromParams(request.params);
 
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        int height = it->first.blockHeight;
-        std::string txid = it->first.txhash.GetHex();
+    syncAddressIndex();
 
-        if (addresses.size() > 1) {
-            txids.insert(std::make_pair(height, txid));
-        } else {
-            if (txids.insert(std::make_pair(height, txid)).second) {
-                result.push_back(txid);
+    // The entries of a transaction are next to each other in the merged index, so only the last txid is needed
+    // to skip its other entries. The entries of the last txid are all read, so the next page starts after them.
+    UniValue txids(UniValue::VARR);
+    std::optional<CAddressIndexKey> last;
+    bool fMore = false;
+
+    if (!GetAddressIndex(addresses, start, end, page.fReverse, page.after, [&](const CAddressIndexKey& key, CAmount value) {
+        if (!last || last->blockHeight != key.blockHeight || last->txhash != key.txhash) {
+            if (page.limit > 0 && txids.size() == (size_t)page.limit) {
+                fMore = true;
+                return false;
             }
+            txids.push_back(key.txhash.GetHex());
         }
+        last = key;
+        return true;
+    })) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
     }
 
-    if (addresses.size() > 1) {
-        for (std::set<std::pair<int, std::string> >::const_iterator it=txids.begin(); it!=txids.end(); it++) {
-            result.push_back(it->second);
+    if (page.limit > 0) {
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("txids", txids);
+        if (fMore) {
+            result.pushKV("cursor", getAddressIndexCursor(*last));
         }
+        return result;
     }
 
-    return result;
+    return txids;
 },
     };
 }
@@ -1338,6 +1447,32 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCAnalysisCacheInfo()
+{
+    dev::eth::AnalysisCache::Stats stats = dev::eth::AnalysisCache::instance().stats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(stats.entries));
+    obj.pushKV("usage", uint64_t(stats.usage));
+    obj.pushKV("max_usage", uint64_t(stats.maxUsage));
+    obj.pushKV("hits", stats.hits);
+    obj.pushKV("misses", stats.misses);
+    obj.pushKV("evictions", stats.evictions);
+    return obj;
+}
+
+static UniValue RPCCodeCacheInfo()
+{
+    dev::eth::CodeCache::Stats stats = dev::eth::CodeCache::instance().stats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(stats.entries));
+    obj.pushKV("usage", uint64_t(stats.usage));
+    obj.pushKV("max_usage", uint64_t(stats.maxUsage));
+    obj.pushKV("hits", stats.hits);
+    obj.pushKV("misses", stats.misses);
+    obj.pushKV("evictions", stats.evictions);
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -1382,6 +1517,24 @@ static RPCHelpMan getmemoryinfo()
                                 {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                                 {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
                             }},
+                            {RPCResult::Type::OBJ, "evmanalysiscache", "Information about the cache of EVM contract code analyses",
+                            {
+                                {RPCResult::Type::NUM, "entries", "Number of cached analyses"},
+                                {RPCResult::Type::NUM, "usage", "Estimated number of bytes used"},
+                                {RPCResult::Type::NUM, "max_usage", "Maximum number of bytes used (see -evmanalysiscache)"},
+                                {RPCResult::Type::NUM, "hits", "Number of contract executions that reused a cached analysis"},
+                                {RPCResult::Type::NUM, "misses", "Number of contract executions that had to analyse the code"},
+                                {RPCResult::Type::NUM, "evictions", "Number of analyses evicted to stay within the size limit"},
+                            }},
+                            {RPCResult::Type::OBJ, "evmcodecache", "Information about the cache of EVM contract code",
+                            {
+                                {RPCResult::Type::NUM, "entries", "Number of cached contracts"},
+                                {RPCResult::Type::NUM, "usage", "Estimated number of bytes used"},
+                                {RPCResult::Type::NUM, "max_usage", "Maximum number of bytes used (see -evmcodecache)"},
+                                {RPCResult::Type::NUM, "hits", "Number of code reads served by the cache"},
+                                {RPCResult::Type::NUM, "misses", "Number of code reads that missed the cache"},
+                                {RPCResult::Type::NUM, "evictions", "Number of contracts evicted to stay within the size limit"},
+                            }},
                         }
                     },
                     RPCResult{"mode \"mallocinfo\"",
@@ -1398,6 +1551,8 @@ static RPCHelpMan getmemoryinfo()
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("evmanalysiscache", RPCAnalysisCacheInfo());
+        obj.pushKV("evmcodecache", RPCCodeCacheInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -1620,6 +1775,14 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
 
+    if (g_address_index) {
+        result.pushKVs(SummaryToJSON(g_address_index->GetSummary(), index_name));
+    }
+
+    if (g_delegation_index) {
+        result.pushKVs(SummaryToJSON(g_delegation_index->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
@@ -7,6 +7,7 @@
 #include <coins.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <index/addressindex.h>
 #include <index/txindex.h>
 #include <key_io.h>
 #include <merkleblock.h>
@@ -348,6 +349,11 @@ static RPCHelpMan getrawtransaction()
         f_txindex_ready = g_txindex->BlockUntilSyncedToCurrentChain();
     }
 
+    // The spent info of the verbose result is read from the address index
+    if (g_address_index && fVerbose) {
+        g_address_index->BlockUntilSyncedToCurrentChain();
+    }
+
     uint256 hash_block;
     const CTransactionRef tx = GetTransaction(blockindex, node.mempool.get(), hash, Params().GetConsensus(), hash_block);
     if (!tx) {
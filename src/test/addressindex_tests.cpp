@@ -0,0 +1,279 @@
+// Copyright (c) 2026 The Revo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <dbwrapper.h>
+#include <index/addressindex.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+/** The index key of a public key hash address */
+std::pair<uint256, int> IndexKey(const CKey& key)
+{
+    const PKHash id(key.GetPubKey());
+    std::vector<unsigned char> address_bytes(32);
+    std::copy(id.begin(), id.end(), address_bytes.begin());
+    return std::make_pair(uint256(address_bytes), (int)CTxDestination(id).index());
+}
+
+/** What the index returns for an address and an output, and the indexed blocks */
+struct IndexState
+{
+    CAmount balance{0};
+    CAmount received{0};
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspent;
+    bool spent{false};
+    CSpentIndexValue spent_value;
+    std::vector<std::pair<uint256, unsigned int> > blocks;
+};
+
+IndexState ReadIndexState(const AddressIndex& addressindex, const std::pair<uint256, int>& address, const COutPoint& prevout, ChainstateManager& chainman)
+{
+    IndexState state;
+    CAddressBalanceValue balance;
+    BOOST_CHECK(addressindex.ReadAddressBalance(address.first, address.second, balance));
+    state.balance = balance.balance;
+    state.received = balance.received;
+    BOOST_CHECK(addressindex.ReadAddressUnspentIndex(address.first, address.second, state.unspent));
+    state.spent = addressindex.ReadSpentIndex(CSpentIndexKey(prevout.hash, prevout.n), state.spent_value);
+    BOOST_CHECK(addressindex.ReadTimestampIndex(std::numeric_limits<unsigned int>::max(), 0, false, state.blocks, chainman));
+    return state;
+}
+
+void CheckIndexState(const IndexState& state, const IndexState& expected)
+{
+    BOOST_CHECK_EQUAL(state.balance, expected.balance);
+    BOOST_CHECK_EQUAL(state.received, expected.received);
+    BOOST_REQUIRE_EQUAL(state.unspent.size(), expected.unspent.size());
+    for (size_t i = 0; i < state.unspent.size(); i++) {
+        BOOST_CHECK(state.unspent[i].first.txhash == expected.unspent[i].first.txhash);
+        BOOST_CHECK_EQUAL(state.unspent[i].first.index, expected.unspent[i].first.index);
+        BOOST_CHECK_EQUAL(state.unspent[i].second.satoshis, expected.unspent[i].second.satoshis);
+        BOOST_CHECK_EQUAL(state.unspent[i].second.blockHeight, expected.unspent[i].second.blockHeight);
+    }
+    BOOST_CHECK_EQUAL(state.spent, expected.spent);
+    if (state.spent && expected.spent) {
+        BOOST_CHECK(state.spent_value.txid == expected.spent_value.txid);
+        BOOST_CHECK_EQUAL(state.spent_value.blockHeight, expected.spent_value.blockHeight);
+    }
+    BOOST_CHECK(state.blocks == expected.blocks);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(addressindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(addressindex_initial_sync, TestChain100Setup)
+{
+    AddressIndex addressindex(1 << 20, true);
+
+    // The address of the coinbase key, as the index stores it
+    const CScript coinbase_script_pub_key = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    const PKHash coinbase_id(coinbaseKey.GetPubKey());
+    std::vector<unsigned char> address_bytes(32);
+    std::copy(coinbase_id.begin(), coinbase_id.end(), address_bytes.begin());
+    const uint256 hash_bytes(address_bytes);
+    const int type = CTxDestination(coinbase_id).index();
+
+    CAmount expected_balance = 0;
+    size_t expected_unspent = 0;
+    for (const auto& txn : m_coinbase_txns) {
+        for (const CTxOut& out : txn->vout) {
+            if (out.scriptPubKey == coinbase_script_pub_key) {
+                expected_balance += out.nValue;
+                expected_unspent++;
+            }
+        }
+    }
+
+    // BlockUntilSyncedToCurrentChain should return false before addressindex is started.
+    BOOST_CHECK(!addressindex.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(addressindex.Start(m_node.chainman->ActiveChainstate()));
+
+    // Allow the address index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!addressindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // Check that the blocks connected before the index started are indexed.
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspent;
+    BOOST_CHECK(addressindex.ReadAddressUnspentIndex(hash_bytes, type, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), expected_unspent);
+
+    CAddressBalanceValue balance;
+    BOOST_CHECK(addressindex.ReadAddressBalance(hash_bytes, type, balance));
+    BOOST_CHECK_EQUAL(balance.balance, expected_balance);
+    BOOST_CHECK_EQUAL(balance.received, expected_balance);
+
+    // Check that new blocks make it into the index.
+    std::vector<CMutableTransaction> no_txns;
+    const CBlock& block = CreateAndProcessBlock(no_txns, coinbase_script_pub_key);
+    for (const CTxOut& out : block.vtx[0]->vout) {
+        if (out.scriptPubKey == coinbase_script_pub_key) {
+            expected_balance += out.nValue;
+            expected_unspent++;
+        }
+    }
+
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+    unspent.clear();
+    BOOST_CHECK(addressindex.ReadAddressUnspentIndex(hash_bytes, type, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), expected_unspent);
+    BOOST_CHECK(addressindex.ReadAddressBalance(hash_bytes, type, balance));
+    BOOST_CHECK_EQUAL(balance.balance, expected_balance);
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    addressindex.Stop();
+
+    // Let scheduler events finish running to avoid accessing any memory related to addressindex after it is destructed
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_FIXTURE_TEST_CASE(addressindex_reorg, TestChain100Setup)
+{
+    AddressIndex addressindex(1 << 20, true);
+    ChainstateManager& chainman = *m_node.chainman;
+    CChainState& chainstate = chainman.ActiveChainstate();
+
+    BOOST_REQUIRE(addressindex.Start(chainstate));
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!addressindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    const std::pair<uint256, int> coinbase_address = IndexKey(coinbaseKey);
+    CKey receiver_key;
+    receiver_key.MakeNewKey(true);
+    const std::pair<uint256, int> receiver_address = IndexKey(receiver_key);
+    const COutPoint prevout(m_coinbase_txns[0]->GetHash(), 0);
+
+    const IndexState coinbase_before = ReadIndexState(addressindex, coinbase_address, prevout, chainman);
+    const IndexState receiver_before = ReadIndexState(addressindex, receiver_address, prevout, chainman);
+    BOOST_CHECK(!coinbase_before.spent);
+    BOOST_CHECK_EQUAL(receiver_before.received, 0);
+
+    // Spend a coinbase output of the coinbase key to the receiver, the block reward goes to another key
+    CKey miner_key;
+    miner_key.MakeNewKey(true);
+    const CScript miner_script = GetScriptForRawPubKey(miner_key.GetPubKey());
+    const CAmount amount = 10 * COIN;
+    const CMutableTransaction spend = CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey,
+                                                                    GetScriptForDestination(PKHash(receiver_key.GetPubKey())), amount, false);
+    const CBlock block = CreateAndProcessBlock({spend}, miner_script);
+    BOOST_REQUIRE(WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()->GetBlockHash()) == block.GetHash());
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+
+    const IndexState coinbase_spent = ReadIndexState(addressindex, coinbase_address, prevout, chainman);
+    const IndexState receiver_spent = ReadIndexState(addressindex, receiver_address, prevout, chainman);
+    BOOST_CHECK_EQUAL(coinbase_spent.balance, coinbase_before.balance - m_coinbase_txns[0]->vout[0].nValue);
+    BOOST_CHECK_EQUAL(coinbase_spent.received, coinbase_before.received);
+    BOOST_CHECK_EQUAL(coinbase_spent.unspent.size() + 1, coinbase_before.unspent.size());
+    BOOST_CHECK(coinbase_spent.spent);
+    BOOST_CHECK(coinbase_spent.spent_value.txid == spend.GetHash());
+    BOOST_CHECK_EQUAL(coinbase_spent.blocks.size(), coinbase_before.blocks.size() + 1);
+    BOOST_CHECK_EQUAL(receiver_spent.balance, amount);
+    BOOST_CHECK_EQUAL(receiver_spent.received, amount);
+    BOOST_CHECK_EQUAL(receiver_spent.unspent.size(), 1U);
+
+    // Replace the block with one that does not touch the addresses, the index rewinds the spend
+    CBlockIndex* pindex = WITH_LOCK(cs_main, return chainman.ActiveChain().Tip());
+    {
+        BlockValidationState state;
+        BOOST_REQUIRE(chainstate.InvalidateBlock(state, pindex));
+    }
+    SetMockTime(GetTime() + 1);
+    const CBlock replacement = CreateAndProcessBlock({}, miner_script);
+    BOOST_REQUIRE(WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()->GetBlockHash()) == replacement.GetHash());
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+
+    IndexState expected = coinbase_before;
+    expected.blocks.clear();
+    BOOST_CHECK(addressindex.ReadTimestampIndex(std::numeric_limits<unsigned int>::max(), 0, false, expected.blocks, chainman));
+    BOOST_CHECK_EQUAL(expected.blocks.size(), coinbase_before.blocks.size() + 1);
+    BOOST_CHECK(std::none_of(expected.blocks.begin(), expected.blocks.end(), [&](const std::pair<uint256, unsigned int>& entry) { return entry.first == block.GetHash(); }));
+    CheckIndexState(ReadIndexState(addressindex, coinbase_address, prevout, chainman), expected);
+    expected.balance = receiver_before.balance;
+    expected.received = receiver_before.received;
+    expected.unspent = receiver_before.unspent;
+    CheckIndexState(ReadIndexState(addressindex, receiver_address, prevout, chainman), expected);
+
+    // Reconnect the spending block, the entries of the spend are back
+    CBlockIndex* pindex_replacement = WITH_LOCK(cs_main, return chainman.ActiveChain().Tip());
+    {
+        BlockValidationState state;
+        BOOST_REQUIRE(chainstate.InvalidateBlock(state, pindex_replacement));
+        WITH_LOCK(cs_main, chainstate.ResetBlockFailureFlags(pindex));
+        BOOST_REQUIRE(chainstate.ActivateBestChain(state));
+    }
+    BOOST_REQUIRE(WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()) == pindex);
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+    CheckIndexState(ReadIndexState(addressindex, coinbase_address, prevout, chainman), coinbase_spent);
+    CheckIndexState(ReadIndexState(addressindex, receiver_address, prevout, chainman), receiver_spent);
+
+    addressindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_FIXTURE_TEST_CASE(addressindex_import_legacy, TestChain100Setup)
+{
+    // Entries of an address as older versions wrote them to the block index database
+    CDBWrapper legacy(m_args.GetDataDirNet() / "legacy", 1 << 20, true);
+    const std::pair<uint256, int> address = IndexKey(coinbaseKey);
+    const uint256 txid1 = m_coinbase_txns[0]->GetHash();
+    const uint256 txid2 = m_coinbase_txns[1]->GetHash();
+    const uint256 spending_txid = InsecureRand256();
+    const CScript script = GetScriptForRawPubKey(coinbaseKey.GetPubKey());
+    CDBBatch batch(legacy);
+    batch.Write(std::make_pair(uint8_t{'a'}, CAddressIndexKey(address.second, address.first, 1, 0, txid1, 0, false)), 5 * COIN);
+    batch.Write(std::make_pair(uint8_t{'a'}, CAddressIndexKey(address.second, address.first, 2, 0, txid2, 0, false)), 3 * COIN);
+    batch.Write(std::make_pair(uint8_t{'a'}, CAddressIndexKey(address.second, address.first, 3, 1, spending_txid, 0, true)), -5 * COIN);
+    batch.Write(std::make_pair(uint8_t{'u'}, CAddressUnspentKey(address.second, address.first, txid2, 0)), CAddressUnspentValue(3 * COIN, script, 2, false));
+    batch.Write(std::make_pair(uint8_t{'p'}, CSpentIndexKey(txid1, 0)), CSpentIndexValue(spending_txid, 0, 3, 5 * COIN, address.second, address.first));
+    BOOST_REQUIRE(legacy.WriteBatch(batch));
+
+    AddressIndex addressindex(1 << 20, true);
+    const CBlockLocator locator = WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().GetLocator());
+    BOOST_REQUIRE(addressindex.ImportLegacyIndex(legacy, locator));
+
+    // The index starts synced to the chain, with the balance summed from the entries
+    BOOST_REQUIRE(addressindex.Start(m_node.chainman->ActiveChainstate()));
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+
+    CAddressBalanceValue balance;
+    BOOST_CHECK(addressindex.ReadAddressBalance(address.first, address.second, balance));
+    BOOST_CHECK_EQUAL(balance.balance, 3 * COIN);
+    BOOST_CHECK_EQUAL(balance.received, 8 * COIN);
+
+    std::vector<std::pair<CAddressIndexKey, CAmount> > entries;
+    BOOST_CHECK(addressindex.ReadAddressIndex(address.first, address.second, entries));
+    BOOST_CHECK_EQUAL(entries.size(), 3U);
+
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspent;
+    BOOST_CHECK(addressindex.ReadAddressUnspentIndex(address.first, address.second, unspent));
+    BOOST_REQUIRE_EQUAL(unspent.size(), 1U);
+    BOOST_CHECK(unspent[0].first.txhash == txid2);
+
+    CSpentIndexValue spent;
+    BOOST_CHECK(addressindex.ReadSpentIndex(CSpentIndexKey(txid1, 0), spent));
+    BOOST_CHECK(spent.txid == spending_txid);
+
+    addressindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
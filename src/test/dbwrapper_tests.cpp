@@ -198,6 +198,39 @@ BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_snapshot)
+{
+    fs::path ph = m_args.GetDataDirBase() / "dbwrapper_snapshot";
+    CDBWrapper dbw(ph, (1 << 20), true, false, false);
+
+    uint8_t key = 'k';
+    uint256 in = InsecureRand256();
+    BOOST_CHECK(dbw.Write(key, in));
+
+    CDBWrapper::Snapshot snapshot(dbw);
+
+    // Writes after the snapshot are not visible through it
+    uint256 in2 = InsecureRand256();
+    uint8_t key2 = 'l';
+    BOOST_CHECK(dbw.Write(key, in2));
+    BOOST_CHECK(dbw.Write(key2, in2));
+
+    uint256 res;
+    BOOST_CHECK(dbw.Read(key, res, &snapshot));
+    BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+    BOOST_CHECK(!dbw.Read(key2, res, &snapshot));
+    BOOST_CHECK(dbw.Read(key, res));
+    BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+
+    std::unique_ptr<CDBIterator> it(dbw.NewIterator(snapshot));
+    it->Seek(key);
+    BOOST_REQUIRE(it->Valid());
+    BOOST_CHECK(it->GetValue(res));
+    BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+    it->Next();
+    BOOST_CHECK(!it->Valid());
+}
+
 // Test that we do not obfuscation if there is existing data.
 BOOST_AUTO_TEST_CASE(existing_data_no_obfuscate)
 {
@@ -317,6 +350,70 @@ BOOST_AUTO_TEST_CASE(iterator_ordering)
     }
 }
 
+BOOST_AUTO_TEST_CASE(iterator_reverse_ordering)
+{
+    fs::path ph = m_args.GetDataDirBase() / "iterator_reverse_ordering";
+    CDBWrapper dbw(ph, (1 << 20), true, false, false);
+    for (int x=0x00; x<256; x+=2) {
+        uint8_t key = x;
+        uint32_t value = x*x;
+        BOOST_CHECK(dbw.Write(key, value));
+    }
+
+    std::unique_ptr<CDBIterator> it(const_cast<CDBWrapper&>(dbw).NewIterator());
+
+    // Walk all keys backwards from the last one
+    it->SeekToLast();
+    for (int x=0xfe; x>=0; x-=2) {
+        uint8_t key;
+        uint32_t value;
+        BOOST_CHECK(it->Valid());
+        if (!it->Valid()) // Avoid spurious errors about invalid iterator's key and value in case of failure
+            break;
+        BOOST_CHECK(it->GetKey(key));
+        BOOST_CHECK(it->GetValue(value));
+        BOOST_CHECK_EQUAL(key, x);
+        BOOST_CHECK_EQUAL(value, (uint32_t)(x*x));
+        it->Prev();
+    }
+    BOOST_CHECK(!it->Valid());
+
+    // Seeking a missing key lands on the next one, stepping back gives the last key before it
+    for (const int seek_start : {0x01, 0x81, 0xfd}) {
+        uint8_t key;
+        it->Seek((uint8_t)seek_start);
+        BOOST_REQUIRE(it->Valid());
+        BOOST_CHECK(it->GetKey(key));
+        BOOST_CHECK_EQUAL(key, seek_start + 1);
+        it->Prev();
+        BOOST_REQUIRE(it->Valid());
+        BOOST_CHECK(it->GetKey(key));
+        BOOST_CHECK_EQUAL(key, seek_start - 1);
+    }
+
+    // Stepping back from the first key, or seeking past the last one, leaves the iterator invalid
+    it->Seek((uint8_t)0x00);
+    BOOST_REQUIRE(it->Valid());
+    it->Prev();
+    BOOST_CHECK(!it->Valid());
+    it->Seek((uint8_t)0xff);
+    BOOST_CHECK(!it->Valid());
+
+    // Then the last key is found with SeekToLast
+    uint8_t key;
+    it->SeekToLast();
+    BOOST_REQUIRE(it->Valid());
+    BOOST_CHECK(it->GetKey(key));
+    BOOST_CHECK_EQUAL(key, 0xfe);
+
+    // An empty database has no last key
+    fs::path ph_empty = m_args.GetDataDirBase() / "iterator_reverse_ordering_empty";
+    CDBWrapper dbw_empty(ph_empty, (1 << 20), true, false, false);
+    std::unique_ptr<CDBIterator> it_empty(const_cast<CDBWrapper&>(dbw_empty).NewIterator());
+    it_empty->SeekToLast();
+    BOOST_CHECK(!it_empty->Valid());
+}
+
 struct StringContentsSerializer {
     // Used to make two serialized objects the same while letting them have different lengths
     // This is a terrible idea
@@ -9,9 +9,11 @@
 #include <consensus/tx_verify.h>
 #include <miner.h>
 #include <policy/policy.h>
+#include <script/interpreter.h>
 #include <script/standard.h>
 #include <txmempool.h>
 #include <uint256.h>
+#include <util/convert.h>
 #include <util/strencodings.h>
 #include <util/system.h>
 #include <util/time.h>
@@ -651,4 +653,139 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+BOOST_AUTO_TEST_CASE(contract_execution_cache)
+{
+    ContractExecutionCache cache;
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    coinbase.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    CBlock block;
+    block.hashPrevBlock = InsecureRand256();
+    block.nTime = 1000;
+    block.nBits = 0x207fffff;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    const uint256 txid = InsecureRand256();
+    const dev::h256 stateRoot = uintToh256(InsecureRand256());
+    const dev::h256 utxoRoot = uintToh256(InsecureRand256());
+    BOOST_CHECK(!cache.Find(txid, block, stateRoot, utxoRoot, 40000000));
+
+    auto entry = std::make_shared<ContractExecutionCache::Entry>();
+    entry->hashPrevBlock = block.hashPrevBlock;
+    entry->hashStateRoot = stateRoot;
+    entry->hashUTXORoot = utxoRoot;
+    entry->authorScript = ContractExecutionCache::AuthorScript(block);
+    entry->blockGasLimit = 40000000;
+    entry->nTime = block.nTime;
+    entry->nBits = block.nBits;
+    entry->result.usedGas = 21000;
+    cache.Insert(txid, entry);
+
+    auto found = cache.Find(txid, block, stateRoot, utxoRoot, 40000000);
+    BOOST_CHECK(found && found->result.usedGas == 21000);
+
+    // Executions started from another state or with another gas limit are not reused
+    BOOST_CHECK(!cache.Find(txid, block, utxoRoot, utxoRoot, 40000000));
+    BOOST_CHECK(!cache.Find(txid, block, stateRoot, utxoRoot, 20000000));
+
+    // The time of the block only matters when the execution read it
+    block.nTime += 16;
+    BOOST_CHECK(cache.Find(txid, block, stateRoot, utxoRoot, 40000000));
+    entry = std::make_shared<ContractExecutionCache::Entry>(*entry);
+    entry->contextRead = true;
+    cache.Insert(txid, entry);
+    BOOST_CHECK(!cache.Find(txid, block, stateRoot, utxoRoot, 40000000));
+
+    // Another block author
+    block.nTime -= 16;
+    BOOST_CHECK(cache.Find(txid, block, stateRoot, utxoRoot, 40000000));
+    coinbase.vout[0].scriptPubKey = CScript() << OP_FALSE;
+    block.vtx[0] = MakeTransactionRef(coinbase);
+    BOOST_CHECK(!cache.Find(txid, block, stateRoot, utxoRoot, 40000000));
+
+    // A new tip drops the executions
+    block.hashPrevBlock = InsecureRand256();
+    BOOST_CHECK(!cache.Find(txid, block, stateRoot, utxoRoot, 40000000));
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 0U);
+
+    ContractExecutionCache::Stats stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.hits, 3U);
+    BOOST_CHECK_EQUAL(stats.misses, 6U);
+}
+
+/** Create a contract spending all its gas from the first output of a mature coinbase */
+static CTransactionRef CreateGasSpender(const CTransactionRef& coinbase, const CKey& key, uint64_t gasLimit, CAmount gasPrice, CAmount extraFee)
+{
+    const std::vector<unsigned char> loop_code = ParseHex("5b600056"); // JUMPDEST PUSH1 0 JUMP
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint(coinbase->GetHash(), 0));
+    tx.vout.emplace_back(0, CScript() << CScriptNum(VersionVM::GetEVMDefault().toRaw()) << CScriptNum(gasLimit) << CScriptNum(gasPrice) << loop_code << OP_CREATE);
+    tx.vout.emplace_back(coinbase->vout[0].nValue - gasLimit * gasPrice - extraFee, GetScriptForDestination(PKHash(key.GetPubKey())));
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(coinbase->vout[0].scriptPubKey, tx, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+    BOOST_CHECK(key.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    tx.vin[0].scriptSig << vchSig;
+    return MakeTransactionRef(tx);
+}
+
+BOOST_FIXTURE_TEST_CASE(gas_package_selection, TestChain100Setup)
+{
+    // Mature coinbases for four contract transactions
+    mineBlocks(3);
+    CChainState& chainstate = m_node.chainman->ActiveChainstate();
+    const CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    // Ordered by gas price and by fee, the third one does not fit in the gas left by the first two
+    gArgs.ForceSetArg("-staker-soft-block-gas-limit", "300000");
+    std::vector<CTransactionRef> txs{
+        CreateGasSpender(m_coinbase_txns[0], coinbaseKey, 100000, 100, 10000000),
+        CreateGasSpender(m_coinbase_txns[1], coinbaseKey, 100000, 90, 10000000),
+        CreateGasSpender(m_coinbase_txns[2], coinbaseKey, 200000, 50, 1000000),
+        CreateGasSpender(m_coinbase_txns[3], coinbaseKey, 100000, 40, 1000000),
+    };
+    {
+        LOCK(cs_main);
+        for (const CTransactionRef& tx : txs) {
+            const MempoolAcceptResult result = AcceptToMemoryPool(chainstate, *m_node.mempool, tx, false /* bypass_limits */);
+            BOOST_REQUIRE_MESSAGE(result.m_result_type == MempoolAcceptResult::ResultType::VALID, result.m_state.ToString());
+        }
+    }
+    g_contract_exec_cache.Clear();
+
+    auto blockTxids = [&]() {
+        std::unique_ptr<CBlockTemplate> pblocktemplate = BlockAssembler(chainstate, *m_node.mempool, Params()).CreateNewBlock(scriptPubKey);
+        BOOST_REQUIRE(pblocktemplate);
+        std::set<uint256> txids;
+        for (const CTransactionRef& tx : pblocktemplate->block.vtx) {
+            txids.insert(tx->GetHash());
+        }
+        return txids;
+    };
+
+    // The package which does not fit is skipped without executing it, the next one still fits
+    const size_t pendingUsage = globalState->db().pendingMemoryUsage();
+    std::set<uint256> txids = blockTxids();
+    // The trie nodes of the template are kept by the execution cache, not the state database
+    BOOST_CHECK_EQUAL(globalState->db().pendingMemoryUsage(), pendingUsage);
+    BOOST_CHECK(txids.count(txs[0]->GetHash()));
+    BOOST_CHECK(txids.count(txs[1]->GetHash()));
+    BOOST_CHECK(!txids.count(txs[2]->GetHash()));
+    BOOST_CHECK(txids.count(txs[3]->GetHash()));
+    BOOST_CHECK_EQUAL(g_contract_exec_cache.GetStats().entries, 3U);
+
+    // Packages below the minimum gas price of the staker are skipped as well
+    gArgs.ForceSetArg("-staker-min-tx-gas-price", "0.0000006");
+    txids = blockTxids();
+    BOOST_CHECK(txids.count(txs[0]->GetHash()));
+    BOOST_CHECK(txids.count(txs[1]->GetHash()));
+    BOOST_CHECK(!txids.count(txs[2]->GetHash()));
+    BOOST_CHECK(!txids.count(txs[3]->GetHash()));
+    BOOST_CHECK_EQUAL(g_contract_exec_cache.GetStats().entries, 3U);
+
+    g_contract_exec_cache.Clear();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
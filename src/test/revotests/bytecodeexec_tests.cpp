@@ -1,6 +1,11 @@
 #include <boost/test/unit_test.hpp>
 #include <test/util/setup_common.h>
 #include <revotests/test_utils.h>
+#include <libevm/AnalysisCache.h>
+#include <libethereum/CodeCache.h>
+#include <revo/contractcall.h>
+
+#include <thread>
 
 const dev::u256 GASLIMIT = dev::u256(500000);
 const dev::Address SENDERADDRESS = dev::Address("0101010101010101010101010101010101010101");
@@ -114,6 +119,13 @@ void checkBCEResult(ByteCodeExecResult result, uint64_t usedGas, CAmount refundS
     BOOST_CHECK(result.valueTransfers.size() == nTxs);
 }
 
+ContractCall makeCall(const dev::Address& addrContract, const valtype& opcode){
+    ContractCall call;
+    call.addrContract = addrContract;
+    call.opcode = opcode;
+    return call;
+}
+
 BOOST_FIXTURE_TEST_SUITE(bytecodeexec_tests, TestingSetup)
 
 BOOST_AUTO_TEST_CASE(bytecodeexec_txs_empty){
@@ -285,6 +297,75 @@ BOOST_AUTO_TEST_CASE(bytecodeexec_call_contract_transfer_many){
     checkBCEResult(result.second, 2734810, 62265190, 130, CAmount(GASLIMIT * 130), 130);
 }
 
+BOOST_AUTO_TEST_CASE(bytecodeexec_call_contract_analysis_cache){
+    initState();
+    dev::eth::AnalysisCache& cache = dev::eth::AnalysisCache::instance();
+    cache.clear();
+    std::vector<dev::Address> newAddressGen;
+    std::vector<RevoTransaction> txs;
+    dev::h256 hash(HASHTX);
+    for(size_t i = 0; i < 130; i++){
+        RevoTransaction txEth = createRevoTransaction(CODE[0], 0, GASLIMIT, dev::u256(1), hash, dev::Address(), i);
+        newAddressGen.push_back(createRevoAddress(txEth.getHashWith(), txEth.getNVout()));
+        txs.push_back(txEth);
+        ++hash;
+    }
+    executeBC(txs, *m_node.chainman);
+    BOOST_CHECK(cache.stats().entries == 0);
+
+    std::vector<RevoTransaction> txsCall;
+    std::vector<dev::Address> addrs;
+    for(size_t i = 0; i < txs.size(); i++){
+        RevoTransaction txEthCall = createRevoTransaction(ParseHex("00"), 1300, GASLIMIT, dev::u256(1), hash, newAddressGen[i], i);
+        txsCall.push_back(txEthCall);
+        addrs.push_back(txEthCall.receiveAddress());
+    }
+    dev::eth::AnalysisCache::Stats before = cache.stats();
+    auto result = executeBC(txsCall, *m_node.chainman);
+    dev::eth::AnalysisCache::Stats after = cache.stats();
+
+    // All 130 contracts share the same code, so it is analysed once and reused
+    BOOST_CHECK(after.entries == 1);
+    BOOST_CHECK(after.misses - before.misses == 1);
+    BOOST_CHECK(after.hits - before.hits == 129);
+    checkExecResult(result.first, 130, 130, dev::eth::TransactionException::None, addrs, valtype(), dev::u256(1300));
+    checkBCEResult(result.second, 2734810, 62265190, 130, CAmount(GASLIMIT * 130), 130);
+
+    cache.setMaxUsage(0);
+    BOOST_CHECK(cache.stats().entries == 0);
+    BOOST_CHECK(cache.stats().usage == 0);
+    BOOST_CHECK(cache.stats().evictions == after.evictions + 1);
+    cache.setMaxUsage(dev::eth::AnalysisCache::c_defaultMaxUsage);
+}
+
+BOOST_AUTO_TEST_CASE(bytecodeexec_code_cache){
+    dev::eth::CodeCache& cache = dev::eth::CodeCache::instance();
+    cache.clear();
+    std::vector<dev::h256> hashes;
+    for(size_t i = 0; i < 64; i++){
+        dev::bytes code(1000, uint8_t(i));
+        hashes.push_back(dev::sha3(code));
+        cache.store(hashes.back(), code);
+    }
+    BOOST_CHECK(cache.stats().entries == 64);
+
+    size_t size = 0;
+    BOOST_CHECK(cache.size(hashes[0], size) && size == 1000);
+    std::shared_ptr<dev::bytes const> code = cache.code(hashes[1]);
+    BOOST_CHECK(code && *code == dev::bytes(1000, uint8_t(1)));
+    BOOST_CHECK(!cache.code(dev::sha3(dev::bytes(1, 0xff))));
+
+    // Shrinking the cache evicts entries but keeps the code handed out alive
+    cache.setMaxUsage(0);
+    BOOST_CHECK(cache.stats().entries == 0);
+    BOOST_CHECK(cache.stats().usage == 0);
+    BOOST_CHECK(cache.stats().evictions >= 64);
+    BOOST_CHECK(code->size() == 1000);
+    cache.store(hashes[0], dev::bytes(1000, 0));
+    BOOST_CHECK(!cache.size(hashes[0], size));
+    cache.setMaxUsage(dev::eth::CodeCache::c_defaultMaxUsage);
+}
+
 BOOST_AUTO_TEST_CASE(bytecodeexec_call_contract_OutOfGas_transfer_many_return_value){
     initState();
     std::vector<dev::Address> newAddressGen;
@@ -374,4 +455,82 @@ BOOST_AUTO_TEST_CASE(bytecodeexec_contract_create_contracts){
     BOOST_CHECK(result.second.valueTransfers.size() == 0);
 }
 
+BOOST_AUTO_TEST_CASE(bytecodeexec_call_contract_snapshot){
+    initState();
+    /*
+        Increments slot 0 when called without data, returns it otherwise:
+            CALLDATASIZE PUSH1 14 JUMPI PUSH1 0 SLOAD PUSH1 1 ADD PUSH1 0 SSTORE STOP
+            JUMPDEST PUSH1 0 SLOAD PUSH1 0 MSTORE PUSH1 32 PUSH1 0 RETURN
+    */
+    valtype code = ParseHex("601a80600b6000396000f3" "36600e57600054600101600055005b60005460005260206000f3");
+    RevoTransaction txCreate = createRevoTransaction(code, 0, GASLIMIT, dev::u256(1), HASHTX, dev::Address());
+    executeBC(std::vector<RevoTransaction>(1, txCreate), *m_node.chainman);
+    dev::Address counter = createRevoAddress(txCreate.getHashWith(), txCreate.getNVout());
+    dev::h256 hashTx = HASHTX;
+    executeBC(std::vector<RevoTransaction>(1, createRevoTransaction(valtype(), 0, GASLIMIT, dev::u256(1), ++hashTx, counter)), *m_node.chainman);
+
+    CChainState& chainstate = m_node.chainman->ActiveChainstate();
+    auto snapshot = WITH_LOCK(cs_main, return std::make_unique<ContractCallSnapshot>(chainstate));
+    const valtype query = ParseHex("00");
+    ResultExecute result = snapshot->Call(counter, query);
+    BOOST_CHECK(result.execRes.excepted == dev::eth::TransactionException::None);
+    BOOST_CHECK(dev::h256(result.execRes.output) == dev::h256(1));
+    BOOST_CHECK(result.execRes.output == WITH_LOCK(cs_main, return CallContract(counter, query, chainstate))[0].execRes.output);
+    BOOST_CHECK(snapshot->AddressInUse(counter));
+    BOOST_CHECK(!snapshot->AddressInUse(SENDERADDRESS));
+
+    // Later changes of the state are not seen by the snapshot
+    executeBC(std::vector<RevoTransaction>(1, createRevoTransaction(valtype(), 0, GASLIMIT, dev::u256(1), ++hashTx, counter)), *m_node.chainman);
+    BOOST_CHECK(dev::h256(snapshot->Call(counter, query).execRes.output) == dev::h256(1));
+    BOOST_CHECK(dev::h256(WITH_LOCK(cs_main, return CallContract(counter, query, chainstate))[0].execRes.output) == dev::h256(2));
+
+    // A batch runs in order, and the calls do not see the changes of each other
+    std::vector<ResultExecute> results = snapshot->Call({makeCall(counter, query), makeCall(counter, valtype()), makeCall(counter, query), makeCall(SENDERADDRESS, query)});
+    BOOST_CHECK_EQUAL(results.size(), 4U);
+    BOOST_CHECK(dev::h256(results[0].execRes.output) == dev::h256(1));
+    BOOST_CHECK(results[1].execRes.excepted == dev::eth::TransactionException::None);
+    BOOST_CHECK(dev::h256(results[2].execRes.output) == dev::h256(1));
+    BOOST_CHECK(results[3].execRes.excepted == dev::eth::TransactionException::Unknown);
+
+    // Concurrent calls on the worker threads
+    ContractCaller caller;
+    caller.Start(2);
+    std::vector<valtype> outputs(8);
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < outputs.size(); i++){
+        threads.emplace_back([&, i] { outputs[i] = caller.Call(*snapshot, counter, query).execRes.output; });
+    }
+    for(std::thread& thread : threads){
+        thread.join();
+    }
+    caller.Stop();
+    for(const valtype& output : outputs){
+        BOOST_CHECK(dev::h256(output) == dev::h256(1));
+    }
+    ContractCaller::Stats stats = caller.GetStats();
+    BOOST_CHECK_EQUAL(stats.calls, outputs.size());
+    BOOST_CHECK(stats.gasUsed > 0);
+}
+
+BOOST_AUTO_TEST_CASE(bytecodeexec_call_contract_keeps_no_nodes){
+    initState();
+    // Increments slot 0, see bytecodeexec_call_contract_snapshot
+    valtype code = ParseHex("601a80600b6000396000f3" "36600e57600054600101600055005b60005460005260206000f3");
+    RevoTransaction txCreate = createRevoTransaction(code, 0, GASLIMIT, dev::u256(1), HASHTX, dev::Address());
+    executeBC(std::vector<RevoTransaction>(1, txCreate), *m_node.chainman);
+    dev::Address counter = createRevoAddress(txCreate.getHashWith(), txCreate.getNVout());
+    BOOST_CHECK(globalState->db().pendingMemoryUsage() > 0);
+    FlushContractState();
+    BOOST_CHECK(globalState->db().pending().empty());
+
+    // A reverted call writing to the storage leaves no nodes behind
+    CChainState& chainstate = m_node.chainman->ActiveChainstate();
+    std::vector<ResultExecute> result = WITH_LOCK(cs_main, return CallContract(counter, valtype(), chainstate));
+    BOOST_CHECK(result[0].execRes.excepted == dev::eth::TransactionException::None);
+    BOOST_CHECK(globalState->db().pending().empty());
+    BOOST_CHECK(globalState->dbUtxo().pending().empty());
+    BOOST_CHECK(globalState->db().get().empty());
+    BOOST_CHECK_EQUAL(globalState->db().pendingMemoryUsage(), 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
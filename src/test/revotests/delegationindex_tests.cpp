@@ -0,0 +1,126 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+#include <chainparams.h>
+#include <index/delegationindex.h>
+#include <util/time.h>
+
+namespace DelegationIndexTest{
+
+const std::string STAKER_ADDRESS_HEX = "a2330f4221f31b7d5648eae85e505d73bb852b48";
+const std::string OTHER_STAKER_ADDRESS_HEX = "b2330f4221f31b7d5648eae85e505d73bb852b48";
+const std::string DELEGATE_ADDRESS_HEX = "df329c86d2d31139b2e882df0a83312a8d567d62";
+const std::string POD_HEX = "1f8507f6bc4eded301b61be5dde24923d6eecfe96aae2f3d3cd50e657171e0e13a6c0e114491c3e5699481c6ad45d3c358728fca5821c6aa9487254b1a3725673d";
+
+dev::h256 addressTopic(const std::string& addressHex){
+    return dev::h256(ParseHex(std::string(24, '0') + addressHex));
+}
+
+dev::h256 wordTopic(uint64_t value){
+    return dev::h256(dev::u256(value));
+}
+
+dev::eth::LogEntry addDelegationLog(const std::string& stakerHex, const std::string& delegateHex, uint8_t fee, uint64_t blockHeight){
+    // fee, blockHeight, offset of PoD, length of PoD, PoD padded to 32 bytes
+    dev::bytes data;
+    for(const dev::h256& word : {wordTopic(fee), wordTopic(blockHeight), wordTopic(0x60), wordTopic(65)})
+        data.insert(data.end(), word.begin(), word.end());
+    dev::bytes pod = ParseHex(POD_HEX);
+    pod.resize(96);
+    data.insert(data.end(), pod.begin(), pod.end());
+
+    dev::h256s topics{dev::sha3(std::string("AddDelegation(address,address,uint8,uint256,bytes)")), addressTopic(stakerHex), addressTopic(delegateHex)};
+    return dev::eth::LogEntry(uintToh160(Params().GetConsensus().delegationsAddress), topics, data);
+}
+
+dev::eth::LogEntry removeDelegationLog(const std::string& stakerHex, const std::string& delegateHex){
+    dev::h256s topics{dev::sha3(std::string("RemoveDelegation(address,address)")), addressTopic(stakerHex), addressTopic(delegateHex)};
+    return dev::eth::LogEntry(uintToh160(Params().GetConsensus().delegationsAddress), topics, dev::bytes());
+}
+
+TransactionReceiptInfo receiptInBlock(const uint256& blockHash, const CTransactionRef& tx, const dev::eth::LogEntries& logs){
+    TransactionReceiptInfo receipt{};
+    receipt.blockHash = blockHash;
+    receipt.transactionHash = tx->GetHash();
+    receipt.logs = logs;
+    return receipt;
+}
+
+class MatchAllFilter : public IDelegationFilter
+{
+public:
+    bool Match(const DelegationEvent&) const override { return true; }
+};
+
+CTransactionRef contractCallTx(){
+    CMutableTransaction tx;
+    tx.vout.push_back(CTxOut(0, CScript() << OP_CALL));
+    return MakeTransactionRef(tx);
+}
+
+BOOST_FIXTURE_TEST_SUITE(delegationindex_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(delegation_events_of_block){
+    RevoDelegation revoDelegation;
+    CBlock block(generateBlock());
+    CTransactionRef tx = contractCallTx();
+    block.vtx.push_back(tx);
+    const uint256 blockHash = uint256S("01");
+    const uint256 staleBlockHash = uint256S("02");
+
+    // The transaction was also mined in a stale block, delegating to another staker
+    std::vector<TransactionReceiptInfo> receipts{
+        receiptInBlock(staleBlockHash, tx, {addDelegationLog(OTHER_STAKER_ADDRESS_HEX, DELEGATE_ADDRESS_HEX, 20, 90)}),
+        receiptInBlock(blockHash, tx, {removeDelegationLog(OTHER_STAKER_ADDRESS_HEX, DELEGATE_ADDRESS_HEX), addDelegationLog(STAKER_ADDRESS_HEX, DELEGATE_ADDRESS_HEX, 10, 100)}),
+    };
+    pstorageresult->addResult(uintToh256(tx->GetHash()), receipts);
+    pstorageresult->commitResults();
+
+    // Only the events of the receipt of the block are read, in order
+    std::vector<DelegationEvent> events = GetBlockDelegationEvents(revoDelegation, block, blockHash);
+    BOOST_REQUIRE_EQUAL(events.size(), 2U);
+    BOOST_CHECK(events[0].type == DELEGATION_REMOVE);
+    BOOST_CHECK(events[0].item.delegate == uint160(ParseHex(DELEGATE_ADDRESS_HEX)));
+    BOOST_CHECK(events[1].type == DELEGATION_ADD);
+    BOOST_CHECK(events[1].item.staker == uint160(ParseHex(STAKER_ADDRESS_HEX)));
+    BOOST_CHECK(events[1].item.delegate == uint160(ParseHex(DELEGATE_ADDRESS_HEX)));
+    BOOST_CHECK_EQUAL(events[1].item.fee, 10);
+    BOOST_CHECK_EQUAL(events[1].item.blockHeight, 100U);
+    BOOST_CHECK(events[1].item.PoD == ParseHex(POD_HEX));
+
+    std::vector<DelegationEvent> staleEvents = GetBlockDelegationEvents(revoDelegation, block, staleBlockHash);
+    BOOST_REQUIRE_EQUAL(staleEvents.size(), 1U);
+    BOOST_CHECK(staleEvents[0].item.staker == uint160(ParseHex(OTHER_STAKER_ADDRESS_HEX)));
+
+    // A block the transaction was not mined in has no events
+    BOOST_CHECK(GetBlockDelegationEvents(revoDelegation, block, uint256S("03")).empty());
+}
+
+BOOST_AUTO_TEST_CASE(delegation_index_initial_sync){
+    DelegationIndex delegationindex(1 << 20, true);
+
+    BOOST_CHECK(!delegationindex.BlockUntilSyncedToCurrentChain());
+    BOOST_REQUIRE(delegationindex.Start(m_node.chainman->ActiveChainstate()));
+
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!delegationindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // The chain has no delegation
+    std::map<uint160, Delegation> delegations;
+    BOOST_CHECK(delegationindex.LookUpDelegationsForStaker(uint160(ParseHex(STAKER_ADDRESS_HEX)), delegations));
+    BOOST_CHECK(delegations.empty());
+    Delegation delegation;
+    BOOST_CHECK(!delegationindex.LookUpDelegation(uint160(ParseHex(DELEGATE_ADDRESS_HEX)), delegation));
+    BOOST_CHECK(delegationindex.LookUpDelegations(MatchAllFilter(), delegations));
+    BOOST_CHECK(delegations.empty());
+
+    delegationindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -612,6 +612,62 @@ BOOST_AUTO_TEST_CASE(min_gas_price_passage_from_130_to_0_three_paramsInstance_te
     }
 }
 
+BOOST_AUTO_TEST_CASE(dgp_cache_template_data_test){
+    initState();
+    contractLoading();
+
+    dev::h256 hashTemp(hash);
+    std::vector<RevoTransaction> txs;
+    txs.push_back(createRevoTransaction(code[0], 0, dev::u256(500000), dev::u256(1), hashTemp, GasPriceDGP, 0));
+    txs.push_back(createRevoTransaction(code[10], 0, dev::u256(500000), dev::u256(1), ++hashTemp, dev::Address(), 0));
+    txs.push_back(createRevoTransaction(code[2], 0, dev::u256(500000), dev::u256(1), ++hashTemp, GasPriceDGP, 0));
+    auto result = executeBC(txs, *m_node.chainman);
+
+    // The template proposed by code[2], it only reads its own storage
+    const dev::Address templateAddress("c4c1d7375918557df2ef8f1d1f0b2329cb248a15");
+    const std::vector<unsigned char> data = ParseHex("3fb58819");
+    BOOST_CHECK(RevoDGPCache::ReadsOwnStateOnly(globalState->code(templateAddress)));
+
+    g_dgp_cache.Clear();
+    RevoDGP revoDGP(globalState.get(), m_node.chainman->ActiveChainstate());
+    int height = Params().GetConsensus().CoinbaseMaturity(0) + 2;
+    BOOST_CHECK_EQUAL(revoDGP.getMinGasPrice(height), 13);
+
+    uint256 key = RevoDGPCache::TemplateKey(templateAddress, globalState->storageRoot(templateAddress), globalState->codeHash(templateAddress), data);
+    std::vector<unsigned char> cached;
+    BOOST_CHECK(g_dgp_cache.GetTemplateData(key, cached));
+
+    // A hit is returned without executing the template
+    std::vector<unsigned char> replaced(32, 0);
+    replaced[31] = 200;
+    g_dgp_cache.SetTemplateData(key, replaced);
+    BOOST_CHECK_EQUAL(revoDGP.getMinGasPrice(height), 200);
+
+    // A change of the storage of the template misses and executes it again
+    const dev::h256 oldStorageRoot = globalState->storageRoot(templateAddress);
+    globalState->setStorage(templateAddress, 0, 77);
+    globalState->commit(dev::eth::State::CommitBehaviour::KeepEmptyAccounts);
+    BOOST_CHECK(globalState->storageRoot(templateAddress) != oldStorageRoot);
+    BOOST_CHECK_EQUAL(revoDGP.getMinGasPrice(height), 77);
+    BOOST_CHECK(g_dgp_cache.GetTemplateData(RevoDGPCache::TemplateKey(templateAddress, globalState->storageRoot(templateAddress), globalState->codeHash(templateAddress), data), cached));
+}
+
+BOOST_AUTO_TEST_CASE(dgp_cache_context_test){
+    // PUSH1 0 SLOAD PUSH1 0 MSTORE PUSH1 32 PUSH1 0 RETURN
+    BOOST_CHECK(RevoDGPCache::ReadsOwnStateOnly(ParseHex("60005460005260206000f3")));
+    // NUMBER PUSH1 0 MSTORE PUSH1 32 PUSH1 0 RETURN
+    BOOST_CHECK(!RevoDGPCache::ReadsOwnStateOnly(ParseHex("4360005260206000f3")));
+    // TIMESTAMP, BALANCE of an address and STATICCALL
+    BOOST_CHECK(!RevoDGPCache::ReadsOwnStateOnly(ParseHex("4260005260206000f3")));
+    BOOST_CHECK(!RevoDGPCache::ReadsOwnStateOnly(ParseHex("6001316000f3")));
+    BOOST_CHECK(!RevoDGPCache::ReadsOwnStateOnly(ParseHex("6000600060006000600161fffffa00")));
+    // NUMBER pushed as data, and after the end of the code with no JUMPDEST to reach it
+    BOOST_CHECK(RevoDGPCache::ReadsOwnStateOnly(ParseHex("604360005260206000f3")));
+    BOOST_CHECK(RevoDGPCache::ReadsOwnStateOnly(ParseHex("60206000f3fe43")));
+    // NUMBER after a JUMPDEST can be reached
+    BOOST_CHECK(!RevoDGPCache::ReadsOwnStateOnly(ParseHex("60206000f35b43")));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -0,0 +1,226 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+#include <rpc/contract_util.h>
+#include <txdb.h>
+
+namespace HeightIndexTest{
+
+const dev::h160 ADDRESS_A(0xa1);
+const dev::h160 ADDRESS_B(0xb2);
+const dev::h160 ADDRESS_C(0xc3);
+
+/** Transaction hashes of the logs of an address in a block */
+std::vector<uint256> blockHashes(unsigned int height, const dev::h160& address){
+    return {ArithToUint256(arith_uint256(height) << 32 | address[19]), ArithToUint256(arith_uint256(height) << 32 | address[19] << 8)};
+}
+
+struct HeightIndexRead{
+    int height;
+    std::vector<std::vector<uint256>> blocksOfHashes;
+};
+
+HeightIndexRead readHeightIndex(CBlockTreeDB& db, ChainstateManager& chainman, int low, int high, std::set<dev::h160> const& addresses){
+    HeightIndexRead read;
+    read.height = db.ReadHeightIndex(low, high, 0, read.blocksOfHashes, addresses, {}, chainman);
+    return read;
+}
+
+const dev::h256 TOPIC_1(1);
+const dev::h256 TOPIC_2(2);
+const dev::h256 TOPIC_3(3);
+const dev::h256 TOPIC_4(4);
+const dev::h256 TOPIC_UNUSED(5);
+
+/** Topics of the logs written to the blocks, TOPIC_1 is also used at position 1 */
+const std::vector<dev::h256s> LOG_TOPICS{{TOPIC_1}, {TOPIC_2, TOPIC_1}, {TOPIC_3}, {TOPIC_4, TOPIC_2}, {}};
+
+/** Same topic match as searchlogs: one of the non-null topics at its position in any log */
+bool matchesTopics(const TransactionReceiptInfo& receipt, const std::vector<boost::optional<dev::h256>>& topics){
+    if(receipt.logs.empty()) return false;
+    if(topics.empty()) return true;
+    for(size_t i = 0; i < topics.size(); i++){
+        if(!topics[i]) continue;
+        for(const dev::eth::LogEntry& log : receipt.logs){
+            if(i < log.topics.size() && log.topics[i] == topics[i].get()) return true;
+        }
+    }
+    return false;
+}
+
+/** Write the log events and receipts of a block, with its log bloom when it is at or above the bloom start */
+void writeLogBlock(unsigned int height, size_t pattern, bool fBloom, std::map<uint256, TransactionReceiptInfo>& receipts){
+    dev::eth::LogBloom blockBloom;
+    for(unsigned int j = 0; j < 2; j++){
+        const dev::h160& address = j == 0 ? ADDRESS_A : ADDRESS_B;
+        dev::eth::LogEntry log(address, LOG_TOPICS[(pattern + j * 3) % LOG_TOPICS.size()], dev::bytes());
+        TransactionReceiptInfo receipt{};
+        receipt.blockHash = ArithToUint256(arith_uint256(height));
+        receipt.blockNumber = height;
+        receipt.transactionHash = blockHashes(height, address)[0];
+        receipt.transactionIndex = j;
+        receipt.logs = {log};
+        receipt.bloom = log.bloom();
+        blockBloom |= receipt.bloom;
+        receipts[receipt.transactionHash] = receipt;
+
+        std::vector<TransactionReceiptInfo> result{receipt};
+        pstorageresult->addResult(uintToh256(receipt.transactionHash), result);
+        BOOST_CHECK(pblocktree->WriteHeightIndex(CHeightTxIndexKey(height, address), {receipt.transactionHash}));
+    }
+    pstorageresult->commitResults();
+    if(fBloom) BOOST_CHECK(pblocktree->WriteLogBloomIndex(height, blockBloom));
+}
+
+UniValue searchLogs(ChainstateManager& chainman, std::set<dev::h160> const& addresses, std::vector<boost::optional<dev::h256>> const& topics){
+    UniValue addressesJson(UniValue::VARR);
+    for(const dev::h160& address : addresses) addressesJson.push_back(address.hex());
+    UniValue topicsJson(UniValue::VARR);
+    for(const auto& topic : topics) topicsJson.push_back(topic ? UniValue(topic->hex()) : NullUniValue);
+
+    UniValue params(UniValue::VARR);
+    params.push_back(0);
+    params.push_back(9000);
+    UniValue addressesObj(UniValue::VOBJ);
+    addressesObj.pushKV("addresses", addressesJson);
+    params.push_back(addressesObj);
+    UniValue topicsObj(UniValue::VOBJ);
+    topicsObj.pushKV("topics", topicsJson);
+    params.push_back(topicsObj);
+    return SearchLogs(params, chainman);
+}
+
+BOOST_FIXTURE_TEST_SUITE(heightindex_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(heightindex_upgrade_address_index){
+    CBlockTreeDB db(1 << 20, true);
+
+    // Written like older versions, with the (height, address) index only
+    for(unsigned int height = 1; height <= 30; height++){
+        for(const dev::h160& address : {ADDRESS_A, ADDRESS_B, ADDRESS_C}){
+            if((height + address[19]) % 3 == 0) continue;
+            BOOST_CHECK(db.Write(std::make_pair(uint8_t('h'), CHeightTxIndexKey(height, address)), blockHashes(height, address)));
+        }
+    }
+
+    const std::vector<std::set<dev::h160>> filters{{}, {ADDRESS_A}, {ADDRESS_B, ADDRESS_C}, {ADDRESS_A, ADDRESS_B, ADDRESS_C}, {dev::h160(0xd4)}};
+    const std::vector<std::pair<int, int>> ranges{{0, -1}, {1, 30}, {5, 20}, {7, 7}, {25, 40}, {31, -1}};
+
+    // Read the old format with the (height, address) scan
+    std::vector<HeightIndexRead> expected;
+    for(const auto& addresses : filters){
+        for(const auto& [low, high] : ranges){
+            expected.push_back(readHeightIndex(db, *m_node.chainman, low, high, addresses));
+        }
+    }
+
+    // The upgrade builds the (address, height) index, which then serves the address filters
+    BOOST_CHECK(db.UpgradeAddressHeightIndex());
+    bool fHaveIndex = false;
+    BOOST_CHECK(db.ReadFlag("addressheightindex", fHaveIndex) && fHaveIndex);
+
+    size_t i = 0;
+    for(const auto& addresses : filters){
+        for(const auto& [low, high] : ranges){
+            HeightIndexRead read = readHeightIndex(db, *m_node.chainman, low, high, addresses);
+            BOOST_CHECK_EQUAL(read.height, expected[i].height);
+            BOOST_CHECK(read.blocksOfHashes == expected[i].blocksOfHashes);
+            i++;
+        }
+    }
+
+    // An upgraded index is not built again and matches one written by this version
+    BOOST_CHECK(db.UpgradeAddressHeightIndex());
+    CBlockTreeDB dbNew(1 << 20, true);
+    for(unsigned int height = 1; height <= 30; height++){
+        for(const dev::h160& address : {ADDRESS_A, ADDRESS_B, ADDRESS_C}){
+            if((height + address[19]) % 3 == 0) continue;
+            BOOST_CHECK(dbNew.WriteHeightIndex(CHeightTxIndexKey(height, address), blockHashes(height, address)));
+        }
+    }
+    BOOST_CHECK(dbNew.UpgradeAddressHeightIndex());
+    i = 0;
+    for(const auto& addresses : filters){
+        for(const auto& [low, high] : ranges){
+            HeightIndexRead read = readHeightIndex(dbNew, *m_node.chainman, low, high, addresses);
+            BOOST_CHECK_EQUAL(read.height, expected[i].height);
+            BOOST_CHECK(read.blocksOfHashes == expected[i].blocksOfHashes);
+            i++;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(heightindex_log_bloom_skips_blocks){
+    const bool fLogEventsOld = fLogEvents;
+    fLogEvents = true;
+    BOOST_REQUIRE(pblocktree->UpgradeAddressHeightIndex());
+
+    // Blocks indexed before the bloom index have no bloom and are never skipped
+    std::map<uint256, TransactionReceiptInfo> receipts;
+    for(unsigned int height = 1; height <= 10; height++){
+        writeLogBlock(height, height, false, receipts);
+    }
+    BOOST_REQUIRE(pblocktree->UpgradeLogBloomIndex());
+
+    // Blocks with blooms in three sections, the last one without TOPIC_1
+    std::vector<unsigned int> heights;
+    for(unsigned int height = 11; height <= 30; height++) heights.push_back(height);
+    for(unsigned int height = 4094; height <= 4099; height++) heights.push_back(height);
+    for(unsigned int height = 8192; height <= 8195; height++) heights.push_back(height);
+    for(unsigned int height : heights){
+        writeLogBlock(height, height >= 8192 ? 4 : height, true, receipts);
+    }
+
+    const std::vector<std::vector<boost::optional<dev::h256>>> topicFilters{
+        {TOPIC_1},
+        {boost::none, TOPIC_1},
+        {TOPIC_2, TOPIC_1},
+        {TOPIC_4},
+        {TOPIC_3},
+        {TOPIC_UNUSED},
+    };
+    for(const std::set<dev::h160>& addresses : {std::set<dev::h160>(), std::set<dev::h160>{ADDRESS_A}}){
+        UniValue unfiltered = searchLogs(*m_node.chainman, addresses, {});
+        for(const auto& topics : topicFilters){
+            // The blooms only skip blocks that cannot match, the receipts of the others are post-filtered
+            std::vector<std::string> expected;
+            for(const UniValue& entry : unfiltered.getValues()){
+                const std::string hash = find_value(entry, "transactionHash").get_str();
+                if(matchesTopics(receipts.at(uint256S(hash)), topics)) expected.push_back(hash);
+            }
+            std::vector<std::string> found;
+            for(const UniValue& entry : searchLogs(*m_node.chainman, addresses, topics).getValues()){
+                found.push_back(find_value(entry, "transactionHash").get_str());
+            }
+            BOOST_CHECK(found == expected);
+
+            // The last indexed height of the range does not depend on the skipped blocks
+            std::vector<std::vector<uint256>> blocksFiltered, blocksUnfiltered;
+            int heightFiltered = pblocktree->ReadHeightIndex(0, 9000, 0, blocksFiltered, addresses, topics, *m_node.chainman);
+            int heightUnfiltered = pblocktree->ReadHeightIndex(0, 9000, 0, blocksUnfiltered, addresses, {}, *m_node.chainman);
+            BOOST_CHECK_EQUAL(heightFiltered, 8195);
+            BOOST_CHECK_EQUAL(heightUnfiltered, 8195);
+            BOOST_CHECK(blocksFiltered.size() <= blocksUnfiltered.size());
+        }
+
+        // An unused topic only reads the blocks without bloom
+        std::vector<std::vector<uint256>> blocks;
+        pblocktree->ReadHeightIndex(0, 9000, 0, blocks, addresses, {TOPIC_UNUSED}, *m_node.chainman);
+        BOOST_CHECK_EQUAL(blocks.size(), addresses.empty() ? 20U : 10U);
+
+        // TOPIC_1 at position 1 makes blocks with a bloom pass, their receipts are dropped by the post-filter
+        std::vector<std::vector<uint256>> blocksPosition0;
+        pblocktree->ReadHeightIndex(0, 9000, 0, blocksPosition0, addresses, {TOPIC_1}, *m_node.chainman);
+        size_t falsePositives = 0;
+        for(const auto& hashes : blocksPosition0){
+            const TransactionReceiptInfo& receipt = receipts.at(hashes[0]);
+            if(receipt.blockNumber > 10 && !matchesTopics(receipt, {TOPIC_1})) falsePositives++;
+        }
+        BOOST_CHECK(falsePositives > 0);
+    }
+
+    fLogEvents = fLogEventsOld;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+
+#include <libdevcore/NodeCache.h>
+#include <libdevcore/OverlayDB.h>
+
+namespace NodeCacheTest{
+
+/** Hash of a node in the first shard of the cache */
+dev::h256 shardHash(uint8_t n){
+    dev::h256 hash;
+    hash[0] = dev::NodeCache::c_shards;
+    hash[31] = n;
+    return hash;
+}
+
+/** Write a node to a state database and return its hash */
+dev::h256 writeNode(dev::OverlayDB& db, const std::string& value){
+    dev::bytes node = dev::asBytes(value);
+    dev::h256 hash = dev::sha3(node);
+    db.insert(hash, &node);
+    return hash;
+}
+
+BOOST_FIXTURE_TEST_SUITE(nodecache_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(nodecache_evicts_least_recently_used){
+    // Room for three nodes of 100 bytes per shard
+    const std::string value(100, 'x');
+    const size_t entryUsage = value.size() + sizeof(dev::h256) * 2 + 64;
+    dev::NodeCache cache(3 * entryUsage * dev::NodeCache::c_shards);
+    BOOST_CHECK_EQUAL(cache.maxUsage(), 3 * entryUsage * dev::NodeCache::c_shards);
+
+    cache.insert(shardHash(1), value);
+    cache.insert(shardHash(2), value);
+    cache.insert(shardHash(3), value);
+    BOOST_CHECK_EQUAL(cache.usage(), 3 * entryUsage);
+
+    // Reading a node makes it the most recently used one
+    std::string read;
+    BOOST_CHECK(cache.lookup(shardHash(1), read));
+    BOOST_CHECK_EQUAL(read, value);
+    cache.insert(shardHash(4), value);
+    BOOST_CHECK(cache.contains(shardHash(1)));
+    BOOST_CHECK(!cache.contains(shardHash(2)));
+    BOOST_CHECK(cache.contains(shardHash(3)));
+    BOOST_CHECK(cache.contains(shardHash(4)));
+    BOOST_CHECK_EQUAL(cache.usage(), 3 * entryUsage);
+
+    // Inserting a cached node again also refreshes it
+    cache.insert(shardHash(3), value);
+    cache.insert(shardHash(5), value);
+    BOOST_CHECK(!cache.contains(shardHash(1)));
+    BOOST_CHECK(cache.contains(shardHash(3)));
+
+    // Other shards are not affected by a full one
+    dev::h256 other = shardHash(6);
+    other[0] = 1;
+    cache.insert(other, value);
+    BOOST_CHECK(cache.contains(other));
+    BOOST_CHECK(cache.contains(shardHash(3)));
+    BOOST_CHECK(cache.contains(shardHash(4)));
+    BOOST_CHECK(cache.contains(shardHash(5)));
+
+    // Nodes larger than a shard are never cached
+    cache.insert(shardHash(7), std::string(3 * entryUsage, 'y'));
+    BOOST_CHECK(!cache.contains(shardHash(7)));
+
+    cache.erase(shardHash(3));
+    BOOST_CHECK(!cache.lookup(shardHash(3), read));
+    BOOST_CHECK_EQUAL(cache.usage(), 3 * entryUsage);
+    BOOST_CHECK_EQUAL(cache.hits(), 1U);
+    BOOST_CHECK_EQUAL(cache.misses(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(nodecache_overlay_commit_rollback){
+    dev::OverlayDB& db = globalState->db();
+    auto cache = std::make_shared<dev::NodeCache>(1 << 20);
+    db.setNodeCache(cache);
+
+    // Nodes rolled back never reach the cache
+    dev::h256 a = writeNode(db, "a");
+    db.rollback();
+    db.commit();
+    BOOST_CHECK(!cache->contains(a));
+    BOOST_CHECK(!db.exists(a));
+
+    // Committed nodes are cached, also when they were checkpointed first
+    dev::h256 b = writeNode(db, "b");
+    db.checkpoint();
+    BOOST_CHECK(!cache->contains(b));
+    dev::h256 c = writeNode(db, "c");
+    db.commit();
+    BOOST_CHECK(cache->contains(b));
+    BOOST_CHECK(cache->contains(c));
+
+    // Reads of committed nodes are served by the cache
+    uint64_t hits = cache->hits();
+    BOOST_CHECK_EQUAL(db.lookup(b), "b");
+    BOOST_CHECK_EQUAL(cache->hits(), hits + 1);
+
+    // A node read from the database is cached, and copies of the overlay share the cache
+    cache->erase(c);
+    dev::OverlayDB copy = db;
+    BOOST_CHECK_EQUAL(copy.lookup(c), "c");
+    BOOST_CHECK(cache->contains(c));
+    BOOST_CHECK(copy.nodeCache() == cache);
+
+    db.setNodeCache(nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,120 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+
+#include <libdevcore/OverlayDB.h>
+
+namespace OverlayDBTest{
+
+/** Write a node to a state database and return its hash */
+dev::h256 writeNode(dev::OverlayDB& db, const std::string& value){
+    dev::bytes node = dev::asBytes(value);
+    dev::h256 hash = dev::sha3(node);
+    db.insert(hash, &node);
+    return hash;
+}
+
+BOOST_FIXTURE_TEST_SUITE(overlaydb_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(overlaydb_checkpoint_commit_rollback){
+    dev::OverlayDB& db = globalState->db();
+    // A copy without in-memory nodes only sees the database
+    const dev::OverlayDB disk = db;
+
+    // Checkpointed nodes are visible until they are committed to the database
+    dev::h256 a = writeNode(db, "a");
+    db.checkpoint();
+    BOOST_CHECK(db.pendingMemoryUsage() > 0);
+    BOOST_CHECK_EQUAL(db.lookup(a), "a");
+    BOOST_CHECK(!disk.exists(a));
+
+    // Rolling back drops the nodes written since the checkpoint only
+    dev::h256 b = writeNode(db, "b");
+    BOOST_CHECK(db.exists(b));
+    db.rollback();
+    BOOST_CHECK(!db.exists(b));
+    BOOST_CHECK_EQUAL(db.lookup(a), "a");
+
+    // Releasing a checkpointed node keeps it, like a node on disk
+    db.kill(a);
+    BOOST_CHECK_EQUAL(db.lookup(a), "a");
+
+    db.commit();
+    BOOST_CHECK_EQUAL(db.pendingMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(disk.lookup(a), "a");
+    BOOST_CHECK(!disk.exists(b));
+
+    // Nodes rolled back before any checkpoint never reach the database
+    dev::h256 c = writeNode(db, "c");
+    db.rollback();
+    db.commit();
+    BOOST_CHECK(!disk.exists(c));
+}
+
+BOOST_AUTO_TEST_CASE(overlaydb_pending_copy_rollback){
+    dev::OverlayDB& db = globalState->db();
+    db.commit();
+    dev::h256 a = writeNode(db, "a");
+    db.checkpoint();
+    const size_t usage = db.pendingMemoryUsage();
+
+    // Copies share the checkpointed nodes instead of copying them
+    dev::OverlayDB copy = db;
+    BOOST_REQUIRE_EQUAL(copy.pending().size(), 1U);
+    BOOST_CHECK(copy.pending()[0] == db.pending()[0]);
+    BOOST_CHECK_EQUAL(copy.lookup(a), "a");
+
+    // Nodes checkpointed after the copy go to a new set the copy does not see
+    const dev::OverlayDB::PendingNodes before = db.pending();
+    dev::h256 b = writeNode(db, "b");
+    db.checkpoint();
+    BOOST_CHECK_EQUAL(db.pending().size(), 2U);
+    BOOST_CHECK_EQUAL(db.pendingSince(before).size(), 1U);
+    BOOST_CHECK(!copy.exists(b));
+
+    // Rolling back to the nodes taken before drops the later ones only
+    dev::OverlayDB::PendingNodes later = db.pendingSince(before);
+    db.rollback(before);
+    BOOST_CHECK(!db.exists(b));
+    BOOST_CHECK_EQUAL(db.lookup(a), "a");
+    BOOST_CHECK_EQUAL(db.pendingMemoryUsage(), usage);
+
+    // Dropped nodes can be added back, in a single set when merged
+    db.addPending(dev::OverlayDB::mergePending(later));
+    BOOST_CHECK_EQUAL(db.lookup(b), "b");
+    BOOST_CHECK_EQUAL(dev::OverlayDB::mergePending(db.pending()).size(), 1U);
+    db.rollback(before);
+}
+
+BOOST_AUTO_TEST_CASE(overlaydb_flush_with_coins_tip){
+    CChainState& chainstate = m_node.chainman->ActiveChainstate();
+    const dev::OverlayDB disk = globalState->db();
+    const dev::OverlayDB diskUtxo = globalState->dbUtxo();
+
+    // Nodes of blocks kept in memory during initial block download
+    dev::h256 a = writeNode(globalState->db(), "a");
+    dev::h256 u = writeNode(globalState->dbUtxo(), "u");
+    globalState->db().checkpoint();
+    globalState->dbUtxo().checkpoint();
+    BOOST_CHECK(!disk.exists(a));
+    BOOST_CHECK(!diskUtxo.exists(u));
+
+    // Flushing the chainstate writes the contract state first
+    chainstate.ForceFlushStateToDisk();
+    BOOST_CHECK_EQUAL(globalState->db().pendingMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(globalState->dbUtxo().pendingMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(disk.lookup(a), "a");
+    BOOST_CHECK_EQUAL(diskUtxo.lookup(u), "u");
+
+    // The state roots of the block the coins tip is at are on disk
+    LOCK(cs_main);
+    const CBlockIndex* tip = chainstate.m_chain.Tip();
+    BOOST_CHECK(chainstate.CoinsTip().GetBestBlock() == tip->GetBlockHash());
+    BOOST_CHECK(chainstate.CoinsDB().GetBestBlock() == tip->GetBlockHash());
+    for (const auto& [db, root] : {std::make_pair(&disk, tip->hashStateRoot), std::make_pair(&diskUtxo, tip->hashUTXORoot)}) {
+        BOOST_CHECK(uintToh256(root) == dev::EmptyTrie || db->exists(uintToh256(root)));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
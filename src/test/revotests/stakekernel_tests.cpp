@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+#include <pos.h>
+
+namespace StakeKernelTest{
+
+const uint32_t BLOCK_TIME = 1600000000;
+
+/** Stake prevouts meeting a base target of 2^224 with a chance of about amount / 2^32 */
+struct StakeKernels{
+    CBlockIndex index;
+    unsigned int nBits;
+    std::vector<COutPoint> prevouts;
+    std::map<COutPoint, CStakeCache> cache;
+    std::vector<CStakeKernel> kernels;
+
+    explicit StakeKernels(size_t count){
+        index.nHeight = 100;
+        index.nStakeModifier = InsecureRand256();
+        nBits = arith_uint256(arith_uint256(1) << 224).GetCompact();
+
+        for(size_t i = 0; i < count; i++){
+            COutPoint prevout(InsecureRand256(), InsecureRandRange(4));
+            prevouts.push_back(prevout);
+            // Some prevouts are missing from the cache, some are too young for the block times
+            if(i % 10 == 3) continue;
+            uint32_t blockFromTime = i % 10 == 7 ? BLOCK_TIME + 100 : BLOCK_TIME - InsecureRandRange(100000);
+            cache.emplace(prevout, CStakeCache(blockFromTime, 1 + InsecureRandBits(32)));
+        }
+        PrepareStakeKernels(&index, prevouts, cache, kernels);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(stakekernel_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(stakekernel_batch_matches_kernel_hash){
+    StakeKernels stake(1000);
+    BOOST_REQUIRE_EQUAL(stake.kernels.size(), stake.prevouts.size());
+
+    // Blocks before and after the heights whose kernel weight divides the proof instead of multiplying the target
+    const int nReduceBlocktimeHeight = Params().GetConsensus().nReduceBlocktimeHeight;
+    for(int nHeight : {nReduceBlocktimeHeight - 2, nReduceBlocktimeHeight + 1}){
+        stake.index.nHeight = nHeight;
+        for(uint32_t nTimeBlock = BLOCK_TIME; nTimeBlock < BLOCK_TIME + 16 * 10; nTimeBlock += 16){
+            std::vector<std::pair<size_t, uint256>> solved;
+            CheckKernelBatch(&stake.index, stake.nBits, nTimeBlock, stake.kernels, 0, stake.kernels.size(), solved);
+
+            std::vector<std::pair<size_t, uint256>> expected;
+            for(size_t i = 0; i < stake.prevouts.size(); i++){
+                auto it = stake.cache.find(stake.prevouts[i]);
+                if(it == stake.cache.end() || nTimeBlock < it->second.blockFromTime){
+                    BOOST_CHECK(!stake.kernels[i].valid || nTimeBlock < stake.kernels[i].blockFromTime);
+                    continue;
+                }
+                uint256 hashProofOfStake, targetProofOfStake;
+                if(CheckStakeKernelHash(&stake.index, stake.nBits, it->second.blockFromTime, it->second.amount, stake.prevouts[i], nTimeBlock, hashProofOfStake, targetProofOfStake)){
+                    expected.emplace_back(i, hashProofOfStake);
+                }
+            }
+            BOOST_CHECK(solved == expected);
+            BOOST_CHECK(!solved.empty() && solved.size() < stake.prevouts.size());
+
+            // A range only checks its own kernels, an end past the kernels is clamped
+            std::vector<std::pair<size_t, uint256>> ranges;
+            CheckKernelBatch(&stake.index, stake.nBits, nTimeBlock, stake.kernels, 0, 300, ranges);
+            CheckKernelBatch(&stake.index, stake.nBits, nTimeBlock, stake.kernels, 300, stake.kernels.size() + 100, ranges);
+            BOOST_CHECK(ranges == expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stakekernel_queued_search_matches_serial){
+    StakeKernels stake(3000);
+    CCheckQueue<CKernelCheck> queue{16};
+    queue.StartWorkerThreads(3, "kernelcheck");
+
+    for(uint32_t nTimeBlock = BLOCK_TIME; nTimeBlock < BLOCK_TIME + 16 * 10; nTimeBlock += 16){
+        CKernelSearch serialSearch(&stake.index, stake.nBits, nTimeBlock, stake.kernels);
+        std::vector<std::pair<size_t, uint256>> serial;
+        BOOST_CHECK(SearchStakeKernels(serialSearch, nullptr, serial));
+
+        CKernelSearch queuedSearch(&stake.index, stake.nBits, nTimeBlock, stake.kernels);
+        std::vector<std::pair<size_t, uint256>> queued;
+        BOOST_CHECK(SearchStakeKernels(queuedSearch, &queue, queued));
+
+        // Both accept the same kernels, the ones the single kernel check accepts
+        BOOST_CHECK(queued == serial);
+        std::vector<std::pair<size_t, uint256>> expected;
+        for(size_t i = 0; i < stake.prevouts.size(); i++){
+            uint256 hashProofOfStake;
+            if(CheckKernelCache(&stake.index, stake.nBits, nTimeBlock, stake.prevouts[i], stake.cache, hashProofOfStake)){
+                expected.emplace_back(i, hashProofOfStake);
+            }
+        }
+        BOOST_CHECK(serial == expected);
+        BOOST_CHECK(!serial.empty() && serial.size() < stake.prevouts.size());
+    }
+
+    // An interrupted search checks no kernels
+    CKernelSearch interrupted(&stake.index, stake.nBits, BLOCK_TIME, stake.kernels, []{ return true; });
+    std::vector<std::pair<size_t, uint256>> solved;
+    BOOST_CHECK(!SearchStakeKernels(interrupted, nullptr, solved));
+    BOOST_CHECK(solved.empty());
+    BOOST_CHECK(!SearchStakeKernels(interrupted, &queue, solved));
+    BOOST_CHECK(solved.empty());
+
+    queue.StopWorkerThreads();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
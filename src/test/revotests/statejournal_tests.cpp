@@ -0,0 +1,101 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+#include <revo/statejournal.h>
+
+#include <libdevcore/OverlayDB.h>
+
+namespace StateJournalTest{
+
+/** Write a node to a state database and return its hash */
+dev::h256 writeNode(dev::OverlayDB& db, const std::string& value){
+    dev::bytes node = dev::asBytes(value);
+    dev::h256 hash = dev::sha3(node);
+    db.insert(hash, &node);
+    return hash;
+}
+
+std::set<uint256> toSet(const std::vector<uint256>& nodes){
+    return std::set<uint256>(nodes.begin(), nodes.end());
+}
+
+BOOST_FIXTURE_TEST_SUITE(statejournal_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(statejournal_records_nodes_per_block){
+    StateJournal journal(m_args.GetDataDirBase() / "journal", 1 << 20, true);
+    journal.Attach(*globalState);
+
+    // Nodes committed while connecting the first block
+    dev::h256 a = writeNode(globalState->db(), "a");
+    dev::h256 b = writeNode(globalState->db(), "b");
+    globalState->db().commit();
+    dev::h256 u = writeNode(globalState->dbUtxo(), "u");
+    globalState->dbUtxo().commit();
+    BOOST_CHECK(journal.WriteBlock(1, uint256S("01")));
+
+    // Nodes committed and released while connecting the second block
+    dev::h256 c = writeNode(globalState->db(), "c");
+    globalState->db().commit();
+    globalState->db().kill(a);
+    BOOST_CHECK(journal.WriteBlock(2, uint256S("02")));
+
+    // A block touching no node has no entry
+    BOOST_CHECK(journal.WriteBlock(3, uint256S("03")));
+    BOOST_CHECK_EQUAL(journal.CountEntries(), 2U);
+
+    std::vector<std::pair<StateJournalKey, StateJournalEntry>> entries;
+    BOOST_CHECK(journal.ReadEntries(2, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 2U);
+    BOOST_CHECK_EQUAL(entries[0].first.height, 1U);
+    BOOST_CHECK(entries[0].first.blockHash == uint256S("01"));
+    BOOST_CHECK(toSet(entries[0].second.stateNodes) == std::set<uint256>({h256Touint(a), h256Touint(b)}));
+    BOOST_CHECK(toSet(entries[0].second.utxoNodes) == std::set<uint256>({h256Touint(u)}));
+    BOOST_CHECK_EQUAL(entries[1].first.height, 2U);
+    BOOST_CHECK(toSet(entries[1].second.stateNodes) == std::set<uint256>({h256Touint(c), h256Touint(a)}));
+    BOOST_CHECK(entries[1].second.utxoNodes.empty());
+
+    // Only the entries up to the height are read
+    entries.clear();
+    BOOST_CHECK(journal.ReadEntries(1, entries));
+    BOOST_CHECK_EQUAL(entries.size(), 1U);
+
+    // A block connected again after a reorg keeps the nodes touched the first time
+    dev::h256 d = writeNode(globalState->db(), "d");
+    globalState->db().commit();
+    BOOST_CHECK(journal.WriteBlock(2, uint256S("02")));
+    entries.clear();
+    BOOST_CHECK(journal.ReadEntries(2, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 2U);
+    BOOST_CHECK(toSet(entries[1].second.stateNodes) == std::set<uint256>({h256Touint(c), h256Touint(a), h256Touint(d)}));
+
+    // Erased entries are gone
+    BOOST_CHECK(journal.EraseEntries({entries[0].first, entries[1].first}));
+    BOOST_CHECK_EQUAL(journal.CountEntries(), 0U);
+    entries.clear();
+    BOOST_CHECK(journal.ReadEntries(std::numeric_limits<int>::max(), entries));
+    BOOST_CHECK(entries.empty());
+
+    globalState->db().setJournal(nullptr);
+    globalState->dbUtxo().setJournal(nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(statejournal_wipe){
+    const fs::path path = m_args.GetDataDirBase() / "journal";
+    {
+        StateJournal journal(path, 1 << 20);
+        journal.Attach(*globalState);
+        writeNode(globalState->db(), "a");
+        globalState->db().commit();
+        BOOST_CHECK(journal.WriteBlock(1, uint256S("01")));
+        BOOST_CHECK_EQUAL(journal.CountEntries(), 1U);
+        globalState->db().setJournal(nullptr);
+        globalState->dbUtxo().setJournal(nullptr);
+    }
+
+    // Reopening keeps the entries, wiping as -reindex does drops them
+    BOOST_CHECK_EQUAL(StateJournal(path, 1 << 20).CountEntries(), 1U);
+    BOOST_CHECK_EQUAL(StateJournal(path, 1 << 20, false, true).CountEntries(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,139 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+#include <revo/statejournal.h>
+#include <revo/statepruner.h>
+#include <rpc/server.h>
+#include <util/time.h>
+
+#include <libdevcore/OverlayDB.h>
+#include <libdevcore/TrieDB.h>
+
+namespace StatePrunerTest{
+
+const int PRUNE_DEPTH = 10;
+
+/** Run the first pass of a pruner and stop it */
+void runPass(StatePruner& pruner){
+    BOOST_REQUIRE(pruner.Start());
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (pruner.GetStats().lastPassTime == 0) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{10});
+    }
+    pruner.Stop();
+}
+
+size_t countEntries(dev::OverlayDB& db, const dev::h256& root){
+    dev::GenericTrieDB<dev::OverlayDB> trie(&db);
+    trie.setRoot(root);
+    size_t count = 0;
+    for (auto it = trie.begin(); it != trie.end(); ++it)
+        count++;
+    return count;
+}
+
+/** Call a block RPC and return the error message, empty if it succeeded */
+std::string callBlockRPC(NodeContext& node, const std::string& method, const uint256& hash){
+    JSONRPCRequest request;
+    request.context = &node;
+    request.strMethod = method;
+    request.params = UniValue(UniValue::VARR);
+    request.params.push_back(hash.GetHex());
+    if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+    try {
+        tableRPC.execute(request);
+    } catch (const UniValue& objError) {
+        return find_value(objError, "message").get_str();
+    }
+    return "";
+}
+
+BOOST_FIXTURE_TEST_SUITE(statepruner_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(statepruner_deletes_unreachable_nodes){
+    pstatejournal.reset(new StateJournal(m_args.GetDataDirBase() / "journal", 1 << 20, true));
+    pstatejournal->Attach(*globalState);
+
+    const CBlockIndex* tip = WITH_LOCK(cs_main, return m_node.chainman->ActiveTip());
+    const dev::h256 liveRoot = uintToh256(tip->hashStateRoot);
+    const size_t liveEntries = countEntries(globalState->db(), liveRoot);
+    BOOST_REQUIRE(liveEntries > 0);
+
+    // A trie left behind by an old block, which no kept block references
+    dev::GenericTrieDB<dev::OverlayDB> stale(&globalState->db());
+    stale.init();
+    for (int i = 0; i < 3; i++)
+        stale.insert(dev::asBytes("key" + std::to_string(i)), dev::bytes(64, i));
+    const dev::h256 staleRoot = stale.root();
+    std::vector<dev::h256> staleNodes;
+    for (const auto& node : globalState->db().get())
+        staleNodes.push_back(node.first);
+    globalState->db().commit();
+
+    // The old block also wrote the root of the live state, which must be kept
+    const std::string liveNode = globalState->db().lookup(liveRoot);
+    globalState->db().insert(liveRoot, dev::bytesConstRef(liveNode));
+    globalState->db().commit();
+    BOOST_CHECK(pstatejournal->WriteBlock(1, tip->GetAncestor(1)->GetBlockHash()));
+    BOOST_CHECK(globalState->db().exists(staleRoot));
+
+    StatePruner pruner(*m_node.chainman, PRUNE_DEPTH, 1);
+    runPass(pruner);
+
+    const int nPruneHeight = tip->nHeight - PRUNE_DEPTH;
+    StatePrunerStats stats = pruner.GetStats();
+    BOOST_CHECK_EQUAL(stats.pruneHeight, nPruneHeight);
+    BOOST_CHECK(pruner.IsPruned(nPruneHeight));
+    BOOST_CHECK(!pruner.IsPruned(nPruneHeight + 1));
+    BOOST_CHECK_EQUAL(pstatejournal->CountEntries(), 0U);
+
+    // The nodes of the unreachable trie are gone, the kept state is still readable
+    BOOST_CHECK(!globalState->db().exists(staleRoot));
+    for (const dev::h256& node : staleNodes)
+        BOOST_CHECK(node == dev::EmptyTrie || !globalState->db().exists(node));
+    BOOST_CHECK_EQUAL(countEntries(globalState->db(), liveRoot), liveEntries);
+
+    // The pruned height is kept across restarts
+    int nStoredHeight = 0;
+    BOOST_CHECK(pstatejournal->ReadPruneHeight(nStoredHeight));
+    BOOST_CHECK_EQUAL(nStoredHeight, nPruneHeight);
+    StatePruner restarted(*m_node.chainman, PRUNE_DEPTH, 1);
+    BOOST_CHECK(restarted.Start());
+    BOOST_CHECK(restarted.IsPruned(nPruneHeight));
+    restarted.Stop();
+
+    globalState->db().setJournal(nullptr);
+    globalState->dbUtxo().setJournal(nullptr);
+    pstatejournal.reset();
+}
+
+BOOST_AUTO_TEST_CASE(statepruner_rejects_deep_rewinds){
+    g_state_pruner = std::make_unique<StatePruner>(*m_node.chainman, PRUNE_DEPTH);
+    ChainstateManager& chainman = *m_node.chainman;
+    const CBlockIndex* tip = WITH_LOCK(cs_main, return chainman.ActiveTip());
+
+    // Invalidating the block above the prune depth would rewind to a state which may be pruned
+    const CBlockIndex* deep = tip->GetAncestor(tip->nHeight - PRUNE_DEPTH + 1);
+    BOOST_CHECK(!g_state_pruner->CanRewindTo(deep->pprev->nHeight, tip->nHeight));
+    BOOST_CHECK(callBlockRPC(m_node, "invalidateblock", deep->GetBlockHash()).find("-prunestate=10") != std::string::npos);
+    BOOST_CHECK(WITH_LOCK(cs_main, return chainman.ActiveTip()) == tip);
+
+    // Rewinds within the prune depth are fine
+    const CBlockIndex* recent = deep->GetAncestor(deep->nHeight + 1);
+    BOOST_CHECK(g_state_pruner->CanRewindTo(recent->pprev->nHeight, tip->nHeight));
+    BOOST_CHECK_EQUAL(callBlockRPC(m_node, "invalidateblock", recent->GetBlockHash()), "");
+    BOOST_CHECK(WITH_LOCK(cs_main, return chainman.ActiveTip()) == recent->pprev);
+
+    // Reconsidering the old branch once the new one is deeper than the prune depth is rejected
+    SetMockTime(GetTime() + 1);
+    mineBlocks(PRUNE_DEPTH);
+    BOOST_CHECK(callBlockRPC(m_node, "reconsiderblock", recent->GetBlockHash()).find("-prunestate=10") != std::string::npos);
+    BOOST_CHECK(WITH_LOCK(cs_main, return chainman.ActiveTip())->nHeight == recent->nHeight + PRUNE_DEPTH - 1);
+
+    g_state_pruner.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
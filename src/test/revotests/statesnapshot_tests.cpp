@@ -0,0 +1,185 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+
+#include <libethereum/State.h>
+#include <libethereum/StateSnapshot.h>
+
+using namespace dev;
+using namespace dev::eth;
+
+namespace StateSnapshotTest{
+
+const Address contract("0000000000000000000000000000000000000a01");
+const Address user("0000000000000000000000000000000000000a02");
+const Address empty("0000000000000000000000000000000000000a03");
+const std::vector<Address> accounts{contract, user, empty};
+const std::vector<u256> keys{1, 2, 3};
+
+/** Opens the global snapshot for a test and closes it again even if the test fails */
+struct SnapshotGuard
+{
+    StateSnapshot& snapshot;
+    State& state;
+
+    SnapshotGuard(const fs::path& path, State& _state) : snapshot(StateSnapshot::instance()), state(_state) {
+        snapshot.open(path.string(), state.rootHash());
+    }
+    ~SnapshotGuard() { snapshot.close(state.rootHash()); }
+};
+
+std::string trieAccount(State& state, const h256& root, const Address& a){
+    SecureTrieDB<Address, OverlayDB> trie(&state.db(), root);
+    return trie.at(a);
+}
+
+u256 trieStorage(State& state, const h256& root, const Address& a, const u256& key){
+    std::string account = trieAccount(state, root, a);
+    if (account.empty()) return 0;
+    SecureTrieDB<h256, OverlayDB> trie(&state.db(), RLP(account)[2].toHash<h256>());
+    std::string payload = trie.at(h256(key));
+    return payload.size() ? RLP(payload).toInt<u256>() : 0;
+}
+
+/** Check that reading the state at a root through the snapshot gives the values of the trie */
+void checkState(State& state, const h256& root){
+    for (int pass = 0; pass < 2; pass++) {
+        // A fresh state has no cache, so every read goes through the snapshot
+        State reader(0, state.db(), BaseState::PreExisting);
+        reader.setRoot(root);
+        for (const Address& a : accounts) {
+            std::string account = trieAccount(state, root, a);
+            BOOST_CHECK_EQUAL(reader.addressInUse(a), !account.empty());
+            if (!account.empty()) {
+                BOOST_CHECK(reader.balance(a) == RLP(account)[1].toInt<u256>());
+            }
+            for (const u256& key : keys) {
+                BOOST_CHECK(reader.storage(a, key) == trieStorage(state, root, a, key));
+            }
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(statesnapshot_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(statesnapshot_reads_match_trie){
+    State state(0, OverlayDB(), BaseState::Empty);
+    SnapshotGuard guard(m_args.GetDataDirBase() / "snapshot", state);
+    StateSnapshot& snapshot = guard.snapshot;
+    const h256 root0 = state.rootHash();
+
+    // Accounts with storage, with balance only and without anything
+    state.createContract(contract);
+    state.addBalance(contract, 1);
+    state.setStorage(contract, 1, 10);
+    state.setStorage(contract, 2, 20);
+    state.addBalance(user, 5);
+    state.createContract(empty);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    const h256 root1 = state.rootHash();
+    BOOST_CHECK_EQUAL(snapshot.layers(), 1U);
+    BOOST_CHECK(!trieAccount(state, root1, empty).empty());
+    checkState(state, root1);
+
+    // Repeated reads are served by the snapshot
+    uint64_t misses = snapshot.misses();
+    checkState(state, root1);
+    BOOST_CHECK_EQUAL(snapshot.misses(), misses);
+
+    // Changed and deleted slots, a deleted account and a removed empty account
+    state.setStorage(contract, 1, 11);
+    state.setStorage(contract, 2, 0);
+    state.kill(user);
+    state.addBalance(empty, 0);
+    state.commit(State::CommitBehaviour::RemoveEmptyAccounts);
+    const h256 root2 = state.rootHash();
+    BOOST_CHECK(trieAccount(state, root2, user).empty());
+    BOOST_CHECK(trieAccount(state, root2, empty).empty());
+    checkState(state, root2);
+    checkState(state, root1);
+    checkState(state, root0);
+
+    // Storage wiped before new values are written
+    state.clearStorage(contract);
+    state.setStorage(contract, 3, 30);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    const h256 root3 = state.rootHash();
+    BOOST_CHECK_EQUAL(snapshot.layers(), 3U);
+    checkState(state, root3);
+
+    // Flattened layers are read from the disk layer, roots below it from the trie
+    snapshot.cap(root3, 1);
+    BOOST_CHECK_EQUAL(snapshot.layers(), 1U);
+    checkState(state, root3);
+    checkState(state, root2);
+    misses = snapshot.misses();
+    checkState(state, root1);
+    BOOST_CHECK(snapshot.misses() > misses);
+
+    // Reorg to the parent root and a different child of it
+    state.setRoot(root2);
+    state.setStorage(contract, 1, 12);
+    state.addBalance(user, 7);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    const h256 root3b = state.rootHash();
+    BOOST_CHECK_EQUAL(snapshot.layers(), 2U);
+    checkState(state, root3b);
+    checkState(state, root3);
+    snapshot.cap(root3b);
+    BOOST_CHECK_EQUAL(snapshot.layers(), 1U);
+    checkState(state, root3b);
+    checkState(state, root3);
+
+    // A root the layers do not lead to is read from the trie, the layers are kept
+    state.setRoot(root1);
+    snapshot.cap(root1);
+    BOOST_CHECK_EQUAL(snapshot.layers(), 1U);
+    checkState(state, root1);
+    misses = snapshot.misses();
+    checkState(state, root3b);
+    BOOST_CHECK_EQUAL(snapshot.misses(), misses);
+}
+
+BOOST_AUTO_TEST_CASE(statesnapshot_block_layers){
+    State state(0, OverlayDB(), BaseState::Empty);
+    SnapshotGuard guard(m_args.GetDataDirBase() / "snapshot", state);
+    StateSnapshot& snapshot = guard.snapshot;
+
+    // Block 1 commits every transaction on its own
+    const h256 root0 = state.rootHash();
+    state.createContract(contract);
+    state.setStorage(contract, 1, 10);
+    state.setStorage(contract, 2, 20);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    state.addBalance(user, 5);
+    state.setStorage(contract, 1, 11);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    state.clearStorage(contract);
+    state.setStorage(contract, 3, 30);
+    state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+    const h256 root1 = state.rootHash();
+    BOOST_CHECK_EQUAL(snapshot.layers(), 3U);
+
+    // Connecting it leaves a single layer with the changes of all of them
+    snapshot.connectBlock(root0, root1);
+    BOOST_CHECK_EQUAL(snapshot.layers(), 1U);
+    checkState(state, root1);
+    checkState(state, root0);
+
+    // Blocks are counted by the cap, not commits
+    h256 parent = root1;
+    for (int block = 2; block < 6; block++) {
+        for (int tx = 0; tx < 3; tx++) {
+            state.setStorage(contract, 1 + tx, block * 10 + tx);
+            state.commit(State::CommitBehaviour::KeepEmptyAccounts);
+        }
+        snapshot.connectBlock(parent, state.rootHash(), 3);
+        parent = state.rootHash();
+        BOOST_CHECK_EQUAL(snapshot.layers(), std::min<size_t>(block, 3));
+        checkState(state, parent);
+    }
+    checkState(state, root1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,200 @@
+#include <boost/test/unit_test.hpp>
+#include <revotests/test_utils.h>
+
+namespace StorageResultsTest{
+
+CTransactionRef transaction(uint32_t n){
+    CMutableTransaction tx;
+    tx.nLockTime = n;
+    return MakeTransactionRef(tx);
+}
+
+std::vector<TransactionReceiptInfo> receipts(const CTransactionRef& tx, const uint256& blockHash, uint32_t blockNumber){
+    dev::eth::LogEntry log(dev::Address(0x1234), {dev::h256(0x01), dev::h256(0x02)}, dev::bytes{0xab, 0xcd});
+    TransactionReceiptInfo receipt{
+        blockHash,
+        blockNumber,
+        tx->GetHash(),
+        1,
+        dev::Address(0x10),
+        dev::Address(0x1234),
+        50000,
+        21000,
+        dev::Address(),
+        {log},
+        dev::eth::TransactionException::None,
+        "",
+        0,
+        log.bloom(),
+        dev::h256(0x03),
+        dev::h256(0x04)
+    };
+    return {receipt};
+}
+
+void checkReceipts(const std::vector<TransactionReceiptInfo>& result, const std::vector<TransactionReceiptInfo>& expected){
+    BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+    for(size_t i = 0; i < result.size(); i++){
+        BOOST_CHECK(result[i].blockHash == expected[i].blockHash);
+        BOOST_CHECK_EQUAL(result[i].blockNumber, expected[i].blockNumber);
+        BOOST_CHECK(result[i].transactionHash == expected[i].transactionHash);
+        BOOST_CHECK_EQUAL(result[i].transactionIndex, expected[i].transactionIndex);
+        BOOST_CHECK(result[i].from == expected[i].from);
+        BOOST_CHECK(result[i].to == expected[i].to);
+        BOOST_CHECK_EQUAL(result[i].cumulativeGasUsed, expected[i].cumulativeGasUsed);
+        BOOST_CHECK_EQUAL(result[i].gasUsed, expected[i].gasUsed);
+        BOOST_REQUIRE_EQUAL(result[i].logs.size(), expected[i].logs.size());
+        for(size_t j = 0; j < result[i].logs.size(); j++){
+            BOOST_CHECK(result[i].logs[j].address == expected[i].logs[j].address);
+            BOOST_CHECK(result[i].logs[j].topics == expected[i].logs[j].topics);
+            BOOST_CHECK(result[i].logs[j].data == expected[i].logs[j].data);
+        }
+        BOOST_CHECK(result[i].excepted == expected[i].excepted);
+        BOOST_CHECK_EQUAL(result[i].outputIndex, expected[i].outputIndex);
+        BOOST_CHECK(result[i].bloom == expected[i].bloom);
+        BOOST_CHECK(result[i].stateRoot == expected[i].stateRoot);
+        BOOST_CHECK(result[i].utxoRoot == expected[i].utxoRoot);
+    }
+}
+
+void commit(StorageResults& storage, const CTransactionRef& tx, std::vector<TransactionReceiptInfo> result){
+    storage.addResult(uintToh256(tx->GetHash()), result);
+    storage.commitResults();
+}
+
+BOOST_FIXTURE_TEST_SUITE(storageresults_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(storageresults_write_read){
+    const std::string path = (m_path_root / "receipts").string();
+    CTransactionRef tx = transaction(1);
+    const dev::h256 hashTx = uintToh256(tx->GetHash());
+    std::vector<TransactionReceiptInfo> expected = receipts(tx, uint256S("01"), 10);
+    {
+        StorageResults storage(path);
+
+        // The receipts of the block being connected are read before they are written
+        std::vector<TransactionReceiptInfo> result = expected;
+        storage.addResult(hashTx, result);
+        checkReceipts(storage.getResult(hashTx), expected);
+
+        storage.commitResults();
+        checkReceipts(storage.getResult(hashTx), expected);
+        BOOST_CHECK(storage.getResult(uintToh256(transaction(2)->GetHash())).empty());
+    }
+
+    // The receipts are decoded from the database when it is opened again
+    StorageResults storage(path);
+    BOOST_CHECK(!storage.isReceiptCached(hashTx));
+    checkReceipts(storage.getResult(hashTx), expected);
+    BOOST_CHECK(storage.isReceiptCached(hashTx));
+
+    // Pending receipts that are cleared are not written
+    CTransactionRef txPending = transaction(3);
+    std::vector<TransactionReceiptInfo> pending = receipts(txPending, uint256S("02"), 11);
+    storage.addResult(uintToh256(txPending->GetHash()), pending);
+    storage.clearCacheResult();
+    storage.commitResults();
+    BOOST_CHECK(storage.getResult(uintToh256(txPending->GetHash())).empty());
+}
+
+BOOST_AUTO_TEST_CASE(storageresults_receipt_cache_evicts_least_recently_used){
+    StorageResults storage((m_path_root / "receipts").string(), 1 << 20, 2);
+    CTransactionRef tx1 = transaction(1);
+    CTransactionRef tx2 = transaction(2);
+    CTransactionRef tx3 = transaction(3);
+    std::vector<TransactionReceiptInfo> receipts1 = receipts(tx1, uint256S("01"), 10);
+    std::vector<TransactionReceiptInfo> receipts2 = receipts(tx2, uint256S("02"), 11);
+    std::vector<TransactionReceiptInfo> receipts3 = receipts(tx3, uint256S("03"), 12);
+
+    // Written receipts are cached
+    commit(storage, tx1, receipts1);
+    commit(storage, tx2, receipts2);
+    BOOST_CHECK_EQUAL(storage.receiptCacheSize(), 2U);
+    BOOST_CHECK(storage.isReceiptCached(uintToh256(tx1->GetHash())));
+    BOOST_CHECK(storage.isReceiptCached(uintToh256(tx2->GetHash())));
+
+    // A hit makes tx1 the most recently used, so tx2 is evicted
+    checkReceipts(storage.getResult(uintToh256(tx1->GetHash())), receipts1);
+    commit(storage, tx3, receipts3);
+    BOOST_CHECK_EQUAL(storage.receiptCacheSize(), 2U);
+    BOOST_CHECK(storage.isReceiptCached(uintToh256(tx1->GetHash())));
+    BOOST_CHECK(!storage.isReceiptCached(uintToh256(tx2->GetHash())));
+    BOOST_CHECK(storage.isReceiptCached(uintToh256(tx3->GetHash())));
+
+    // An evicted transaction is read from the database and cached again, evicting tx1
+    checkReceipts(storage.getResult(uintToh256(tx2->GetHash())), receipts2);
+    BOOST_CHECK_EQUAL(storage.receiptCacheSize(), 2U);
+    BOOST_CHECK(!storage.isReceiptCached(uintToh256(tx1->GetHash())));
+    BOOST_CHECK(storage.isReceiptCached(uintToh256(tx2->GetHash())));
+    checkReceipts(storage.getResult(uintToh256(tx1->GetHash())), receipts1);
+}
+
+BOOST_AUTO_TEST_CASE(storageresults_receipt_cache_disabled){
+    StorageResults storage((m_path_root / "receipts").string(), 1 << 20, 0);
+    CTransactionRef tx = transaction(1);
+    std::vector<TransactionReceiptInfo> expected = receipts(tx, uint256S("01"), 10);
+
+    commit(storage, tx, expected);
+    checkReceipts(storage.getResult(uintToh256(tx->GetHash())), expected);
+    BOOST_CHECK_EQUAL(storage.receiptCacheSize(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(storageresults_rewrite_replaces_receipts){
+    const std::string path = (m_path_root / "receipts").string();
+    CTransactionRef tx = transaction(1);
+    const dev::h256 hashTx = uintToh256(tx->GetHash());
+    std::vector<TransactionReceiptInfo> receiptsB = receipts(tx, uint256S("02"), 11);
+    {
+        StorageResults storage(path);
+        commit(storage, tx, receipts(tx, uint256S("01"), 10));
+
+        // Receipts written again replace the ones in the database and in the cache
+        commit(storage, tx, receiptsB);
+        BOOST_CHECK(storage.isReceiptCached(hashTx));
+        checkReceipts(storage.getResult(hashTx), receiptsB);
+    }
+
+    StorageResults storage(path);
+    checkReceipts(storage.getResult(hashTx), receiptsB);
+}
+
+BOOST_AUTO_TEST_CASE(storageresults_receipt_cache_invalidation){
+    StorageResults storage((m_path_root / "receipts").string());
+    CTransactionRef tx1 = transaction(1);
+    CTransactionRef tx2 = transaction(2);
+    std::vector<TransactionReceiptInfo> receipts2 = receipts(tx2, uint256S("02"), 11);
+    commit(storage, tx1, receipts(tx1, uint256S("01"), 10));
+    commit(storage, tx2, receipts2);
+
+    // Disconnecting the block of tx1 drops its receipts from the cache and the database
+    storage.deleteResults({tx1});
+    BOOST_CHECK(!storage.isReceiptCached(uintToh256(tx1->GetHash())));
+    BOOST_CHECK(storage.getResult(uintToh256(tx1->GetHash())).empty());
+    checkReceipts(storage.getResult(uintToh256(tx2->GetHash())), receipts2);
+
+    // Wiping drops all receipts
+    storage.wipeResults();
+    BOOST_CHECK_EQUAL(storage.receiptCacheSize(), 0U);
+    BOOST_CHECK(storage.getResult(uintToh256(tx2->GetHash())).empty());
+}
+
+BOOST_AUTO_TEST_CASE(storageresults_cache_size_options){
+    ArgsManager args;
+    BOOST_CHECK_EQUAL(GetReceiptDBCacheSize(args), size_t(DEFAULT_RECEIPT_DB_CACHE << 20));
+    BOOST_CHECK_EQUAL(GetReceiptCacheSize(args), size_t(DEFAULT_RECEIPT_CACHE));
+
+    args.ForceSetArg("-receiptdbcache", "16");
+    args.ForceSetArg("-receiptcache", "500");
+    BOOST_CHECK_EQUAL(GetReceiptDBCacheSize(args), size_t(16) << 20);
+    BOOST_CHECK_EQUAL(GetReceiptCacheSize(args), 500U);
+
+    // Negative sizes disable the caches
+    args.ForceSetArg("-receiptdbcache", "-1");
+    args.ForceSetArg("-receiptcache", "-1");
+    BOOST_CHECK_EQUAL(GetReceiptDBCacheSize(args), 0U);
+    BOOST_CHECK_EQUAL(GetReceiptCacheSize(args), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -38,6 +38,7 @@
 #include <validationinterface.h>
 #include <walletinitinterface.h>
 #include <util/convert.h>
+#include <revo/contractcall.h>
 
 #include <functional>
 
@@ -195,6 +196,7 @@ ChainTestingSetup::~ChainTestingSetup()
     pblocktree.reset();
 
 /////////////////////////////////////////////// // revo
+    g_contract_caller.Stop();
     delete globalState.release();
     globalSealEngine.reset();
 ///////////////////////////////////////////////
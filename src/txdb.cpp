@@ -15,6 +15,7 @@
 #include <util/vector.h>
 #include <validation.h>
 #include <chainparams.h>
+#include <libdevcore/SHA3.h>
 
 #include <stdint.h>
 
@@ -27,6 +28,17 @@ static constexpr uint8_t DB_BLOCK_INDEX{'b'};
 static constexpr uint8_t DB_HEIGHTINDEX{'h'};
 static constexpr uint8_t DB_STAKEINDEX{'s'};
 static constexpr uint8_t DB_DELEGATEINDEX{'d'};
+static constexpr uint8_t DB_ADDRESSHEIGHTINDEX{'e'};
+static constexpr uint8_t DB_LOGBLOOMINDEX{'m'};
+static constexpr uint8_t DB_LOGBLOOMSECTION{'M'};
+static constexpr uint8_t DB_LOGBLOOMSTART{'L'};
+// Prefixes of the address index before it moved to indexes/addressindex
+static constexpr uint8_t DB_LEGACY_ADDRESSINDEX{'a'};
+static constexpr uint8_t DB_LEGACY_ADDRESSBALANCE{'A'};
+static constexpr uint8_t DB_LEGACY_ADDRESSUNSPENTINDEX{'u'};
+static constexpr uint8_t DB_LEGACY_SPENTINDEX{'p'};
+static constexpr uint8_t DB_LEGACY_TIMESTAMPINDEX{'S'};
+static constexpr uint8_t DB_LEGACY_BLOCKHASHINDEX{'z'};
 //////////////////////////////////////////
 
 static constexpr uint8_t DB_BEST_BLOCK{'B'};
@@ -35,14 +47,6 @@ static constexpr uint8_t DB_FLAG{'F'};
 static constexpr uint8_t DB_REINDEX_FLAG{'R'};
 static constexpr uint8_t DB_LAST_BLOCK{'l'};
 
-////////////////////////////////////////// // revo
-static constexpr uint8_t DB_ADDRESSINDEX{'a'};
-static constexpr uint8_t DB_ADDRESSUNSPENTINDEX{'u'};
-static constexpr uint8_t DB_TIMESTAMPINDEX{'S'};
-static constexpr uint8_t DB_BLOCKHASHINDEX{'z'};
-static constexpr uint8_t DB_SPENTINDEX{'p'};
-//////////////////////////////////////////
-
 namespace {
 
 struct CoinEntry {
@@ -311,47 +315,291 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
 bool CBlockTreeDB::WriteHeightIndex(const CHeightTxIndexKey &heightIndex, const std::vector<uint256>& hash) {
     CDBBatch batch(*this);
     batch.Write(std::make_pair(DB_HEIGHTINDEX, heightIndex), hash);
+    batch.Write(std::make_pair(DB_ADDRESSHEIGHTINDEX, CAddressHeightTxIndexKey(heightIndex.address, heightIndex.height)), hash);
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::WriteLogBloomIndex(unsigned int height, const dev::eth::LogBloom& bloom) {
+    CDBBatch batch(*this);
+    batch.Write(std::make_pair(DB_LOGBLOOMINDEX, CHeightTxIndexIteratorKey(height)), bloom.asBytes());
+
+    // Section blooms are only ever OR-ed into, so they stay a superset of their blocks after a disconnect
+    dev::eth::LogBloom sectionBloom;
+    valtype data;
+    auto sectionKey = std::make_pair(DB_LOGBLOOMSECTION, CHeightTxIndexIteratorKey(height / LOG_BLOOM_SECTION_BLOCKS));
+    if (Read(sectionKey, data)) {
+        sectionBloom = dev::eth::LogBloom(data);
+    }
+    sectionBloom |= bloom;
+    batch.Write(sectionKey, sectionBloom.asBytes());
     return WriteBatch(batch);
 }
 
+/**
+ * Height of the last (height, address) key in [low, high], or 0 if there is none.
+ * This is the height the full range scan of ReadHeightIndex would end on.
+ */
+static int LastHeightIndexHeight(CDBWrapper &db, unsigned int low, unsigned int high) {
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+
+    if (high < std::numeric_limits<unsigned int>::max()) {
+        pcursor->Seek(std::make_pair(DB_HEIGHTINDEX, CHeightTxIndexIteratorKey(high + 1)));
+    } else {
+        pcursor->Seek(uint8_t(DB_HEIGHTINDEX + 1));
+    }
+
+    // Step back to the last key before the end of the range
+    if (pcursor->Valid()) {
+        pcursor->Prev();
+    } else {
+        pcursor->SeekToLast();
+    }
+
+    std::pair<uint8_t, CHeightTxIndexKey> key;
+    if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_HEIGHTINDEX && key.second.height >= low) {
+        return key.second.height;
+    }
+    return 0;
+}
+
+namespace {
+/**
+ * Tests the block and section log blooms against a set of topics, so ranges
+ * that cannot contain any of them are skipped without reading receipts.
+ * Heights below the first bloom-indexed height always pass.
+ */
+class LogBloomFilter
+{
+public:
+    LogBloomFilter(CDBWrapper &_db, unsigned int _start, const std::vector<boost::optional<dev::h256>> &topics, const CDBWrapper::Snapshot* _snapshot = nullptr) :
+        db(_db), start(_start), snapshot(_snapshot)
+    {
+        for (const auto& topic : topics) {
+            if (topic) {
+                dev::eth::LogBloom bloom;
+                bloom.shiftBloom<3>(dev::sha3(topic->ref()));
+                topicBlooms.push_back(bloom);
+            }
+        }
+    }
+
+    bool Enabled() const { return !topicBlooms.empty(); }
+
+    bool MaybeInSection(unsigned int section) const
+    {
+        if (!Enabled() || section * LOG_BLOOM_SECTION_BLOCKS < start) {
+            return true;
+        }
+        return Matches(std::make_pair(DB_LOGBLOOMSECTION, CHeightTxIndexIteratorKey(section)));
+    }
+
+    bool MaybeInBlock(unsigned int height) const
+    {
+        if (!Enabled() || height < start) {
+            return true;
+        }
+        return Matches(std::make_pair(DB_LOGBLOOMINDEX, CHeightTxIndexIteratorKey(height)));
+    }
+
+private:
+    template <typename K>
+    bool Matches(const K& key) const
+    {
+        valtype data;
+        if (!db.Read(key, data, snapshot)) {
+            return true;
+        }
+        dev::eth::LogBloom bloom(data);
+        for (const auto& topicBloom : topicBlooms) {
+            if (bloom.contains(topicBloom)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    CDBWrapper &db;
+    unsigned int start;
+    const CDBWrapper::Snapshot* snapshot;
+    std::vector<dev::eth::LogBloom> topicBlooms;
+};
+} // namespace
+
+bool CBlockTreeDB::ReadHeightIndexBlocks(const CDBWrapper::Snapshot &snapshot, unsigned int low, unsigned int high,
+        std::set<dev::h160> const &addresses, std::vector<boost::optional<dev::h256>> const &topics,
+        const std::function<bool(unsigned int, const std::vector<uint256>&)> &fn) {
+
+    // Runs without cs_main, the index flags are atomics loaded once for the whole read
+    LogBloomFilter filter(*this, nLogBloomStart.load(), topics, &snapshot);
+
+    // One cursor per address on the (address, height) index, or a single one on the (height, address) index
+    std::vector<std::pair<dev::h160, std::unique_ptr<CDBIterator>>> cursors;
+    const bool fByAddress = !addresses.empty() && fAddressHeightIndex.load();
+    if (fByAddress) {
+        for (const dev::h160& address : addresses) {
+            cursors.emplace_back(address, NewIterator(snapshot));
+            cursors.back().second->Seek(std::make_pair(DB_ADDRESSHEIGHTINDEX, CAddressHeightTxIndexKey(address, low)));
+        }
+    } else {
+        cursors.emplace_back(dev::h160(), NewIterator(snapshot));
+        cursors.back().second->Seek(std::make_pair(DB_HEIGHTINDEX, CHeightTxIndexIteratorKey(low)));
+    }
+
+    auto nextKey = [&](const dev::h160& address, CDBIterator& pcursor, CHeightTxIndexKey& key) {
+        for (; pcursor.Valid(); pcursor.Next()) {
+            if (fByAddress) {
+                std::pair<uint8_t, CAddressHeightTxIndexKey> addressKey;
+                if (!pcursor.GetKey(addressKey) || addressKey.first != DB_ADDRESSHEIGHTINDEX || addressKey.second.address != address) {
+                    return false;
+                }
+                key = CHeightTxIndexKey(addressKey.second.height, addressKey.second.address);
+            } else {
+                std::pair<uint8_t, CHeightTxIndexKey> heightKey;
+                if (!pcursor.GetKey(heightKey) || heightKey.first != DB_HEIGHTINDEX) {
+                    return false;
+                }
+                key = heightKey.second;
+                if (!addresses.empty() && !addresses.count(key.address)) {
+                    continue;
+                }
+            }
+            return key.height <= high;
+        }
+        return false;
+    };
+
+    while (true) {
+        // Find the lowest height left on any cursor
+        unsigned int height = std::numeric_limits<unsigned int>::max();
+        bool found = false;
+        for (auto& [address, pcursor] : cursors) {
+            CHeightTxIndexKey key;
+            if (nextKey(address, *pcursor, key)) {
+                height = std::min(height, key.height);
+                found = true;
+            }
+        }
+        if (!found) {
+            return true;
+        }
+
+        // Collect the transactions of that height, keeping their first position
+        std::vector<uint256> hashesTx;
+        std::set<uint256> dupes;
+        const bool fSkip = !filter.MaybeInBlock(height);
+        for (auto& [address, pcursor] : cursors) {
+            CHeightTxIndexKey key;
+            while (nextKey(address, *pcursor, key) && key.height == height) {
+                std::vector<uint256> hashes;
+                if (!fSkip && pcursor->GetValue(hashes)) {
+                    for (const uint256& hash : hashes) {
+                        if (dupes.insert(hash).second) {
+                            hashesTx.push_back(hash);
+                        }
+                    }
+                }
+                pcursor->Next();
+            }
+        }
+
+        if (!hashesTx.empty() && !fn(height, hashesTx)) {
+            return false;
+        }
+        if (height == high) {
+            return true;
+        }
+    }
+}
+
 int CBlockTreeDB::ReadHeightIndex(int low, int high, int minconf,
         std::vector<std::vector<uint256>> &blocksOfHashes,
-        std::set<dev::h160> const &addresses, ChainstateManager &chainman) {
+        std::set<dev::h160> const &addresses,
+        std::vector<boost::optional<dev::h256>> const &topics, ChainstateManager &chainman) {
 
     if ((high < low && high > -1) || (high == 0 && low == 0) || (high < -1 || low < 0)) {
        return -1;
     }
 
+    unsigned int last = high > -1 ? high : std::numeric_limits<unsigned int>::max();
+    if (minconf > 0) {
+        int maxHeight = chainman.ActiveChain().Height() - minconf;
+        if (maxHeight < low) {
+            return 0;
+        }
+        last = std::min(last, (unsigned int)maxHeight);
+    }
+
+    LogBloomFilter filter(*this, nLogBloomStart, topics);
+
+    if (!addresses.empty() && fAddressHeightIndex) {
+        // Walk the (address, height) index of each address, then restore the (height, address) order
+        std::map<std::pair<unsigned int, dev::h160>, std::vector<uint256>> found;
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        for (const dev::h160& address : addresses) {
+            pcursor->Seek(std::make_pair(DB_ADDRESSHEIGHTINDEX, CAddressHeightTxIndexKey(address, low)));
+            for (; pcursor->Valid(); pcursor->Next()) {
+                std::pair<uint8_t, CAddressHeightTxIndexKey> key;
+                if (!pcursor->GetKey(key) || key.first != DB_ADDRESSHEIGHTINDEX || key.second.address != address || key.second.height > last) {
+                    break;
+                }
+                if (!filter.MaybeInBlock(key.second.height)) {
+                    continue;
+                }
+                std::vector<uint256> hashesTx;
+                if (!pcursor->GetValue(hashesTx)) {
+                    break;
+                }
+                found.emplace(std::make_pair(key.second.height, address), std::move(hashesTx));
+            }
+        }
+
+        for (auto& entry : found) {
+            blocksOfHashes.push_back(std::move(entry.second));
+        }
+
+        return LastHeightIndexHeight(*this, low, last);
+    }
+
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
     pcursor->Seek(std::make_pair(DB_HEIGHTINDEX, CHeightTxIndexIteratorKey(low)));
 
     int curheight = 0;
+    unsigned int section = std::numeric_limits<unsigned int>::max();
 
-    for (size_t count = 0; pcursor->Valid(); pcursor->Next()) {
+    while (pcursor->Valid()) {
 
         std::pair<char, CHeightTxIndexKey> key;
         if (!pcursor->GetKey(key) || key.first != DB_HEIGHTINDEX) {
             break;
         }
 
-        int nextHeight = key.second.height;
+        unsigned int nextHeight = key.second.height;
 
-        if (high > -1 && nextHeight > high) {
+        if (nextHeight > last) {
             break;
         }
 
-        if (minconf > 0) {
-            int conf = chainman.ActiveChain().Height() - nextHeight;
-            if (conf < minconf) {
-                break;
+        curheight = nextHeight;
+
+        // Jump over whole sections, then single blocks, whose logs cannot match the topics
+        if (filter.Enabled()) {
+            if (nextHeight / LOG_BLOOM_SECTION_BLOCKS != section) {
+                section = nextHeight / LOG_BLOOM_SECTION_BLOCKS;
+                if (!filter.MaybeInSection(section)) {
+                    pcursor->Seek(std::make_pair(DB_HEIGHTINDEX, CHeightTxIndexIteratorKey((section + 1) * LOG_BLOOM_SECTION_BLOCKS)));
+                    continue;
+                }
+            }
+            if (!filter.MaybeInBlock(nextHeight)) {
+                pcursor->Next();
+                continue;
             }
         }
 
-        curheight = nextHeight;
-
         auto address = key.second.address;
         if (!addresses.empty() && addresses.find(address) == addresses.end()) {
+            pcursor->Next();
             continue;
         }
 
@@ -361,12 +609,12 @@ int CBlockTreeDB::ReadHeightIndex(int low, int high, int minconf,
             break;
         }
 
-        count += hashesTx.size();
-
         blocksOfHashes.push_back(hashesTx);
+        pcursor->Next();
     }
 
-    return curheight;
+    // Skipped sections may hide the last indexed height of the range
+    return filter.Enabled() ? LastHeightIndexHeight(*this, low, last) : curheight;
 }
 
 bool CBlockTreeDB::EraseHeightIndex(const unsigned int &height) {
@@ -380,12 +628,15 @@ bool CBlockTreeDB::EraseHeightIndex(const unsigned int &height) {
         std::pair<char, CHeightTxIndexKey> key;
         if (pcursor->GetKey(key) && key.first == DB_HEIGHTINDEX && key.second.height == height) {
             batch.Erase(key);
+            batch.Erase(std::make_pair(DB_ADDRESSHEIGHTINDEX, CAddressHeightTxIndexKey(key.second.address, height)));
             pcursor->Next();
         } else {
             break;
         }
     }
 
+    batch.Erase(std::make_pair(DB_LOGBLOOMINDEX, CHeightTxIndexIteratorKey(height)));
+
     return WriteBatch(batch);
 }
 
@@ -406,9 +657,101 @@ bool CBlockTreeDB::WipeHeightIndex() {
         }
     }
 
+    pcursor->Seek(DB_ADDRESSHEIGHTINDEX);
+
+    while (pcursor->Valid()) {
+        std::pair<char, CAddressHeightTxIndexKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSHEIGHTINDEX) {
+            batch.Erase(key);
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+
+    for (uint8_t prefix : {DB_LOGBLOOMINDEX, DB_LOGBLOOMSECTION}) {
+        pcursor->Seek(prefix);
+
+        while (pcursor->Valid()) {
+            std::pair<char, CHeightTxIndexIteratorKey> key;
+            if (pcursor->GetKey(key) && key.first == prefix) {
+                batch.Erase(key);
+                pcursor->Next();
+            } else {
+                break;
+            }
+        }
+    }
+    batch.Erase(DB_LOGBLOOMSTART);
+    nLogBloomStart = 0;
+
     return WriteBatch(batch);
 }
 
+bool CBlockTreeDB::UpgradeLogBloomIndex() {
+    unsigned int start = 0;
+    if (Read(DB_LOGBLOOMSTART, start)) {
+        nLogBloomStart = start;
+        return true;
+    }
+
+    // Blocks connected before the bloom index existed have no blooms and are never skipped
+    unsigned int last = LastHeightIndexHeight(*this, 0, std::numeric_limits<unsigned int>::max());
+    start = last > 0 ? last + 1 : 0;
+    LogPrintf("Log events bloom index starts at height %u\n", start);
+    if (!Write(DB_LOGBLOOMSTART, start)) {
+        return false;
+    }
+    nLogBloomStart = start;
+    return true;
+}
+
+bool CBlockTreeDB::UpgradeAddressHeightIndex() {
+    bool fHaveIndex = false;
+    if (ReadFlag("addressheightindex", fHaveIndex) && fHaveIndex) {
+        fAddressHeightIndex = true;
+        return true;
+    }
+
+    LogPrintf("Building the address log events index...\n");
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    CDBBatch batch(*this);
+    size_t count = 0;
+
+    pcursor->Seek(DB_HEIGHTINDEX);
+
+    for (; pcursor->Valid(); pcursor->Next()) {
+        if (ShutdownRequested()) {
+            // Flag stays unset, so the build restarts on the next start
+            return WriteBatch(batch);
+        }
+        std::pair<char, CHeightTxIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_HEIGHTINDEX) {
+            break;
+        }
+        std::vector<uint256> hashesTx;
+        if (!pcursor->GetValue(hashesTx)) {
+            return error("%s: failed to read height index value", __func__);
+        }
+        batch.Write(std::make_pair(DB_ADDRESSHEIGHTINDEX, CAddressHeightTxIndexKey(key.second.address, key.second.height)), hashesTx);
+        count++;
+        if (batch.SizeEstimate() > (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize)) {
+            if (!WriteBatch(batch)) {
+                return false;
+            }
+            batch.Clear();
+        }
+    }
+
+    if (!WriteBatch(batch) || !WriteFlag("addressheightindex", true)) {
+        return false;
+    }
+    fAddressHeightIndex = true;
+    LogPrintf("Built the address log events index with %u entries\n", count);
+    return true;
+}
+
 
 bool CBlockTreeDB::WriteStakeIndex(unsigned int height, uint160 address) {
     CDBBatch batch(*this);
@@ -521,161 +864,50 @@ bool CBlockTreeDB::EraseDelegateIndex(unsigned int height) {
     return WriteBatch(batch);
 }
 
-bool CBlockTreeDB::WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
-    CDBBatch batch(*this);
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
-        batch.Write(std::make_pair(DB_ADDRESSINDEX, it->first), it->second);
-    return WriteBatch(batch);
-}
-
-bool CBlockTreeDB::EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
-    CDBBatch batch(*this);
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
-        batch.Erase(std::make_pair(DB_ADDRESSINDEX, it->first));
-    return WriteBatch(batch);
-}
-
-bool CBlockTreeDB::ReadAddressIndex(uint256 addressHash, int type,
-                                    std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
-                                    int start, int end) {
-
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-
-    if (start > 0 && end > 0) {
-        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, start)));
-    } else {
-        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey(type, addressHash)));
-    }
+/** Erase the entries with a prefix and keys of type K, writing the batch when it grows large */
+template <typename K>
+static bool EraseLegacyEntries(CDBWrapper& db, CDBIterator& cursor, CDBBatch& batch, uint8_t prefix)
+{
+    cursor.Seek(prefix);
 
-    while (pcursor->Valid()) {
-        std::pair<char,CAddressIndexKey> key;
-        if (pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX && key.second.hashBytes == addressHash) {
-            if (end > 0 && key.second.blockHeight > end) {
-                break;
-            }
-            CAmount nValue;
-            if (pcursor->GetValue(nValue)) {
-                addressIndex.push_back(std::make_pair(key.second, nValue));
-                pcursor->Next();
-            } else {
-                return error("failed to get address index value");
-            }
-        } else {
+    while (cursor.Valid()) {
+        std::pair<uint8_t, K> key;
+        if (!cursor.GetKey(key) || key.first != prefix) {
             break;
         }
-    }
-
-    return true;
-}
-
-bool CBlockTreeDB::UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect) {
-    CDBBatch batch(*this);
-    for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
-        if (it->second.IsNull()) {
-            batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, it->first));
-        } else {
-            batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, it->first), it->second);
-        }
-    }
-    return WriteBatch(batch);
-}
-
-bool CBlockTreeDB::ReadAddressUnspentIndex(uint256 addressHash, int type,
-                                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs) {
-
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorKey(type, addressHash)));
-
-    while (pcursor->Valid()) {
-        std::pair<char,CAddressUnspentKey> key;
-        if (pcursor->GetKey(key) && key.first == DB_ADDRESSUNSPENTINDEX && key.second.hashBytes == addressHash) {
-            CAddressUnspentValue nValue;
-            if (pcursor->GetValue(nValue)) {
-                unspentOutputs.push_back(std::make_pair(key.second, nValue));
-                pcursor->Next();
-            } else {
-                return error("failed to get address unspent value");
+        batch.Erase(key);
+        if (batch.SizeEstimate() > (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize)) {
+            if (!db.WriteBatch(batch)) {
+                return false;
             }
-        } else {
-            break;
+            batch.Clear();
         }
+        cursor.Next();
     }
-
     return true;
 }
 
-bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
-    CDBBatch batch(*this);
-    batch.Write(std::make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
-    return WriteBatch(batch);
-}
-
-bool CBlockTreeDB::ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes, ChainstateManager &chainman) {
-
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-
-    pcursor->Seek(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexIteratorKey(low)));
-
-    while (pcursor->Valid()) {
-        std::pair<char, CTimestampIndexKey> key;
-        if (pcursor->GetKey(key) && key.first == DB_TIMESTAMPINDEX && key.second.timestamp < high) {
-            if (fActiveOnly) {
-                if (blockOnchainActive(key.second.blockHash, chainman)) {
-                    hashes.push_back(std::make_pair(key.second.blockHash, key.second.timestamp));
-                }
-            } else {
-                hashes.push_back(std::make_pair(key.second.blockHash, key.second.timestamp));
-            }
-
-            pcursor->Next();
-        } else {
-            break;
-        }
+bool CBlockTreeDB::WipeAddressIndex() {
+    bool fHaveIndex = false;
+    if (!ReadFlag("addrindex", fHaveIndex) || !fHaveIndex) {
+        return true;
     }
 
-    return true;
-}
-
-bool CBlockTreeDB::WriteTimestampBlockIndex(const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts) {
-    CDBBatch batch(*this);
-    batch.Write(std::make_pair(DB_BLOCKHASHINDEX, blockhashIndex), logicalts);
-    return WriteBatch(batch);
-}
+    LogPrintf("Removing the address index from the block index database...\n");
 
-bool CBlockTreeDB::ReadTimestampBlockIndex(const uint256 &hash, unsigned int &ltimestamp) {
-
-    CTimestampBlockIndexValue lts;
-    if (!Read(std::make_pair(DB_BLOCKHASHINDEX, hash), lts))
-       return false;
-
-    ltimestamp = lts.ltimestamp;
-    return true;
-}
-
-bool CBlockTreeDB::ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value) {
-    return Read(std::make_pair(DB_SPENTINDEX, key), value);
-}
-
-bool CBlockTreeDB::UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect) {
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
     CDBBatch batch(*this);
-    for (std::vector<std::pair<CSpentIndexKey,CSpentIndexValue> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
-        if (it->second.IsNull()) {
-            batch.Erase(std::make_pair(DB_SPENTINDEX, it->first));
-        } else {
-            batch.Write(std::make_pair(DB_SPENTINDEX, it->first), it->second);
-        }
-    }
-    return WriteBatch(batch);
-}
 
-bool CBlockTreeDB::blockOnchainActive(const uint256 &hash, ChainstateManager &chainman) {
-    LOCK(cs_main);
-    BlockMap::iterator mi = chainman.BlockIndex().find(hash);
-    if (mi == chainman.BlockIndex().end())
+    if (!EraseLegacyEntries<CAddressIndexKey>(*this, *pcursor, batch, DB_LEGACY_ADDRESSINDEX) ||
+        !EraseLegacyEntries<CAddressIndexIteratorKey>(*this, *pcursor, batch, DB_LEGACY_ADDRESSBALANCE) ||
+        !EraseLegacyEntries<CAddressUnspentKey>(*this, *pcursor, batch, DB_LEGACY_ADDRESSUNSPENTINDEX) ||
+        !EraseLegacyEntries<CSpentIndexKey>(*this, *pcursor, batch, DB_LEGACY_SPENTINDEX) ||
+        !EraseLegacyEntries<CTimestampIndexKey>(*this, *pcursor, batch, DB_LEGACY_TIMESTAMPINDEX) ||
+        !EraseLegacyEntries<CTimestampBlockIndexKey>(*this, *pcursor, batch, DB_LEGACY_BLOCKHASHINDEX)) {
         return false;
+    }
 
-    CBlockIndex* pblockindex = (*mi).second;
-    return pblockindex && chainman.ActiveChain().Contains(pblockindex);
+    return WriteBatch(batch) && WriteFlag("addrindex", false);
 }
 ///////////////////////////////////////////////////////
 
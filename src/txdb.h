@@ -12,8 +12,12 @@
 #include <primitives/block.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
+#include <libethcore/Common.h>
 #include <index/disktxpos.h>
 
+#include <boost/optional.hpp>
+
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,10 +29,12 @@ class uint256;
 class ChainstateManager;
 struct CHeightTxIndexKey;
 struct CHeightTxIndexIteratorKey;
+struct CAddressHeightTxIndexKey;
 //////////////////////////////////// //revo
 struct CAddressIndexKey;
 struct CAddressUnspentKey;
 struct CAddressUnspentValue;
+struct CAddressBalanceValue;
 struct CMempoolAddressDeltaKey;
 struct CTimestampIndexKey;
 struct CTimestampBlockIndexKey;
@@ -59,6 +65,8 @@ static const int64_t nMaxTxIndexCache = 1024;
 static const int64_t max_filter_index_cache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! Number of blocks whose log blooms are aggregated into one section bloom
+static constexpr unsigned int LOG_BLOOM_SECTION_BLOCKS = 4096;
 
 // Actually declared in validation.cpp; can't include because of circular dependency.
 extern RecursiveMutex cs_main;
@@ -117,14 +125,36 @@ public:
      * @param minconf stop iterating of the block height does not have enough confirmations (ignored if <= 0)
      * @param blocksOfHashes transaction hashes in blocks iterated are collected into this vector.
      * @param addresses filter out a block unless it matches one of the addresses in this set.
+     *                  When not empty, the (address, height) index is walked per address instead
+     *                  of scanning every (height, address) key in the range.
+     * @param topics skip blocks whose log bloom contains none of the non-null topics (ignored if empty).
      *
      * @return the height of the latest block iterated. 0 if no block is iterated.
      */
     int ReadHeightIndex(int low, int high, int minconf,
             std::vector<std::vector<uint256>> &blocksOfHashes,
-            std::set<dev::h160> const &addresses, ChainstateManager &chainman);
+            std::set<dev::h160> const &addresses,
+            std::vector<boost::optional<dev::h256>> const &topics, ChainstateManager &chainman);
+    /**
+     * Iterates through the blocks of the height index in [low, high] from a snapshot of the database,
+     * without needing cs_main. Takes the same address and topic filters as ReadHeightIndex.
+     *
+     * @param fn called with the height and the distinct transaction hashes of each matching block,
+     *           in increasing height order. Returns false to stop the iteration.
+     *
+     * @return false if fn stopped the iteration.
+     */
+    bool ReadHeightIndexBlocks(const CDBWrapper::Snapshot &snapshot, unsigned int low, unsigned int high,
+            std::set<dev::h160> const &addresses, std::vector<boost::optional<dev::h256>> const &topics,
+            const std::function<bool(unsigned int, const std::vector<uint256>&)> &fn);
     bool EraseHeightIndex(const unsigned int &height);
     bool WipeHeightIndex();
+    /** Build the (address, height) index from the (height, address) index if it is missing. */
+    bool UpgradeAddressHeightIndex();
+    /** Store the bloom of all logs in a block, and merge it into the bloom of its section. */
+    bool WriteLogBloomIndex(unsigned int height, const dev::eth::LogBloom& bloom);
+    /** Load the first height covered by the log bloom index, starting the index if it is missing. */
+    bool UpgradeLogBloomIndex();
 
 
     bool WriteStakeIndex(unsigned int height, uint160 address);
@@ -138,23 +168,16 @@ public:
 
     bool EraseBlockIndex(const std::vector<uint256>&vect);
 
-    // Block explorer database functions
-    bool WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect);
-    bool EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect);
-    bool ReadAddressIndex(uint256 addressHash, int type,
-                        std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
-                        int start = 0, int end = 0);
-    bool UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect);
-    bool ReadAddressUnspentIndex(uint256 addressHash, int type,
-                                std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &vect);
-    bool WriteTimestampIndex(const CTimestampIndexKey &timestampIndex);
-    bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &vect, ChainstateManager & chainman);
-    bool WriteTimestampBlockIndex(const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts);
-    bool ReadTimestampBlockIndex(const uint256 &hash, unsigned int &logicalTS);
-    bool ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
-    bool UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect);
-    bool blockOnchainActive(const uint256 &hash, ChainstateManager &chainman);
+    /** Remove the address index entries written by older versions, the address index has its own database now. */
+    bool WipeAddressIndex();
+
 
+private:
+    //! Whether the (address, height) log events index is complete and can be used for reads.
+    //! Atomic, as ReadHeightIndexBlocks reads it without cs_main.
+    std::atomic<bool> fAddressHeightIndex{false};
+    //! First height whose log bloom is indexed; lower heights are never skipped
+    std::atomic<unsigned int> nLogBloomStart{0};
     //////////////////////////////////////////////////////////////////////////////
 };
 
@@ -222,6 +245,41 @@ struct CHeightTxIndexKey {
     }
 };
 
+struct CAddressHeightTxIndexKey {
+    dev::h160 address;
+    unsigned int height;
+
+    size_t GetSerializeSize(int nType, int nVersion) const {
+        return 25;
+    }
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        s << address.asBytes();
+        ser_writedata32be(s, height);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        valtype tmp;
+        s >> tmp;
+        address = dev::h160(tmp);
+        height = ser_readdata32be(s);
+    }
+
+    CAddressHeightTxIndexKey(dev::h160 _address, unsigned int _height) {
+        address = _address;
+        height = _height;
+    }
+
+    CAddressHeightTxIndexKey() {
+        SetNull();
+    }
+
+    void SetNull() {
+        address.clear();
+        height = 0;
+    }
+};
+
 struct CTimestampIndexIteratorKey {
     unsigned int timestamp;
 
@@ -416,6 +474,26 @@ struct CAddressUnspentValue {
     }
 };
 
+struct CAddressBalanceValue {
+    CAmount balance;
+    CAmount received;
+
+    SERIALIZE_METHODS(CAddressBalanceValue, obj) { READWRITE(obj.balance, obj.received); }
+
+    CAddressBalanceValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+    }
+
+    bool IsNull() const {
+        return balance == 0 && received == 0;
+    }
+};
+
 struct CAddressIndexKey {
     unsigned int type;
     uint256 hashBytes;
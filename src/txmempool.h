@@ -183,6 +183,7 @@ private:
     int64_t feeDelta;          //!< Used for determining the priority of the transaction for mining in a block
     LockPoints lockPoints;     //!< Track the height and time at which tx was final
     CAmount nMinGasPrice;      //!< The minimum gas price among the contract outputs of the tx
+    uint64_t nGasLimit;        //!< The sum of the gas limits of the contract outputs of the tx
 
     // Information about descendants of this transaction that are in the
     // mempool; if we remove this transaction we must remove all of these
@@ -201,7 +202,7 @@ public:
     CTxMemPoolEntry(const CTransactionRef& _tx, const CAmount& _nFee,
                     int64_t _nTime, unsigned int _entryHeight,
                     bool spendsCoinbase,
-                    int64_t nSigOpsCost, LockPoints lp, CAmount _nMinGasPrice = 0);
+                    int64_t nSigOpsCost, LockPoints lp, CAmount _nMinGasPrice = 0, uint64_t _nGasLimit = 0);
 
     const CTransaction& GetTx() const { return *this->tx; }
     CTransactionRef GetSharedTx() const { return this->tx; }
@@ -215,6 +216,7 @@ public:
     size_t DynamicMemoryUsage() const { return nUsageSize; }
     const LockPoints& GetLockPoints() const { return lockPoints; }
     const CAmount& GetMinGasPrice() const { return nMinGasPrice; }
+    uint64_t GetGasLimit() const { return nGasLimit; }
 
     // Adjusts the descendant state.
     void UpdateDescendantState(int64_t modifySize, CAmount modifyFee, int64_t modifyCount);
@@ -18,6 +18,7 @@
 #include <deploymentstatus.h>
 #include <flatfile.h>
 #include <hash.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
 #include <logging.h>
@@ -148,6 +149,7 @@ uint256 g_best_block;
 bool g_parallel_script_checks{false};
 bool fAddressIndex = false; // revo
 bool fLogEvents = false;
+size_t nStateBatchSize = 0;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
@@ -202,6 +204,8 @@ CBlockIndex* BlockManager::FindForkInGlobalIndex(const CChain& chain, const CBlo
 std::unique_ptr<CBlockTreeDB> pblocktree;
 std::unique_ptr<StorageResults> pstorageresult;
 
+std::unique_ptr<StateJournal> pstatejournal;
+
 bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
                        bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
@@ -750,6 +754,7 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     int64_t nSigOpsCost = GetTransactionSigOpCost(tx, m_view, STANDARD_SCRIPT_VERIFY_FLAGS);
 
     dev::u256 txMinGasPrice = 0;
+    uint64_t txGasLimit = 0;
 
     //////////////////////////////////////////////////////////// // revo
     if(!CheckOpSender(tx, chainparams, m_active_chainstate.m_blockman.GetSpendHeight(m_view))){
@@ -829,6 +834,8 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
 
         if(count > revoTransactions.size())
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-incorrect-format");
+
+        txGasLimit = (uint64_t)gasAllTxs;
     }
     ////////////////////////////////////////////////////////////
 
@@ -849,7 +856,7 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     }
 
     entry.reset(new CTxMemPoolEntry(ptx, ws.m_base_fees, nAcceptTime, m_active_chainstate.m_chain.Height(),
-            fSpendsCoinbase, nSigOpsCost, lp, CAmount(txMinGasPrice)));
+            fSpendsCoinbase, nSigOpsCost, lp, CAmount(txMinGasPrice), txGasLimit));
     unsigned int nSize = entry->GetTxSize();
 
     if (nSigOpsCost > dgpMaxTxSigOps)
@@ -1880,11 +1887,6 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         return DISCONNECT_FAILED;
     }
 
-    /////////////////////////////////////////////////////////// // revo
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
-    ///////////////////////////////////////////////////////////
-
     // undo transactions in reverse order
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction &tx = *(block.vtx[i]);
@@ -1905,29 +1907,6 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
             }
         }
 
-        /////////////////////////////////////////////////////////// // revo
-        if (pfClean == NULL && fAddressIndex) {
-
-            for (unsigned int k = tx.vout.size(); k-- > 0;) {
-                const CTxOut &out = tx.vout[k];
-
-                CTxDestination dest;
-                if (ExtractDestination({hash, k}, out.scriptPubKey, dest)) {
-                    valtype bytesID(std::visit(DataVisitor(), dest));
-                    if(bytesID.empty()) {
-                        continue;
-                    }
-                    valtype addressBytes(32);
-                    std::copy(bytesID.begin(), bytesID.end(), addressBytes.begin());
-                    // undo receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(dest.index(), uint256(addressBytes), pindex->nHeight, i, hash, k, false), out.nValue));
-                    // undo unspent index
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(dest.index(), uint256(addressBytes), hash, k), CAddressUnspentValue()));
-                }
-            }
-        }
-        ///////////////////////////////////////////////////////////
-
         // restore inputs
         if (i > 0) { // not coinbases
             CTxUndo &txundo = blockUndo.vtxundo[i-1];
@@ -1940,27 +1919,6 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
                 int res = ApplyTxInUndo(std::move(txundo.vprevout[j]), view, out);
                 if (res == DISCONNECT_FAILED) return DISCONNECT_FAILED;
                 fClean = fClean && res != DISCONNECT_UNCLEAN;
-
-                if (pfClean == NULL && fAddressIndex) {
-                    const auto &undo = txundo.vprevout[j];
-                    const bool isTxCoinStake = tx.IsCoinStake();
-                    const CTxIn input = tx.vin[j];
-                    const CTxOut &prevout = view.GetOutputFor(input);
-
-                    CTxDestination dest;
-                    if (ExtractDestination(input.prevout, prevout.scriptPubKey, dest)) {
-                        valtype bytesID(std::visit(DataVisitor(), dest));
-                        if(bytesID.empty()) {
-                            continue;
-                        }
-                        valtype addressBytes(32);
-                        std::copy(bytesID.begin(), bytesID.end(), addressBytes.begin());
-                        // undo spending activity
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(dest.index(), uint256(addressBytes), pindex->nHeight, i, hash, j, true), prevout.nValue * -1));
-                        // restore unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(dest.index(), uint256(addressBytes), input.prevout.hash, input.prevout.n), CAddressUnspentValue(prevout.nValue, prevout.scriptPubKey, undo.nHeight, isTxCoinStake)));
-                    }
-                }
             }
             // At this point, all of txundo.vprevout should have been moved out.
         }
@@ -1986,19 +1944,6 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
             pblocktree->EraseDelegateIndex(pindex->nHeight);
     }
 
-    //////////////////////////////////////////////////// // revo
-    if (pfClean == NULL && fAddressIndex) {
-        if (!pblocktree->EraseAddressIndex(addressIndex)) {
-            error("Failed to delete address index");
-            return DISCONNECT_FAILED;
-        }
-        if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-            error("Failed to write address unspent index");
-            return DISCONNECT_FAILED;
-        }
-    }
-    ////////////////////////////////////////////////////
-
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
@@ -2539,6 +2484,14 @@ void LastHashes::clear()
     m_lastHashes.clear();
 }
 
+void FlushContractState()
+{
+    if (globalState) {
+        globalState->db().commit();
+        globalState->dbUtxo().commit();
+    }
+}
+
 bool ByteCodeExec::performByteCode(dev::eth::Permanence type){
     for(RevoTransaction& tx : txs){
         //validate VM version
@@ -2546,6 +2499,7 @@ bool ByteCodeExec::performByteCode(dev::eth::Permanence type){
             return false;
         }
         dev::eth::EnvInfo envInfo(BuildEVMEnvironment());
+        envInfo.setContextReadFlag(&contextRead);
         if(!tx.isCreation() && !globalState->addressInUse(tx.receiveAddress())){
             dev::eth::ExecutionResult execRes;
             execRes.excepted = dev::eth::TransactionException::Unknown;
@@ -2554,8 +2508,12 @@ bool ByteCodeExec::performByteCode(dev::eth::Permanence type){
         }
         result.push_back(globalState->execute(envInfo, *globalSealEngine.get(), tx, chain, type, OnOpFunc()));
     }
-    globalState->db().commit();
-    globalState->dbUtxo().commit();
+    // The trie nodes are written once per block by ConnectBlock, or FlushStateToDisk during IBD.
+    // Reverted executions write none, their overlay is left to the committed ones.
+    if(type == dev::eth::Permanence::Committed){
+        globalState->db().checkpoint();
+        globalState->dbUtxo().checkpoint();
+    }
     globalSealEngine.get()->deleteAddresses.clear();
     return true;
 }
@@ -3034,10 +2992,8 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
 
     ///////////////////////////////////////////////////////// // revo
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
-    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
     std::map<dev::Address, std::pair<CHeightTxIndexKey, std::vector<uint256>>> heightIndexes;
+    dev::eth::LogBloom blockLogBloom;
     /////////////////////////////////////////////////////////
 
     uint64_t blockGasUsed = 0;
@@ -3090,30 +3046,6 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
                 return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-txns-nonfinal");
             }
 
-            ////////////////////////////////////////////////////////////////// // revo
-            if (fAddressIndex)
-            {
-                for (size_t j = 0; j < tx.vin.size(); j++) {
-                    const CTxIn input = tx.vin[j];
-                    const CTxOut &prevout = view.GetOutputFor(tx.vin[j]);
-
-                    CTxDestination dest;
-                    if (ExtractDestination(input.prevout, prevout.scriptPubKey, dest)) {
-                        valtype bytesID(std::visit(DataVisitor(), dest));
-                        if(bytesID.empty()) {
-                            continue;
-                        }
-                        valtype addressBytes(32);
-                        std::copy(bytesID.begin(), bytesID.end(), addressBytes.begin());
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(dest.index(), uint256(addressBytes), pindex->nHeight, i, tx.GetHash(), j, true), prevout.nValue * -1));
-
-                        // remove address from unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(dest.index(), uint256(addressBytes), input.prevout.hash, input.prevout.n), CAddressUnspentValue()));
-                        spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(tx.GetHash(), j, pindex->nHeight, prevout.nValue, dest.index(), uint256(addressBytes))));
-                    }
-                }
-            }
-            //////////////////////////////////////////////////////////////////
         }
 
         // GetTransactionSigOpCost counts 3 types of sigops:
@@ -3268,6 +3200,7 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
                         }
                         heightIndexes[log.address].second.push_back(tx.GetHash());
                     }
+                    blockLogBloom |= resultExec[k].txRec.bloom();
                     uint64_t gasUsed = uint64_t(resultExec[k].execRes.gasUsed);
                     countCumulativeGasUsed += gasUsed;
                     tri.push_back(TransactionReceiptInfo{
@@ -3315,29 +3248,6 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
         }
 /////////////////////////////////////////////////////////////////////////////////////////
 
-        /////////////////////////////////////////////////////////////////////////////////// // revo
-        if (fAddressIndex) {
-
-            for (unsigned int k = 0; k < tx.vout.size(); k++) {
-                const CTxOut &out = tx.vout[k];
-                const bool isTxCoinStake = tx.IsCoinStake();
-
-                CTxDestination dest;
-                if (ExtractDestination({tx.GetHash(), k}, out.scriptPubKey, dest)) {
-                    valtype bytesID(std::visit(DataVisitor(), dest));
-                    if(bytesID.empty()) {
-                        continue;
-                    }
-                    valtype addressBytes(32);
-                    std::copy(bytesID.begin(), bytesID.end(), addressBytes.begin());
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(dest.index(), uint256(addressBytes), pindex->nHeight, i, tx.GetHash(), k, false), out.nValue));
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(dest.index(), uint256(addressBytes), tx.GetHash(), k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight, isTxCoinStake)));
-                }
-            }
-        }
-        ///////////////////////////////////////////////////////////////////////////////////
 
         CTxUndo undoDummy;
         if (i > 0) {
@@ -3461,6 +3371,8 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
             if (!pblocktree->WriteHeightIndex(e.second.first, e.second.second))
                 return AbortNode(state, "Failed to write height index");
         }
+        if (!heightIndexes.empty() && !pblocktree->WriteLogBloomIndex(pindex->nHeight, blockLogBloom))
+            return AbortNode(state, "Failed to write log bloom index");
     }
 
     // The stake and delegate index is needed for MPoS, update it while MPoS is active
@@ -3491,38 +3403,6 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
 
     assert(pindex->phashBlock);
-    ///////////////////////////////////////////////////////////// // revo
-    if (fAddressIndex) {
-        if (!pblocktree->WriteAddressIndex(addressIndex)) {
-            return AbortNode(state, "Failed to write address index");
-        }
-        if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-            return AbortNode(state, "Failed to write address unspent index");
-        }
-
-        if (!pblocktree->UpdateSpentIndex(spentIndex))
-            return AbortNode(state, "Failed to write transaction index");
-
-        unsigned int logicalTS = pindex->nTime;
-        unsigned int prevLogicalTS = 0;
-
-        // retrieve logical timestamp of the previous block
-        if (pindex->pprev)
-            if (!pblocktree->ReadTimestampBlockIndex(pindex->pprev->GetBlockHash(), prevLogicalTS))
-                LogPrintf("%s: Failed to read previous block's logical timestamp\n", __func__);
-
-        if (logicalTS <= prevLogicalTS) {
-            logicalTS = prevLogicalTS + 1;
-            LogPrint(BCLog::INDEX, "%s: Previous logical timestamp is newer Actual[%d] prevLogical[%d] Logical[%d]\n", __func__, pindex->nTime, prevLogicalTS, logicalTS);
-        }
-
-        if (!pblocktree->WriteTimestampIndex(CTimestampIndexKey(logicalTS, pindex->GetBlockHash())))
-            return AbortNode(state, "Failed to write timestamp index");
-
-        if (!pblocktree->WriteTimestampBlockIndex(CTimestampBlockIndexKey(pindex->GetBlockHash()), CTimestampBlockIndexValue(logicalTS)))
-            return AbortNode(state, "Failed to write blockhash index");
-    }
-    /////////////////////////////////////////////////////////////
 
     // add this block to the view's block chain
     view.SetBestBlock(pindex->GetBlockHash());
@@ -3533,6 +3413,24 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
     int64_t nTime6 = GetTimeMicros(); nTimeCallbacks += nTime6 - nTime5;
     LogPrint(BCLog::BENCH, "    - Callbacks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime6 - nTime5), nTimeCallbacks * MICRO, nTimeCallbacks * MILLI / nBlocksTotal);
 
+    // Keep the contract state of several blocks in memory during initial block download,
+    // the state of the chainstate tip is written by FlushStateToDisk before the coins
+    if (nStateBatchSize == 0 || !IsInitialBlockDownload() ||
+        globalState->db().pendingMemoryUsage() + globalState->dbUtxo().pendingMemoryUsage() > nStateBatchSize) {
+        FlushContractState();
+    }
+
+    if (pstatejournal && !pstatejournal->WriteBlock(pindex->nHeight, pindex->GetBlockHash()))
+        return AbortNode(state, "Failed to write state journal");
+
+    // Keep one snapshot layer for each of the recent blocks only
+    if (dev::eth::StateSnapshot::instance().isOpen()) {
+        dev::h256 prevHashStateRoot(dev::sha3(dev::rlp("")));
+        if (pindex->pprev->hashStateRoot != uint256())
+            prevHashStateRoot = uintToh256(pindex->pprev->hashStateRoot);
+        dev::eth::StateSnapshot::instance().connectBlock(prevHashStateRoot, globalState->rootHash());
+    }
+
     if (fLogEvents)
         pstorageresult->commitResults();
 
@@ -3598,6 +3496,10 @@ bool CChainState::FlushStateToDisk(
             ForEachBlockFilterIndex([&](BlockFilterIndex& index) {
                last_prune = std::max(1, std::min(last_prune, index.GetSummary().best_block_height));
             });
+            // nor above the address index bestblock, it reads the undo data of the blocks it indexes
+            if (g_address_index) {
+                last_prune = std::max(1, std::min(last_prune, g_address_index->GetSummary().best_block_height));
+            }
 
             if (nManualPruneHeight > 0) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("find files to prune (manual)", BCLog::BENCH);
@@ -3689,6 +3591,8 @@ bool CChainState::FlushStateToDisk(
             if (!CheckDiskSpace(gArgs.GetDataDirNet(), 48 * 2 * 2 * CoinsTip().GetCacheSize())) {
                 return AbortNode(state, "Disk space is too low!", _("Disk space is too low!"));
             }
+            // The contract state roots of the chainstate must be on disk before it
+            FlushContractState();
             // Flush the chainstate (which may refer to block index entries).
             if (!CoinsTip().Flush())
                 return AbortNode(state, "Failed to write to coin database");
@@ -5684,14 +5588,21 @@ bool TestBlockValidity(BlockValidationState& state,
 
     dev::h256 oldHashStateRoot(globalState->rootHash()); // revo
     dev::h256 oldHashUTXORoot(globalState->rootHashUTXO()); // revo
+    // The trie nodes of the checked block are not kept
+    const dev::OverlayDB::PendingNodes statePending = globalState->db().pending(); // revo
+    const dev::OverlayDB::PendingNodes utxoPending = globalState->dbUtxo().pending(); // revo
 
     if (!chainstate.ConnectBlock(block, state, &indexDummy, viewNew, true)) {
         globalState->setRoot(oldHashStateRoot); // revo
         globalState->setRootUTXO(oldHashUTXORoot); // revo
+        globalState->db().rollback(statePending); // revo
+        globalState->dbUtxo().rollback(utxoPending); // revo
         pstorageresult->clearCacheResult();
         return false;
     }
     assert(state.IsValid());
+    globalState->db().rollback(statePending); // revo
+    globalState->dbUtxo().rollback(utxoPending); // revo
 
     return true;
 }
@@ -5964,10 +5875,6 @@ bool CChainState::LoadBlockIndexDB()
     pblocktree->ReadReindexing(fReindexing);
     if(fReindexing) fReindex = true;
 
-    ///////////////////////////////////////////////////////////// // revo
-    pblocktree->ReadFlag("addrindex", fAddressIndex);
-    LogPrintf("LoadBlockIndexDB(): address index %s\n", fAddressIndex ? "enabled" : "disabled");
-    /////////////////////////////////////////////////////////////
     // Check whether we have a transaction index
     pblocktree->ReadFlag("logevents", fLogEvents);
     LogPrintf("%s: log events index %s\n", __func__, fLogEvents ? "enabled" : "disabled");
@@ -6312,10 +6219,6 @@ bool ChainstateManager::LoadBlockIndex()
         // Use the provided setting for -logevents in the new database
         fLogEvents = gArgs.GetBoolArg("-logevents", DEFAULT_LOGEVENTS);
         pblocktree->WriteFlag("logevents", fLogEvents);
-        /////////////////////////////////////////////////////////////// // revo
-        fAddressIndex = gArgs.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX);
-        pblocktree->WriteFlag("addrindex", fAddressIndex);
-        ///////////////////////////////////////////////////////////////
     }
     return true;
 }
@@ -7321,35 +7224,118 @@ void ChainstateManager::MaybeRebalanceCaches()
 ////////////////////////////////////////////////////////////////////////////////// // revo
 bool GetAddressIndex(uint256 addressHash, int type, std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex, int start, int end)
 {
-    if (!fAddressIndex)
+    if (!g_address_index)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressIndex(addressHash, type, addressIndex, start, end))
+    if (!g_address_index->ReadAddressIndex(addressHash, type, addressIndex, start, end))
         return error("unable to get txids for address");
 
     return true;
 }
 
+/** Position of an address index entry among the entries of several addresses: its position in the index of its address, then its address */
+static std::vector<unsigned char> AddressIndexPosition(const CAddressIndexKey& key)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << key;
+    const size_t addressSize = CAddressIndexIteratorKey().GetSerializeSize(SER_DISK, CLIENT_VERSION);
+    std::vector<unsigned char> position(ss.begin() + addressSize, ss.end());
+    position.insert(position.end(), ss.begin(), ss.begin() + addressSize);
+    return position;
+}
+
+bool GetAddressIndex(const std::vector<std::pair<uint256, int> >& addresses, int start, int end, bool fReverse,
+                     const std::optional<CAddressIndexKey>& after,
+                     const std::function<bool(const CAddressIndexKey&, CAmount)>& fn)
+{
+    if (!g_address_index)
+        return error("address index not enabled");
+
+    // The entries of each address are read in order, the next one is the first of their heads
+    std::vector<std::pair<std::unique_ptr<CAddressIndexCursor>, std::vector<unsigned char> > > cursors;
+    const std::vector<unsigned char> afterPosition = after ? AddressIndexPosition(*after) : std::vector<unsigned char>();
+    for (std::vector<std::pair<uint256, int> >::const_iterator it = addresses.begin(); it != addresses.end(); it++) {
+        // Seek to the height of the entry to continue after, and skip the entries up to it at that height
+        int addressStart = start;
+        int addressEnd = end;
+        if (after && !fReverse) {
+            addressStart = std::max(start, after->blockHeight);
+        } else if (after) {
+            addressEnd = end > 0 ? std::min(end, after->blockHeight) : after->blockHeight;
+        }
+        std::unique_ptr<CAddressIndexCursor> pcursor = g_address_index->AddressIndexCursor((*it).first, (*it).second, addressStart, addressEnd, fReverse);
+        std::vector<unsigned char> position;
+        for (; pcursor->Valid(); pcursor->Next()) {
+            position = AddressIndexPosition(pcursor->GetKey());
+            if (!after || (fReverse ? position < afterPosition : afterPosition < position))
+                break;
+        }
+        if (pcursor->Valid())
+            cursors.emplace_back(std::move(pcursor), std::move(position));
+    }
+
+    while (!cursors.empty()) {
+        auto next = cursors.begin();
+        for (auto it = cursors.begin(); it != cursors.end(); it++) {
+            if (fReverse ? next->second < it->second : it->second < next->second)
+                next = it;
+        }
+        if (!fn(next->first->GetKey(), next->first->GetValue()))
+            break;
+        next->first->Next();
+        if (next->first->Valid()) {
+            next->second = AddressIndexPosition(next->first->GetKey());
+        } else {
+            cursors.erase(next);
+        }
+    }
+
+    return true;
+}
+
+bool GetAddressBalance(uint256 addressHash, int type, CAmount& balance, CAmount& received)
+{
+    if (!g_address_index)
+        return error("address index not enabled");
+
+    CAddressBalanceValue value;
+    if (!g_address_index->ReadAddressBalance(addressHash, type, value))
+        return error("unable to get balance for address");
+
+    balance = value.balance;
+    received = value.received;
+    return true;
+}
+
 bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value, const CTxMemPool& mempool)
 {
-    if (!fAddressIndex)
+    if (!g_address_index)
         return false;
 
     if (mempool.getSpentIndex(key, value))
         return true;
 
-    if (!pblocktree->ReadSpentIndex(key, value))
+    if (!g_address_index->ReadSpentIndex(key, value))
         return false;
 
     return true;
 }
 
+bool IsAddressIndexSynced(int nHeight)
+{
+    if (!g_address_index)
+        return false;
+
+    const IndexSummary summary = g_address_index->GetSummary();
+    return summary.synced && summary.best_block_height >= nHeight;
+}
+
 bool GetAddressUnspent(uint256 addressHash, int type, std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs)
 {
-    if (!fAddressIndex)
+    if (!g_address_index)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressUnspentIndex(addressHash, type, unspentOutputs))
+    if (!g_address_index->ReadAddressUnspentIndex(addressHash, type, unspentOutputs))
         return error("unable to get txids for address");
 
     return true;
@@ -7357,10 +7343,10 @@ bool GetAddressUnspent(uint256 addressHash, int type, std::vector<std::pair<CAdd
 
 bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes, ChainstateManager& chainman)
 {
-    if (!fAddressIndex)
+    if (!g_address_index)
         return error("Timestamp index not enabled");
 
-    if (!pblocktree->ReadTimestampIndex(high, low, fActiveOnly, hashes, chainman))
+    if (!g_address_index->ReadTimestampIndex(high, low, fActiveOnly, hashes, chainman))
         return error("Unable to get hashes for timestamps");
 
     return true;
@@ -7397,7 +7383,7 @@ bool GetAddressWeight(uint256 addressHash, int type, const std::map<COutPoint, u
 {
     nWeight = 0;
 
-    if (!fAddressIndex)
+    if (!g_address_index)
         return error("address index not enabled");
 
     // Get address utxos
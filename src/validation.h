@@ -30,6 +30,7 @@
 #include <util/translation.h>
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -53,6 +54,7 @@ class CWallet;
 #include <libethashseal/GenesisInfo.h>
 #include <script/standard.h>
 #include <revo/storageresults.h>
+#include <revo/statejournal.h>
 
 
 extern std::unique_ptr<RevoState> globalState;
@@ -117,6 +119,14 @@ static const bool DEFAULT_TXINDEX = false;
 static constexpr bool DEFAULT_COINSTATSINDEX{false};
 static const bool DEFAULT_ADDRINDEX = false;
 static const bool DEFAULT_LOGEVENTS = false;
+static const bool DEFAULT_DELEGATIONINDEX = false;
+static const bool DEFAULT_STATEJOURNAL = false;
+static const int64_t DEFAULT_PRUNESTATE = 0;
+static const bool DEFAULT_STATESNAPSHOT = false;
+/** Default for -statebatch, the MiB of contract state kept in memory across blocks during IBD */
+static const int64_t DEFAULT_STATE_BATCH = 0;
+/** Default for -statecache, the MiB of contract state trie nodes and database blocks cached in memory */
+static const int64_t DEFAULT_STATE_CACHE = 64;
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
@@ -173,6 +183,8 @@ extern uint256 g_best_block;
 extern bool g_parallel_script_checks;
 extern bool fAddressIndex;
 extern bool fLogEvents;
+/** Bytes of contract state trie nodes that may be kept in memory across blocks during IBD */
+extern size_t nStateBatchSize;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
 extern bool fCheckpointsEnabled;
@@ -410,8 +422,23 @@ bool GetAddressIndex(uint256 addressHash, int type,
                      std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                      int start = 0, int end = 0);
 
+/**
+ * Visit the address index entries of addresses between the heights start and end, merged in the order
+ * of the index, or its reverse if fReverse, after the entry after if any, until fn returns false.
+ * Zero heights are unbounded.
+ */
+bool GetAddressIndex(const std::vector<std::pair<uint256, int> >& addresses, int start, int end, bool fReverse,
+                     const std::optional<CAddressIndexKey>& after,
+                     const std::function<bool(const CAddressIndexKey&, CAmount)>& fn);
+
+/** Balance and total received of an address, the sums of its address index entries */
+bool GetAddressBalance(uint256 addressHash, int type, CAmount& balance, CAmount& received);
+
 bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value, const CTxMemPool& mempool);
 
+/** Whether the address index is enabled and has indexed the active chain up to nHeight */
+bool IsAddressIndexSynced(int nHeight);
+
 bool GetAddressUnspent(uint256 addressHash, int type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs);
 
@@ -463,6 +490,11 @@ public:
 
 extern std::unique_ptr<StorageResults> pstorageresult;
 
+extern std::unique_ptr<StateJournal> pstatejournal;
+
+/** Write the contract state trie nodes kept in memory to the state databases */
+void FlushContractState();
+
 bool CheckReward(const CBlock& block, BlockValidationState& state, int nHeight, const Consensus::Params& consensusParams, CAmount nFees, CAmount gasRefunds, CAmount nActualStakeReward, const std::vector<CTxOut>& vouts, CAmount nValueCoinPrev, bool delegateOutputExist, CChain& chain);
 
 //////////////////////////////////////////////////////// revo
@@ -564,12 +596,16 @@ public:
 
     std::vector<ResultExecute>& getResult(){ return result; }
 
+    /** Whether an execution read the time, difficulty, coinbase or gas limit of the block */
+    bool readBlockContext() const { return contextRead; }
+
+    /** The author of a block paying to scriptIn, null unless it pays to a public key or key hash */
+    static dev::Address EthAddrFromScript(const CScript& scriptIn);
+
 private:
 
     dev::eth::EnvInfo BuildEVMEnvironment();
 
-    dev::Address EthAddrFromScript(const CScript& scriptIn);
-
     std::vector<RevoTransaction> txs;
 
     std::vector<ResultExecute> result;
@@ -583,6 +619,8 @@ private:
     LastHashes lastHashes;
 
     CChain& chain;
+
+    bool contextRead = false;
 };
 
 enum DisconnectResult
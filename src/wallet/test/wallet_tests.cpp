@@ -609,6 +609,30 @@ BOOST_FIXTURE_TEST_CASE(wallet_disableprivkeys, TestChain100Setup)
     BOOST_CHECK(!wallet->GetNewDestination(OutputType::BECH32, "", dest, error));
 }
 
+BOOST_FIXTURE_TEST_CASE(getstakinginfo_kernelspersecond, TestChain100Setup)
+{
+    std::shared_ptr<CWallet> wallet = std::make_shared<CWallet>(m_node.chain.get(), "", CreateDummyWalletDatabase());
+    wallet->SetupLegacyScriptPubKeyMan();
+    WITH_LOCK(wallet->cs_wallet, wallet->SetLastBlockProcessed(m_node.chainman->ActiveChain().Height(), m_node.chainman->ActiveChain().Tip()->GetBlockHash()));
+    AddWallet(wallet);
+    wallet->m_stake_kernels_per_second = 12345;
+
+    if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+    JSONRPCRequest request;
+    request.context = &m_node;
+    request.strMethod = "getstakinginfo";
+    request.params.setArray();
+
+    // The kernel search speed of the last slot is only reported while staking
+    UniValue result = tableRPC.execute(request);
+    BOOST_CHECK_EQUAL(find_value(result, "kernelspersecond").get_int64(), 0);
+    wallet->m_enabled_staking = true;
+    result = tableRPC.execute(request);
+    BOOST_CHECK_EQUAL(find_value(result, "kernelspersecond").get_int64(), 12345);
+
+    RemoveWallet(wallet, std::nullopt);
+}
+
 // Explicit calculation which is used to test the wallet constant
 // We get the same virtual size due to rounding(weight/4) for both use_max_sig values
 static size_t CalculateNestedKeyhashInputSize(bool use_max_sig)
@@ -5499,6 +5499,12 @@ bool CWallet::SelectDelegateCoinsForStaking(std::vector<COutPoint> &setDelegateC
         return error("Invalid blockchain height");
     }
 
+    // The delegate coins are read from the address index, which is synced in the background
+    if (!IsAddressIndexSynced(height)) {
+        LogPrint(BCLog::COINSTAKE, "%s: address index is still syncing, delegate coins are not selected\n", __func__);
+        return false;
+    }
+
     std::map<COutPoint, uint32_t> immatureStakes = chain().getImmatureStakes();
     std::map<uint256, CSuperStakerInfo> mapStakers = mapSuperStaker;
 
@@ -23,6 +23,16 @@ bool CZMQAbstractNotifier::NotifyTransaction(const CTransaction &/*transaction*/
     return true;
 }
 
+bool CZMQAbstractNotifier::NotifyContractLogsConnect(const CBlock & /*block*/, const CBlockIndex * /*CBlockIndex*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyContractLogsDisconnect(const CBlock & /*block*/, const CBlockIndex * /*CBlockIndex*/)
+{
+    return true;
+}
+
 bool CZMQAbstractNotifier::NotifyBlockConnect(const CBlockIndex * /*CBlockIndex*/)
 {
     return true;
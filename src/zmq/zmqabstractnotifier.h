@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 
+class CBlock;
 class CBlockIndex;
 class CTransaction;
 class CZMQAbstractNotifier;
@@ -55,6 +56,10 @@ public:
     virtual bool NotifyTransactionRemoval(const CTransaction &transaction, uint64_t mempool_sequence);
     // Notifies of transactions added to mempool or appearing in blocks
     virtual bool NotifyTransaction(const CTransaction &transaction);
+    // Notifies of the contract logs of every block connection
+    virtual bool NotifyContractLogsConnect(const CBlock &block, const CBlockIndex *pindex);
+    // Notifies of the contract logs of every block disconnection
+    virtual bool NotifyContractLogsDisconnect(const CBlock &block, const CBlockIndex *pindex);
 
 protected:
     void *psocket;
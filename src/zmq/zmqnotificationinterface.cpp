@@ -37,6 +37,7 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
     factories["pubsequence"] = CZMQAbstractNotifier::Create<CZMQPublishSequenceNotifier>;
+    factories["pubcontractlog"] = CZMQAbstractNotifier::Create<CZMQPublishContractLogNotifier>;
 
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
     for (const auto& entry : factories)
@@ -171,6 +172,10 @@ void CZMQNotificationInterface::BlockConnected(const std::shared_ptr<const CBloc
     TryForEachAndRemoveFailed(notifiers, [pindexConnected](CZMQAbstractNotifier* notifier) {
         return notifier->NotifyBlockConnect(pindexConnected);
     });
+
+    TryForEachAndRemoveFailed(notifiers, [&pblock, pindexConnected](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyContractLogsConnect(*pblock, pindexConnected);
+    });
 }
 
 void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
@@ -186,6 +191,10 @@ void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CB
     TryForEachAndRemoveFailed(notifiers, [pindexDisconnected](CZMQAbstractNotifier* notifier) {
         return notifier->NotifyBlockDisconnect(pindexDisconnected);
     });
+
+    TryForEachAndRemoveFailed(notifiers, [&pblock, pindexDisconnected](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyContractLogsDisconnect(*pblock, pindexDisconnected);
+    });
 }
 
 CZMQNotificationInterface* g_zmq_notification_interface = nullptr;
@@ -9,6 +9,7 @@
 #include <node/blockstorage.h>
 #include <rpc/server.h>
 #include <streams.h>
+#include <util/convert.h>
 #include <util/system.h>
 #include <validation.h> // For cs_main
 #include <zmq/zmqutil.h>
@@ -29,6 +30,7 @@ static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
+static const char *MSG_CONTRACTLOG = "contractlog";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -229,6 +231,92 @@ bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &tr
     return SendZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
 }
 
+// Serialize a 'contractlog' topic message with the following structure:
+//    <32-byte block hash> | <4-byte LE height> | <32-byte tx hash> | <4-byte LE tx index> |
+//    <4-byte LE output index> | <4-byte LE log index in block> | <1-byte removed flag> |
+//    <20-byte contract address> | <compact size topic count> | <32-byte topics> | <compact size data length> | <data>
+// Hashes are in the same byte order as the other topics, topics and address as in the log.
+static std::vector<unsigned char> SerializeContractLog(const TransactionReceiptInfo& receipt, uint32_t logIndex, const dev::eth::LogEntry& log)
+{
+    std::vector<unsigned char> data;
+    CVectorWriter ss(SER_NETWORK, PROTOCOL_VERSION, data, 0);
+    uint256 blockHash = receipt.blockHash;
+    uint256 txHash = receipt.transactionHash;
+    std::reverse(blockHash.begin(), blockHash.end());
+    std::reverse(txHash.begin(), txHash.end());
+    ss << blockHash << receipt.blockNumber << txHash << receipt.transactionIndex << receipt.outputIndex << logIndex << false;
+    ss.write((const char*)log.address.data(), log.address.size);
+    WriteCompactSize(ss, log.topics.size());
+    for (const dev::h256& topic : log.topics) {
+        ss.write((const char*)topic.data(), topic.size);
+    }
+    ss << log.data;
+    return data;
+}
+
+// Offset of the removed flag in a 'contractlog' message
+static const size_t CONTRACTLOG_REMOVED_OFFSET = 32 + 4 + 32 + 4 + 4 + 4;
+
+bool CZMQPublishContractLogNotifier::NotifyContractLogsConnect(const CBlock &block, const CBlockIndex *pindex)
+{
+    if (!fLogEvents) {
+        return true;
+    }
+
+    const uint256 hash = pindex->GetBlockHash();
+    std::vector<std::vector<unsigned char>> messages;
+    uint32_t logIndex = 0;
+    for (const CTransactionRef& tx : block.vtx) {
+        if (!tx->HasCreateOrCall()) continue;
+        for (const TransactionReceiptInfo& receipt : pstorageresult->getResult(uintToh256(tx->GetHash()))) {
+            // The block may have been disconnected again before this notification
+            if (receipt.blockHash != hash) continue;
+            for (const dev::eth::LogEntry& log : receipt.logs) {
+                messages.push_back(SerializeContractLog(receipt, logIndex++, log));
+            }
+        }
+    }
+
+    LogPrint(BCLog::ZMQ, "zmq: Publish contractlog %s (%u logs) to %s\n", hash.GetHex(), messages.size(), this->address);
+    for (const std::vector<unsigned char>& message : messages) {
+        if (!SendZmqMessage(MSG_CONTRACTLOG, message.data(), message.size())) {
+            return false;
+        }
+    }
+
+    // Blocks deeper than the checkpoint span are not disconnected anymore
+    if (!messages.empty() && mapBlockLogs.emplace(hash, std::move(messages)).second) {
+        recentBlocks.push_back(hash);
+        while (recentBlocks.size() > (size_t)Params().GetConsensus().MaxCheckpointSpan()) {
+            mapBlockLogs.erase(recentBlocks.front());
+            recentBlocks.pop_front();
+        }
+    }
+    return true;
+}
+
+bool CZMQPublishContractLogNotifier::NotifyContractLogsDisconnect(const CBlock &block, const CBlockIndex *pindex)
+{
+    const uint256 hash = pindex->GetBlockHash();
+    auto it = mapBlockLogs.find(hash);
+    if (it == mapBlockLogs.end()) {
+        return true;
+    }
+
+    LogPrint(BCLog::ZMQ, "zmq: Publish removed contractlog %s (%u logs) to %s\n", hash.GetHex(), it->second.size(), this->address);
+    for (std::vector<unsigned char>& message : it->second) {
+        message[CONTRACTLOG_REMOVED_OFFSET] = 1;
+        if (!SendZmqMessage(MSG_CONTRACTLOG, message.data(), message.size())) {
+            return false;
+        }
+    }
+
+    // The block may be connected again, and its logs published again from its new receipts
+    mapBlockLogs.erase(it);
+    recentBlocks.erase(std::find(recentBlocks.begin(), recentBlocks.end(), hash));
+    return true;
+}
+
 // Helper function to send a 'sequence' topic message with the following structure:
 //    <32-byte hash> | <1-byte label> | <8-byte LE sequence> (optional)
 static bool SendSequenceMsg(CZMQAbstractPublishNotifier& notifier, uint256 hash, char label, std::optional<uint64_t> sequence = {})
@@ -7,6 +7,12 @@
 
 #include <zmq/zmqabstractnotifier.h>
 
+#include <uint256.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
 class CBlockIndex;
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
@@ -52,6 +58,23 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+/**
+ * Publishes every log entry of the contracts executed by a connected block, and publishes
+ * them again with the removed flag set when the block is disconnected. Requires -logevents.
+ */
+class CZMQPublishContractLogNotifier : public CZMQAbstractPublishNotifier
+{
+private:
+    //! The receipts of a disconnected block are already deleted, so the published logs
+    //! of the recent blocks are kept to publish their removal
+    std::map<uint256, std::vector<std::vector<unsigned char>>> mapBlockLogs;
+    std::deque<uint256> recentBlocks;
+
+public:
+    bool NotifyContractLogsConnect(const CBlock &block, const CBlockIndex *pindex) override;
+    bool NotifyContractLogsDisconnect(const CBlock &block, const CBlockIndex *pindex) override;
+};
+
 class CZMQPublishSequenceNotifier : public CZMQAbstractPublishNotifier
 {
 public:
@@ -20,9 +20,11 @@ from test_framework.messages import (
     hash256,
     tx_from_hex,
     CBlockHeader,
+    deser_compact_size,
 )
 from test_framework.util import (
     assert_equal,
+    assert_raises,
     assert_raises_rpc_error,
 )
 from io import BytesIO
@@ -38,6 +40,19 @@ except ImportError:
 def hash256_reversed(byte_str):
     return hash256(byte_str)[::-1]
 
+def parse_contractlog(body):
+    f = BytesIO(body)
+    log = {}
+    log['blockhash'] = f.read(32).hex()
+    log['height'], = struct.unpack('<I', f.read(4))
+    log['txid'] = f.read(32).hex()
+    log['txindex'], log['outputindex'], log['logindex'], log['removed'] = struct.unpack('<IIIB', f.read(13))
+    log['address'] = f.read(20).hex()
+    log['topics'] = [f.read(32).hex() for _ in range(deser_compact_size(f))]
+    log['data'] = f.read(deser_compact_size(f)).hex()
+    assert_equal(f.read(), b'')
+    return log
+
 class ZMQSubscriber:
     def __init__(self, socket, topic):
         self.sequence = None  # no sequence number received yet
@@ -121,6 +136,7 @@ class ZMQTest (BitcoinTestFramework):
             self.test_mempool_sync()
             self.test_reorg()
             self.test_multiple_interfaces()
+            self.test_contractlog()
         finally:
             # Destroy the ZMQ context.
             self.log.debug("Destroying ZMQ context")
@@ -128,14 +144,14 @@ class ZMQTest (BitcoinTestFramework):
 
     # Restart node with the specified zmq notifications enabled, subscribe to
     # all of them and return the corresponding ZMQSubscriber objects.
-    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True):
+    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True, extra_args=[]):
         subscribers = []
         for topic, address in services:
             socket = self.ctx.socket(zmq.SUB)
             subscribers.append(ZMQSubscriber(socket, topic.encode()))
 
         self.restart_node(0, ["-zmqpub%s=%s" % (topic, address) for topic, address in services] +
-                             self.extra_args[0])
+                             self.extra_args[0] + extra_args)
 
         for i, sub in enumerate(subscribers):
             sub.socket.connect(services[i][1])
@@ -152,6 +168,9 @@ class ZMQTest (BitcoinTestFramework):
             test_block = ZMQTestSetupBlock(self.nodes[0])
             recv_failed = False
             for sub in subscribers:
+                # Contract logs are only published for blocks executing contracts
+                if sub.topic == b"contractlog":
+                    continue
                 try:
                     while not test_block.caused_notification(sub.receive().hex()):
                         self.log.debug("Ignoring sync-up notification for previously generated block.")
@@ -574,5 +593,54 @@ class ZMQTest (BitcoinTestFramework):
         assert_equal(self.nodes[0].getbestblockhash(), subscribers[0].receive().hex())
         assert_equal(self.nodes[0].getbestblockhash(), subscribers[1].receive().hex())
 
+    def test_contractlog(self):
+        if not self.is_wallet_compiled():
+            self.log.info("Skipping contractlog test because wallet is disabled")
+            return
+
+        # -zmqpubcontractlog enables -logevents, which requires a reindex
+        address = 'tcp://127.0.0.1:28336'
+        hashblock, contractlog = self.setup_zmq_test(
+            [(topic, address) for topic in ["hashblock", "contractlog"]],
+            recv_timeout=2, sync_blocks=False, extra_args=["-reindex"])
+        node = self.nodes[0]
+
+        # Creating the contract logs nothing
+        contract_address = node.createcontract("6060604052600d600055341561001457600080fd5b61017e806100236000396000f30060606040526004361061004c576000357c0100000000000000000000000000000000000000000000000000000000900463ffffffff168063027c1aaf1461004e5780635b9af12b14610058575b005b61005661008f565b005b341561006357600080fd5b61007960048080359060200190919050506100a1565b6040518082815260200191505060405180910390f35b60026000808282540292505081905550565b60007fc5c442325655248f6bccf5c6181738f8755524172cea2a8bd1e38e43f833e7f282600054016000548460405180848152602001838152602001828152602001935050505060405180910390a17fc5c442325655248f6bccf5c6181738f8755524172cea2a8bd1e38e43f833e7f282600054016000548460405180848152602001838152602001828152602001935050505060405180910390a1816000540160008190555060005490509190505600a165627a7a7230582015732bfa66bdede47ecc05446bf4c1e8ed047efac25478cb13b795887df70f290029")['address']
+        node.generate(1)
+        assert_equal(node.getbestblockhash(), hashblock.receive().hex())
+
+        self.log.info("Should receive the logs of a contract call")
+        txid = node.sendtocontract(contract_address, "5b9af12b")['txid']
+        blockhash = node.generate(1)[0]
+        assert_equal(blockhash, hashblock.receive().hex())
+        receipt = node.gettransactionreceipt(txid)[0]
+        assert_equal(len(receipt['log']), 2)
+        logs = [parse_contractlog(contractlog.receive()) for _ in receipt['log']]
+        for i, log in enumerate(logs):
+            assert_equal(log['blockhash'], blockhash)
+            assert_equal(log['height'], node.getblockcount())
+            assert_equal(log['txid'], txid)
+            assert_equal(log['txindex'], receipt['transactionIndex'])
+            assert_equal(log['outputindex'], receipt['outputIndex'])
+            assert_equal(log['logindex'], i)
+            assert_equal(log['removed'], 0)
+            assert_equal(log['address'], contract_address)
+            assert_equal(log['topics'], receipt['log'][i]['topics'])
+            assert_equal(log['data'], receipt['log'][i]['data'])
+
+        self.log.info("Should receive the logs again as removed when the block is disconnected")
+        node.invalidateblock(blockhash)
+        for log in logs:
+            removed = parse_contractlog(contractlog.receive())
+            assert_equal(removed, dict(log, removed=1))
+
+        self.log.info("Should receive the logs when the block is connected again")
+        node.reconsiderblock(blockhash)
+        for log in logs:
+            assert_equal(parse_contractlog(contractlog.receive()), log)
+
+        assert_raises(zmq.error.Again, contractlog.receive)
+
 if __name__ == '__main__':
     ZMQTest().main()
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Revo Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test running several read-only contract calls at once with callcontractbatch."""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal, assert_raises_rpc_error
+from test_framework.revoconfig import COINBASE_MATURITY, REVO_MIN_GAS_PRICE_STR
+
+ADD = "4f2be91f"
+
+class CallContractBatchTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generate(COINBASE_MATURITY + 100)
+        """
+        contract test {
+            uint a;
+            function test() payable { a = 13; }
+            function add() payable returns (uint){ a += 13; return a; }
+            function () payable {}
+        }
+        """
+        contract_address = node.createcontract("60606040525b600d6000819055505b5b60a98061001d6000396000f30060606040523615603d576000357c0100000000000000000000000000000000000000000000000000000000900463ffffffff1680634f2be91f146045575b60435b5b565b005b604b6061565b6040518082815260200191505060405180910390f35b6000600d60006000828254019250508190555060005490505b905600a165627a7a72305820fd0deb11ff6c6a06f612b5fb04e7312f22eacec75d677c0fbc0194d86772d2d70029", 1000000, REVO_MIN_GAS_PRICE_STR)['address']
+        node.generate(1)
+
+        self.log.info("Calls run on the tip and return the results of callcontract in order")
+        ret = node.callcontractbatch([
+            {"address": contract_address, "data": ADD},
+            {"address": contract_address, "data": "00"},
+            {"address": contract_address, "data": ADD, "gaslimit": 100000, "amount": 0},
+        ])
+        assert_equal(ret['blockhash'], node.getbestblockhash())
+        assert_equal(ret['height'], node.getblockcount())
+        assert_equal(len(ret['results']), 3)
+        assert_equal(ret['results'][0], node.callcontract(contract_address, ADD))
+        assert_equal(ret['results'][1], node.callcontract(contract_address, "00"))
+        assert_equal(ret['results'][2], node.callcontract(address=contract_address, data=ADD, gaslimit=100000))
+
+        # The calls do not see the changes of each other
+        for result in [ret['results'][0], ret['results'][2]]:
+            assert_equal(result['address'], contract_address)
+            assert_equal(result['executionResult']['excepted'], "None")
+            assert_equal(result['executionResult']['output'], "000000000000000000000000000000000000000000000000000000000000001a")
+
+        assert_equal(node.callcontractbatch([])['results'], [])
+
+        self.log.info("A batch holds at most 1000 calls")
+        calls = [{"address": contract_address, "data": ADD}] * 1000
+        results = node.callcontractbatch(calls)['results']
+        assert_equal(len(results), 1000)
+        assert_equal(results[999], results[0])
+        assert_raises_rpc_error(-8, "Too many calls, the maximum is 1000", node.callcontractbatch, calls + [calls[0]])
+
+        self.log.info("Errors name the call they belong to")
+        valid = {"address": contract_address, "data": ADD}
+        assert_raises_rpc_error(-8, "Call 1: Missing data", node.callcontractbatch, [valid, {"address": contract_address}])
+        assert_raises_rpc_error(-3, "Call 1: Invalid data (data not hex)", node.callcontractbatch, [valid, {"address": contract_address, "data": "zz"}])
+        assert_raises_rpc_error(-5, "Call 0: Incorrect address", node.callcontractbatch, [{"address": "1234", "data": ADD}, valid])
+        assert_raises_rpc_error(-5, "Call 2: Address does not exist", node.callcontractbatch, [valid, valid, {"address": "00" * 20, "data": ADD}])
+        assert_raises_rpc_error(-3, "Call 0: Amount out of range", node.callcontractbatch, [{"address": contract_address, "data": ADD, "amount": -1}])
+
+if __name__ == '__main__':
+    CallContractBatchTest().main()
@@ -79,6 +79,23 @@ class RevoBitcoreTest(BitcoinTestFramework):
         ret = node.getaddressdeltas({'addresses': [confirmed_address]})
         assert_equal(len(ret), 10)
 
+        # check the pages of txids and deltas, oldest and newest first
+        all_txids = node.getaddresstxids({'addresses': [confirmed_address]})
+        all_deltas = node.getaddressdeltas({'addresses': [confirmed_address]})
+        for reverse in [False, True]:
+            for method, key, expected in [('getaddresstxids', 'txids', all_txids), ('getaddressdeltas', 'deltas', all_deltas)]:
+                pages = []
+                args = {'addresses': [confirmed_address], 'limit': 4, 'reverse': reverse}
+                while True:
+                    ret = getattr(node, method)(args)
+                    pages.append(ret[key])
+                    if 'cursor' not in ret:
+                        break
+                    args['cursor'] = ret['cursor']
+                assert_equal([len(page) for page in pages], [4, 4, 2])
+                assert_equal(sum(pages, []), expected[::-1] if reverse else expected)
+        assert_raises_rpc_error(-8, "Invalid cursor", node.getaddresstxids, {'addresses': [confirmed_address], 'limit': 4, 'cursor': '00'})
+
         ret = node.getaddressbalance({'addresses': [confirmed_address]})
         assert_equal(ret['balance'], 10000000000)
 
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Revo Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test paging through the event logs with searchlogspage."""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal, assert_raises_rpc_error
+from test_framework.revoconfig import COINBASE_MATURITY
+
+class RevoSearchlogsPageTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        self.extra_args = [["-logevents"]]
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def read_pages(self, low, high, addresses, limit):
+        node = self.nodes[0]
+        entries = []
+        cursor = None
+        while True:
+            if cursor is None:
+                page = node.searchlogspage(low, high, addresses, {}, 0, limit)
+            else:
+                page = node.searchlogspage(low, high, addresses, {}, 0, limit, cursor)
+            assert_equal(page['count'], len(page['entries']))
+            assert page['count'] <= limit
+            entries += page['entries']
+            if 'cursor' not in page:
+                return entries
+            assert_equal(page['count'], limit)
+            cursor = page['cursor']
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generate(100 + COINBASE_MATURITY)
+        contract_address = node.createcontract("6060604052600d600055341561001457600080fd5b61017e806100236000396000f30060606040526004361061004c576000357c0100000000000000000000000000000000000000000000000000000000900463ffffffff168063027c1aaf1461004e5780635b9af12b14610058575b005b61005661008f565b005b341561006357600080fd5b61007960048080359060200190919050506100a1565b6040518082815260200191505060405180910390f35b60026000808282540292505081905550565b60007fc5c442325655248f6bccf5c6181738f8755524172cea2a8bd1e38e43f833e7f282600054016000548460405180848152602001838152602001828152602001935050505060405180910390a17fc5c442325655248f6bccf5c6181738f8755524172cea2a8bd1e38e43f833e7f282600054016000548460405180848152602001838152602001828152602001935050505060405180910390a1816000540160008190555060005490509190505600a165627a7a7230582015732bfa66bdede47ecc05446bf4c1e8ed047efac25478cb13b795887df70f290029")['address']
+        node.generate(1)
+        addresses = {"addresses": [contract_address]}
+
+        # Three receipts in one block and two in the next
+        low = node.getblockcount() + 1
+        for count in [3, 2]:
+            for _ in range(count):
+                node.sendtocontract(contract_address, "5b9af12b")
+            node.generate(1)
+        high = node.getblockcount()
+
+        expected = sorted(node.searchlogs(low, high, addresses), key=lambda r: (r['blockNumber'], r['transactionIndex']))
+        assert_equal(len(expected), 5)
+        expected_hashes = [r['transactionHash'] for r in expected]
+
+        self.log.info("Pages of every size return all receipts once, in block order")
+        for limit in [1, 2, 3, 5, 10]:
+            entries = self.read_pages(low, high, addresses, limit)
+            assert_equal([r['transactionHash'] for r in entries], expected_hashes)
+            assert_equal(entries, expected)
+
+        self.log.info("A page holding all receipts has no cursor")
+        page = node.searchlogspage(low, high, addresses)
+        assert_equal(page['count'], 5)
+        assert 'cursor' not in page
+
+        self.log.info("Receipts below minconf are not returned")
+        entries = [r['transactionHash'] for r in node.searchlogspage(low, high, addresses, {}, 1)['entries']]
+        assert_equal(entries, expected_hashes[:3])
+
+        self.log.info("Invalid limits and cursors are rejected")
+        assert_raises_rpc_error(-8, "limit must be between 1 and 10000", node.searchlogspage, low, high, addresses, {}, 0, 0)
+        assert_raises_rpc_error(-8, "limit must be between 1 and 10000", node.searchlogspage, low, high, addresses, {}, 0, 10001)
+        assert_raises_rpc_error(-8, "Invalid cursor", node.searchlogspage, low, high, addresses, {}, 0, 1, "zz")
+        cursor = node.searchlogspage(low, high, addresses, {}, 0, 4)['cursor']
+        assert_raises_rpc_error(-8, "Invalid cursor", node.searchlogspage, low, high, addresses, {}, 0, 1, cursor + "00")
+        assert_raises_rpc_error(-8, "Cursor out of the block range", node.searchlogspage, low, low, addresses, {}, 0, 1, cursor)
+
+if __name__ == '__main__':
+    RevoSearchlogsPageTest().main()
@@ -41,6 +41,10 @@ class RpcMiscTest(BitcoinTestFramework):
         assert_greater_than(memory['chunks_used'], 0)
         assert_greater_than(memory['chunks_free'], 0)
         assert_equal(memory['used'] + memory['free'], memory['total'])
+        analysis_cache = node.getmemoryinfo()['evmanalysiscache']
+        assert_greater_than_or_equal(analysis_cache['max_usage'], analysis_cache['usage'])
+        for key in ['entries', 'hits', 'misses', 'evictions']:
+            assert_greater_than_or_equal(analysis_cache[key], 0)
 
         self.log.info("test mallocinfo")
         try:
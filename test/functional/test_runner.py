@@ -318,6 +318,7 @@ BASE_SCRIPTS = [
     'revo_8mb_block.py',
     'revo_gas_limit.py',
     'revo_searchlog.py',
+    'revo_searchlogspage.py',
     'revo_pos_segwit.py',
     'revo_state_root.py',
     'revo_evm_globals.py',
@@ -325,6 +326,7 @@ BASE_SCRIPTS = [
     'revo_waitforlogs.py',
     'revo_block_header.py',
     'revo_callcontract.py',
+    'revo_callcontractbatch.py',
     'revo_spend_op_call.py',
     'revo_condensing_txs.py',
     'revo_createcontract.py',